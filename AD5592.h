@@ -6,7 +6,7 @@
  * 		-none
  * Author: Tom Olenik
  * Original Date: 15 November 2016
- * Last Revised Date: 25 November 2016
+ * Last Revised Date: 16 October 2026
  * Release Notes:
  * 	* Version 1.0.0: 15 November 2016
  * 		- Initial release includes definitions to help make application
@@ -19,6 +19,8 @@
  *  	inputs.
  *  * Version 1.0.2: 25 November 2016
  *    - Line 58: Fixed AD5592_SW_RESET and formatting update.
+ *  * Version 1.0.3: 16 October 2026
+ *    - Added ADC sequence register and ADC result masks.
  **********************************************************************/
 
 #ifndef SOURCES_AD5592_H_
@@ -76,6 +78,14 @@
 #define AD5592_DAC_ADDRESS_MASK		0x7000	/* DAC pin address bit mask */
 #define AD5592_DAC_VALUE_MASK		0x0FFF	/* DAC output value bit mask */
 
+/**
+ * ADC sequence register and result definitions.
+ */
+#define AD5592_ADC_SEQ_REP			0x0200	/* Repeat the ADC sequence */
+#define AD5592_ADC_SEQ_TEMP			0x0100	/* Include the temperature sensor in the sequence */
+#define AD5592_ADC_ADDRESS_MASK		0x7000	/* ADC result pin address bit mask */
+#define AD5592_ADC_VALUE_MASK		0x0FFF	/* ADC result value bit mask */
+
 #define AD5592_PIN_SELECT_MASK		0x00FF	/* Pin select bit mask */
 
 typedef unsigned short int	AD5592_WORD;
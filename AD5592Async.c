@@ -0,0 +1,366 @@
+/***********************************************************************
+ * File: AD5592Async.c
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Asynchronous submission and completion queues for a board
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Pipe.h v1.1.0
+ * 		-AD5592Async.h
+ * 		-pthread
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- Operations get result from the transfer of their batch. A
+ * 			failed batch stores no values.
+ * 		- A fence follows a merged ADC read when another operation comes
+ * 			after it, so the read cannot see a later write.
+ **********************************************************************/
+
+#include "AD5592Async.h"
+
+/**
+ * Add an operation to a queue. Safe from any thread.
+ */
+static void asyncPush(AD5592_AsyncQueue *queue, AD5592_AsyncOp *op)
+{
+	AD5592_AsyncOp *prev;
+
+	atomic_store_explicit(&op->next, NULL, memory_order_relaxed);
+	prev = atomic_exchange_explicit(&queue->head, op, memory_order_acq_rel);
+	atomic_store_explicit(&prev->next, op, memory_order_release);
+}
+
+/**
+ * Take the oldest operation off a queue. Returns NULL if the queue is
+ * empty or the newest push is half done, in which case the pusher
+ * wakes the consumer once it is finished.
+ */
+static AD5592_AsyncOp *asyncPop(AD5592_AsyncQueue *queue)
+{
+	AD5592_AsyncOp *tail = queue->tail;
+	AD5592_AsyncOp *next = atomic_load_explicit(&tail->next, memory_order_acquire);
+
+	if(tail == &queue->stub)
+	{
+		if(next == NULL)
+		{
+			return NULL;
+		}
+		queue->tail = next;
+		tail = next;
+		next = atomic_load_explicit(&tail->next, memory_order_acquire);
+	}
+	if(next)
+	{
+		queue->tail = next;
+		return tail;
+	}
+	if(tail != atomic_load_explicit(&queue->head, memory_order_acquire))
+	{
+		return NULL;
+	}
+	/* Last operation. Put the stub behind it so it can be taken. */
+	asyncPush(queue, &queue->stub);
+	next = atomic_load_explicit(&tail->next, memory_order_acquire);
+	if(next)
+	{
+		queue->tail = next;
+		return tail;
+	}
+	return NULL;
+}
+
+/**
+ * Set up an empty queue.
+ * Parameters:
+ * 	queue = queue to set up
+ */
+void asyncQueueInit(AD5592_AsyncQueue *queue)
+{
+	atomic_init(&queue->stub.next, NULL);
+	atomic_init(&queue->head, &queue->stub);
+	queue->tail = &queue->stub;
+}
+
+/**
+ * Take the oldest operation off a completion queue. Only one thread may
+ * poll a queue.
+ * Parameters:
+ * 	queue = completion queue
+ * Returns:
+ * 	Operation, or NULL if none is complete
+ */
+AD5592_AsyncOp *asyncPoll(AD5592_AsyncQueue *queue)
+{
+	return asyncPop(queue);
+}
+
+/**
+ * Queue one operation other than an ADC read in the pipe.
+ */
+static void asyncQueueOp(AD5592_Async *async, AD5592_AsyncOp *op)
+{
+	AD5592_Pipe *pipe = &async->pipe;
+	uint8_t outPins;
+	uint8_t data;
+
+	switch(op->op)
+	{
+		case AD5592_ASYNC_DAC_WRITE:
+			pipeSetAnalogOut(pipe, op->pins, op->milivolts[op->pins]);
+			break;
+		case AD5592_ASYNC_GPIO_READ:
+			pipeGetDigitalIn(pipe, op->pins | deviceRegister(async->dev, AD5592_GPIO_READ_CONFIG),
+				&op->states);
+			break;
+		case AD5592_ASYNC_GPIO_WRITE:
+			/* Outputs that are not in the operation keep their states */
+			outPins = deviceRegister(async->dev, AD5592_GPIO_WRITE_CONFIG);
+			data = deviceRegister(async->dev, AD5592_GPIO_WRITE_DATA);
+			pipeSetDigitalOut(pipe, outPins | op->pins,
+				(data & ~op->pins) | (op->states & op->pins));
+			break;
+	}
+}
+
+/**
+ * Hand a finished operation back to its submitter.
+ */
+static void asyncComplete(AD5592_AsyncOp *op)
+{
+	AD5592_AsyncQueue *completion = op->completion;
+
+	if(op->callback)
+	{
+		op->callback(op, op->arg);
+	}
+	atomic_store_explicit(&op->done, 1, memory_order_release);
+	if(completion)
+	{
+		asyncPush(completion, op);
+	}
+}
+
+/**
+ * Run one batch of waiting operations.
+ * Returns:
+ * 	Number of operations run
+ */
+static int asyncBatch(AD5592_Async *async)
+{
+	AD5592_AsyncOp *op[AD5592_ASYNC_BATCH];
+	uint16_t scan[AD5592_ASYNC_BATCH][8];	/* Results of each merged ADC read */
+	int8_t group[AD5592_ASYNC_BATCH];		/* Merged ADC read of each ADC operation */
+	uint32_t errors = async->dev->transferErrors;
+	uint8_t groupPins = 0x00;
+	int groups = 0;
+	int count = 0;
+	int result;
+	int pin;
+	int i;
+
+	while(count < AD5592_ASYNC_BATCH && (op[count] = asyncPop(&async->submit)) != NULL)
+	{
+		if(op[count]->op == AD5592_ASYNC_ADC_READ)
+		{
+			if(groupPins == 0x00)
+			{
+				groups++;
+			}
+			groupPins |= op[count]->pins;
+			group[count] = groups - 1;
+		}else
+		{
+			/* Anything else ends the merged read before it, and waits
+			 * for its conversions so they cannot see a later write */
+			if(groupPins)
+			{
+				pipeGetAnalogIn(&async->pipe, groupPins, scan[groups - 1]);
+				pipeFence(&async->pipe);
+				groupPins = 0x00;
+			}
+			asyncQueueOp(async, op[count]);
+		}
+		count++;
+	}
+	if(count == 0)
+	{
+		return 0;
+	}
+	if(groupPins)
+	{
+		pipeGetAnalogIn(&async->pipe, groupPins, scan[groups - 1]);
+	}
+	/* A full pipe flushes itself, so look for any failed transfer of
+	 * the batch, not just the last one */
+	result = pipeFlush(&async->pipe) && async->dev->transferErrors == errors;
+	async->batches++;
+	async->ops += count;
+	async->failed += !result;
+
+	for(i = 0; i < count; i++)
+	{
+		/* After a failure nothing was received, so values read keep
+		 * what they held */
+		op[i]->result = result;
+		if(result && op[i]->op == AD5592_ASYNC_ADC_READ)
+		{
+			for(pin = 0; pin < 8; pin++)
+			{
+				if((op[i]->pins >> pin) & 0x1)
+				{
+					op[i]->milivolts[pin] = scan[group[i]][pin];
+				}
+			}
+		}else if(result && op[i]->op == AD5592_ASYNC_GPIO_READ)
+		{
+			op[i]->states &= op[i]->pins;
+		}
+		asyncComplete(op[i]);
+	}
+
+	pthread_mutex_lock(&async->doneLock);
+	pthread_cond_broadcast(&async->doneCond);
+	pthread_mutex_unlock(&async->doneLock);
+	return count;
+}
+
+/**
+ * Bus owner thread.
+ */
+static void *asyncThread(void *arg)
+{
+	AD5592_Async *async = arg;
+	int running;
+
+	do
+	{
+		sem_wait(&async->wake);
+		running = atomic_load_explicit(&async->running, memory_order_acquire);
+		while(asyncBatch(async))
+		{
+		}
+	}while(running);
+	return NULL;
+}
+
+/**
+ * Start the bus owner thread for a board. Nothing else may use the
+ * board until asyncStop().
+ * Parameters:
+ * 	async = bus owner to start
+ * 	dev = board
+ * Returns:
+ * 	1 on success, 0 if the thread could not be started
+ */
+int asyncStart(AD5592_Async *async, AD5592_Device *dev)
+{
+	async->dev = dev;
+	async->batches = 0;
+	async->ops = 0;
+	async->failed = 0;
+	pipeInit(&async->pipe, dev);
+	asyncQueueInit(&async->submit);
+	sem_init(&async->wake, 0, 0);
+	atomic_init(&async->running, 1);
+	pthread_mutex_init(&async->doneLock, NULL);
+	pthread_cond_init(&async->doneCond, NULL);
+	return pthread_create(&async->thread, NULL, asyncThread, async) == 0;
+}
+
+/**
+ * Complete everything submitted so far and stop the bus owner thread.
+ * Parameters:
+ * 	async = bus owner
+ */
+void asyncStop(AD5592_Async *async)
+{
+	atomic_store_explicit(&async->running, 0, memory_order_release);
+	sem_post(&async->wake);
+	pthread_join(async->thread, NULL);
+	pthread_cond_destroy(&async->doneCond);
+	pthread_mutex_destroy(&async->doneLock);
+	sem_destroy(&async->wake);
+}
+
+/**
+ * Set up an operation. Callback, arg and completion are cleared and
+ * may be set before submitting.
+ * Parameters:
+ * 	op = operation
+ * 	kind = AD5592_ASYNC_
+ * 	pins = pins as bit mask, or the pin number for a DAC write
+ * 	value = milivolts for a DAC write, states for a GPIO write
+ */
+void asyncOpInit(AD5592_AsyncOp *op, uint8_t kind, uint8_t pins, uint16_t value)
+{
+	int pin;
+
+	atomic_init(&op->next, NULL);
+	op->op = kind;
+	op->pins = pins;
+	op->states = kind == AD5592_ASYNC_GPIO_WRITE ? value : 0x00;
+	for(pin = 0; pin < 8; pin++)
+	{
+		op->milivolts[pin] = 0;
+	}
+	if(kind == AD5592_ASYNC_DAC_WRITE)
+	{
+		op->pins = pins & 0x7;
+		op->milivolts[op->pins] = value;
+	}
+	op->callback = NULL;
+	op->arg = NULL;
+	op->completion = NULL;
+	op->result = 0;
+	atomic_init(&op->done, 0);
+}
+
+/**
+ * Submit an operation. Safe to call from any thread.
+ * Parameters:
+ * 	async = bus owner
+ * 	op = operation set up with asyncOpInit()
+ */
+void asyncSubmit(AD5592_Async *async, AD5592_AsyncOp *op)
+{
+	atomic_store_explicit(&op->done, 0, memory_order_relaxed);
+	asyncPush(&async->submit, op);
+	sem_post(&async->wake);
+}
+
+/**
+ * Wait for an operation to complete.
+ * Parameters:
+ * 	async = bus owner it was submitted to
+ * 	op = operation
+ */
+void asyncWait(AD5592_Async *async, AD5592_AsyncOp *op)
+{
+	if(atomic_load_explicit(&op->done, memory_order_acquire))
+	{
+		return;
+	}
+	pthread_mutex_lock(&async->doneLock);
+	while(!atomic_load_explicit(&op->done, memory_order_acquire))
+	{
+		pthread_cond_wait(&async->doneCond, &async->doneLock);
+	}
+	pthread_mutex_unlock(&async->doneLock);
+}
+
+/**
+ * Check an operation without waiting.
+ * Parameters:
+ * 	op = operation
+ * Returns:
+ * 	1 if it is complete
+ */
+int asyncDone(AD5592_AsyncOp *op)
+{
+	return atomic_load_explicit(&op->done, memory_order_acquire);
+}
@@ -0,0 +1,181 @@
+/*********************************************************************
+ * File: AD5592Async.h
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Asynchronous submission and completion queues for a board
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Pipe.h v1.1.0
+ * 		-pthread
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- Added AD5592_AsyncOp.result and AD5592_Async.failed.
+ * 		- Writes after an ADC read wait for its conversions.
+ *
+ * A bus owner thread is the only user of the board. Any thread can
+ * submit operations to it through a lock free multi producer queue.
+ * The bus owner takes everything that is waiting, up to
+ * AD5592_ASYNC_BATCH operations, queues it in an AD5592_Pipe so the
+ * reads overlap, and sends it with one transfer. Operations run in the
+ * order they were submitted: ADC reads that follow each other are
+ * merged into one sequence, and any other operation after them waits
+ * until their conversions are done, so a read never sees a later write.
+ *
+ * Operations are owned by the caller and must stay put until they are
+ * complete. When one completes the bus owner:
+ * 	- sets result to 1 if its batch reached the board, or to 0 if a
+ * 		transfer of the batch failed. Values read are only valid when
+ * 		result is 1,
+ * 	- sets done, which asyncWait() blocks on,
+ * 	- calls callback from the bus owner thread if it is set,
+ * 	- pushes the operation to the completion queue if one is set. An
+ * 		operation with a completion queue may only be reused once
+ * 		asyncPoll() has returned it.
+ *
+ * Submitting is one atomic exchange and a sem_post(). No lock is taken
+ * unless a thread waits in asyncWait().
+ **********************************************************************/
+
+#ifndef SOURCES_AD5592ASYNC_H_
+#define SOURCES_AD5592ASYNC_H_
+
+#include <stdatomic.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include "AD5592Pipe.h"
+
+#define AD5592_ASYNC_BATCH	32		/* Most operations in one transfer */
+
+/**
+ * Operations.
+ */
+#define AD5592_ASYNC_ADC_READ	0	/* Read ADC pins into milivolts[] */
+#define AD5592_ASYNC_DAC_WRITE	1	/* Write milivolts[pin] to one DAC pin */
+#define AD5592_ASYNC_GPIO_READ	2	/* Read GPIO input pins into states */
+#define AD5592_ASYNC_GPIO_WRITE	3	/* Write states to GPIO output pins, other outputs keep theirs */
+
+typedef struct AD5592_AsyncOp AD5592_AsyncOp;
+typedef struct AD5592_AsyncQueue AD5592_AsyncQueue;
+
+/**
+ * One operation.
+ */
+struct AD5592_AsyncOp
+{
+	_Atomic(AD5592_AsyncOp *) next;			/* Queue link */
+	uint8_t op;								/* AD5592_ASYNC_ */
+	uint8_t pins;							/* Pins as bit mask, or the pin number for a DAC write */
+	uint8_t states;							/* GPIO states to write or states read */
+	uint16_t milivolts[8];					/* DAC value to write or ADC values read, by pin */
+	void (*callback)(AD5592_AsyncOp *op, void *arg);	/* Called by the bus owner, may be NULL */
+	void *arg;								/* Passed to callback */
+	AD5592_AsyncQueue *completion;			/* Completion queue, may be NULL */
+	int result;								/* 1 if it reached the board, 0 if its transfer failed */
+	atomic_int done;						/* Set when complete */
+};
+
+/**
+ * Lock free queue of operations. Any number of threads may push, one
+ * thread may pop.
+ */
+struct AD5592_AsyncQueue
+{
+	_Atomic(AD5592_AsyncOp *) head;		/* Newest operation, pushed here */
+	AD5592_AsyncOp *tail;				/* Oldest operation, popped here */
+	AD5592_AsyncOp stub;				/* Marker that keeps the queue from going empty */
+};
+
+/**
+ * A bus owner.
+ */
+typedef struct
+{
+	AD5592_Device *dev;				/* Board owned by the thread */
+	AD5592_Pipe pipe;				/* Pipe the batches are built in */
+	AD5592_AsyncQueue submit;		/* Submission queue */
+	sem_t wake;						/* Posted on every submit */
+	atomic_int running;				/* Cleared to stop the thread */
+	pthread_mutex_t doneLock;		/* Held only by threads in asyncWait() */
+	pthread_cond_t doneCond;		/* Broadcast after each batch */
+	pthread_t thread;				/* Bus owner thread */
+	uint32_t batches;				/* Transfers made */
+	uint32_t ops;					/* Operations completed */
+	uint32_t failed;				/* Batches with a failed transfer */
+} AD5592_Async;
+
+/**
+ * Set up an empty queue.
+ * Parameters:
+ * 	queue = queue to set up
+ */
+void asyncQueueInit(AD5592_AsyncQueue *queue);
+
+/**
+ * Take the oldest operation off a completion queue. Only one thread may
+ * poll a queue.
+ * Parameters:
+ * 	queue = completion queue
+ * Returns:
+ * 	Operation, or NULL if none is complete
+ */
+AD5592_AsyncOp *asyncPoll(AD5592_AsyncQueue *queue);
+
+/**
+ * Start the bus owner thread for a board. Nothing else may use the
+ * board until asyncStop().
+ * Parameters:
+ * 	async = bus owner to start
+ * 	dev = board
+ * Returns:
+ * 	1 on success, 0 if the thread could not be started
+ */
+int asyncStart(AD5592_Async *async, AD5592_Device *dev);
+
+/**
+ * Complete everything submitted so far and stop the bus owner thread.
+ * Parameters:
+ * 	async = bus owner
+ */
+void asyncStop(AD5592_Async *async);
+
+/**
+ * Set up an operation. Callback, arg and completion are cleared and
+ * may be set before submitting.
+ * Parameters:
+ * 	op = operation
+ * 	kind = AD5592_ASYNC_
+ * 	pins = pins as bit mask, or the pin number for a DAC write
+ * 	value = milivolts for a DAC write, states for a GPIO write
+ */
+void asyncOpInit(AD5592_AsyncOp *op, uint8_t kind, uint8_t pins, uint16_t value);
+
+/**
+ * Submit an operation. Safe to call from any thread.
+ * Parameters:
+ * 	async = bus owner
+ * 	op = operation set up with asyncOpInit()
+ */
+void asyncSubmit(AD5592_Async *async, AD5592_AsyncOp *op);
+
+/**
+ * Wait for an operation to complete.
+ * Parameters:
+ * 	async = bus owner it was submitted to
+ * 	op = operation
+ */
+void asyncWait(AD5592_Async *async, AD5592_AsyncOp *op);
+
+/**
+ * Check an operation without waiting.
+ * Parameters:
+ * 	op = operation
+ * Returns:
+ * 	1 if it is complete
+ */
+int asyncDone(AD5592_AsyncOp *op);
+
+#endif /* SOURCES_AD5592ASYNC_H_ */
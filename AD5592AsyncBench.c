@@ -0,0 +1,273 @@
+/**
+ * File: AD5592AsyncBench.c
+ * Target: Raspberry Pi or any Linux host
+ * Function: Throughput, ordering and failure handling of an AD5592_Async
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Async.h v1.0.1
+ * 		-AD5592Sim.h v1.2.1
+ * 		-AD5592Clock.h v1.0.0
+ * 		-pthread
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version: 1.0.0:
+ * 		-Usage: AD5592AsyncBench [-t threads] [-n rounds] [-f us per frame]
+ * 			[-e fail every nth transfer]
+ *
+ * 		-Runs -t submitter threads (4 by default) against one simulated
+ * 		board behind a transport that sleeps -f us a frame (16 by
+ * 		default) like a real SPI bus at about 1 MHz. With -e every nth
+ * 		transfer fails without reaching the board.
+ *
+ * 		-Thread t owns pin t, a DAC output read back by the ADC, and
+ * 		pin 4 + t, an ADC input held at a fixed voltage. Each of its -n
+ * 		rounds (2000 by default) submits, without waiting in between:
+ * 			an ADC read of both pins,
+ * 			a DAC write of a new value to pin t,
+ * 			an ADC read of pin t.
+ * 		The first read must see the value of the round before and the
+ * 		second read the new one, so a batch that reorders or merges
+ * 		them across the write shows up. Values are only checked when
+ * 		their operations have result set, and after a failed write the
+ * 		next round does not expect the old value.
+ *
+ * 		-Prints:
+ * 			threads ops seconds ops_per_sec batches ops_per_batch
+ * 			failed_batches failed_ops injected bad
+ * 		failed_ops counts operations completed with result 0 and
+ * 		injected the transfers made to fail. bad counts reads with
+ * 		result 1 that did not see the expected voltage. Exits with 1 if
+ * 		any read is bad or, with no -e, if any operation failed.
+ *
+ * 		-Builds on a Linux host with:
+ * 			gcc -O2 -DAD5592_NO_BCM2835 -o AD5592AsyncBench \
+ * 				AD5592AsyncBench.c AD5592Async.c AD5592Pipe.c \
+ * 				AD5592RPI.c AD5592Batch.c AD5592Timing.c \
+ * 				AD5592Transport.c AD5592Sim.c -lpthread
+ * 		Add -fsanitize=thread to check the queues for data races.
+ *
+ **********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "AD5592RPI.h"
+#include "AD5592Async.h"
+#include "AD5592Sim.h"
+#include "AD5592Clock.h"
+
+#define BENCH_THREADS		4		/* Most submitter threads */
+#define BENCH_TOLERANCE		4		/* Largest DAC and ADC error in mV */
+
+/**
+ * Counts of one submitter thread.
+ */
+typedef struct
+{
+	pthread_t thread;
+	int number;				/* Thread number, also its DAC pin */
+	uint32_t failed;		/* Operations completed with result 0 */
+	uint32_t bad;			/* Reads that saw the wrong voltage */
+} BenchThread;
+
+AD5592_Sim sim;
+AD5592_Transport simBus;			/* Simulator transport */
+AD5592_Transport slowBus;			/* Slowed down transport the bus owner uses */
+AD5592_Device dev;
+AD5592_Async async;
+BenchThread threads[BENCH_THREADS];
+int rounds = 2000;					/* Rounds per thread */
+long frameNs = 16000;				/* Time a frame takes on the bus */
+uint32_t failEvery = 0;				/* Every nth transfer fails, 0 for none */
+uint32_t transfers = 0;				/* Transfers since failures were armed */
+uint32_t injected = 0;				/* Transfers made to fail */
+int armed = 0;						/* Set once the board is set up */
+
+/**
+ * Voltage applied to an ADC input pin of the simulated board.
+ */
+static uint16_t benchInput(int pin)
+{
+	return 3000 + pin * 100;
+}
+
+/**
+ * Value a thread writes to its DAC pin in a round.
+ */
+static uint16_t benchOutput(int number, int round)
+{
+	return 500 + (round * 37 + number * 311) % 2000;
+}
+
+/**
+ * Transfer on the simulator, then sleep for the time the frames would
+ * take on a real bus. Every failEvery-th transfer fails instead. Only
+ * the bus owner thread transfers once failures are armed.
+ */
+static int slowTransfer(AD5592_Transport *bus, uint8_t cs, const char txBuf[],
+	char rxBuf[], int frames)
+{
+	AD5592_Transport *inner = bus->context;
+	struct timespec wait = {0, frames * frameNs};
+	int ok;
+
+	if(armed && failEvery && ++transfers % failEvery == 0)
+	{
+		injected++;
+		return 0;
+	}
+	ok = transportTransfer(inner, cs, txBuf, rxBuf, frames);
+	while(wait.tv_nsec >= 1000000000)
+	{
+		wait.tv_sec++;
+		wait.tv_nsec -= 1000000000;
+	}
+	nanosleep(&wait, NULL);
+	return ok;
+}
+
+/**
+ * Check a voltage read.
+ * Returns:
+ * 	1 if it is wrong
+ */
+static int benchWrong(uint16_t milivolts, uint16_t expect)
+{
+	return abs((int)milivolts - expect) > BENCH_TOLERANCE;
+}
+
+/**
+ * Submitter thread.
+ */
+static void *benchSubmitter(void *arg)
+{
+	BenchThread *bench = arg;
+	int out = bench->number;
+	int in = 4 + bench->number;
+	AD5592_AsyncOp before;
+	AD5592_AsyncOp write;
+	AD5592_AsyncOp after;
+	uint16_t value;
+	uint16_t last = 0;
+	int lastKnown = 0;
+	int round;
+
+	for(round = 0; round < rounds; round++)
+	{
+		value = benchOutput(bench->number, round);
+		asyncOpInit(&before, AD5592_ASYNC_ADC_READ, (0x1 << out) | (0x1 << in), 0);
+		asyncOpInit(&write, AD5592_ASYNC_DAC_WRITE, out, value);
+		asyncOpInit(&after, AD5592_ASYNC_ADC_READ, 0x1 << out, 0);
+		asyncSubmit(&async, &before);
+		asyncSubmit(&async, &write);
+		asyncSubmit(&async, &after);
+		asyncWait(&async, &before);
+		asyncWait(&async, &write);
+		asyncWait(&async, &after);
+
+		bench->failed += !before.result + !write.result + !after.result;
+		if(before.result)
+		{
+			bench->bad += benchWrong(before.milivolts[in], benchInput(in));
+			bench->bad += lastKnown && benchWrong(before.milivolts[out], last);
+		}
+		if(write.result && after.result)
+		{
+			bench->bad += benchWrong(after.milivolts[out], value);
+		}
+		/* A failed batch may or may not have reached the pin */
+		last = value;
+		lastKnown = write.result;
+	}
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	int threadCount = BENCH_THREADS;
+	uint32_t failed = 0;
+	uint32_t bad = 0;
+	uint64_t start;
+	double seconds;
+	int option;
+	int i;
+
+	while((option = getopt(argc, argv, "t:n:f:e:")) != -1)
+	{
+		switch(option)
+		{
+			case 't':
+				threadCount = atoi(optarg);
+				break;
+			case 'n':
+				rounds = atoi(optarg);
+				break;
+			case 'f':
+				frameNs = atol(optarg) * 1000;
+				break;
+			case 'e':
+				failEvery = atoi(optarg);
+				break;
+			default:
+				threadCount = 0;
+				break;
+		}
+	}
+	if(threadCount < 1 || threadCount > BENCH_THREADS || rounds < 1 || frameNs < 0 ||
+		failEvery == 1)
+	{
+		printf("Usage: %s [-t threads, 1 to %d] [-n rounds] [-f us per frame]"
+			" [-e fail every nth transfer, 2 or more]\n", argv[0], BENCH_THREADS);
+		return 1;
+	}
+
+	simInit(&sim, 0);
+	for(i = 4; i < 8; i++)
+	{
+		simSetInput(&sim, 0, i, benchInput(i));
+	}
+	simTransportInit(&simBus, &sim);
+	memset(&slowBus, 0, sizeof(slowBus));
+	slowBus.transfer = slowTransfer;
+	slowBus.context = &simBus;
+	deviceInit(&dev, &slowBus, 0);
+	deviceSetPinMode(&dev, 0x0F, AD5592_MODE_DAC | AD5592_MODE_ADC);
+	deviceSetPinMode(&dev, 0xF0, AD5592_MODE_ADC);
+
+	/* From here on only the bus owner transfers */
+	armed = 1;
+	if(!asyncStart(&async, &dev))
+	{
+		printf("Could not start the bus owner\n");
+		return 1;
+	}
+	start = clockNowNs();
+	for(i = 0; i < threadCount; i++)
+	{
+		threads[i].number = i;
+		if(pthread_create(&threads[i].thread, NULL, benchSubmitter, &threads[i]) != 0)
+		{
+			printf("Could not start thread %d\n", i);
+			return 1;
+		}
+	}
+	for(i = 0; i < threadCount; i++)
+	{
+		pthread_join(threads[i].thread, NULL);
+		failed += threads[i].failed;
+		bad += threads[i].bad;
+	}
+	seconds = (clockNowNs() - start) / 1e9;
+	asyncStop(&async);
+
+	printf("threads ops seconds ops_per_sec batches ops_per_batch"
+		" failed_batches failed_ops injected bad\n");
+	printf("%d %u %.3f %.0f %u %.2f %u %u %u %u\n", threadCount, async.ops, seconds,
+		async.ops / seconds, async.batches, (double)async.ops / async.batches,
+		async.failed, failed, injected, bad);
+	return bad || (!failEvery && failed) ? 1 : 0;
+}
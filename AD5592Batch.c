@@ -0,0 +1,459 @@
+/***********************************************************************
+ * File: AD5592Batch.c
+ * Target: AD5592 on a Raspberry Pi
+ * Function: Command batching for the AD5592 device driver
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Batch.h
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.1.0: 16 October 2026
+ * 		- Configuration and data writes go through the board shadow.
+ * 		- Added batchSetAnalogOutAll().
+ * 	* Version 1.1.1: 16 October 2026
+ * 		- The batched reads return -1 and queue nothing when the batch
+ * 			has no room for all of their frames.
+ * 		- batchSend() returns whether the transfer worked.
+ * 		- Added batchScanAdc() for the plan, timing and runner scans.
+ * 		- Pin selects and a running sequence are only taken as set when
+ * 			the shadow is known.
+ **********************************************************************/
+
+#include "AD5592Batch.h"
+
+/**
+ * Set up an empty batch for a board.
+ * Parameters:
+ * 	batch = batch to set up
+ * 	dev = board the batch is sent to
+ */
+void batchInit(AD5592_Batch *batch, AD5592_Device *dev)
+{
+	batch->dev = dev;
+	batch->count = 0;
+}
+
+/**
+ * Empty the batch.
+ * Parameters:
+ * 	batch = batch to clear
+ */
+void batchClear(AD5592_Batch *batch)
+{
+	batch->count = 0;
+}
+
+/**
+ * Queue a command word.
+ * Parameters:
+ * 	batch = batch to add to
+ * 	command = AD5592 word
+ * Returns:
+ * 	Frame index of the command or -1 if the batch is full
+ */
+int batchAdd(AD5592_Batch *batch, AD5592_WORD command)
+{
+	int frame = batch->count;
+
+	if(frame >= AD5592_BATCH_SIZE)
+	{
+		return -1;
+	}
+	batch->txBuf[2 * frame] = (command & 0xFF00) >> 8;
+	batch->txBuf[2 * frame + 1] = command & 0xFF;
+	batch->count++;
+	return frame;
+}
+
+/**
+ * Queue a command word unless the board shadow shows it would not
+ * change anything.
+ * Parameters:
+ * 	batch = batch to add to
+ * 	command = AD5592 word
+ * Returns:
+ * 	Frame index of the command, -1 if it was skipped or the batch is full
+ */
+int batchWrite(AD5592_Batch *batch, AD5592_WORD command)
+{
+	if(batch->count >= AD5592_BATCH_SIZE || !deviceUpdate(batch->dev, command))
+	{
+		return -1;
+	}
+	return batchAdd(batch, command);
+}
+
+/**
+ * Send every queued frame with one call to deviceTransfer().
+ * Parameters:
+ * 	batch = batch to send
+ * Returns:
+ * 	1 on success, 0 if the transfer failed
+ */
+int batchSend(AD5592_Batch *batch)
+{
+	if(batch->count > 0)
+	{
+		return deviceTransfer(batch->dev, batch->txBuf, batch->rxBuf, batch->count);
+	}
+	return 1;
+}
+
+/**
+ * Get the word received during a frame.
+ * Parameters:
+ * 	batch = batch that was sent
+ * 	frame = frame index
+ * Returns:
+ * 	Received word
+ */
+AD5592_WORD batchResponse(AD5592_Batch *batch, int frame)
+{
+	return ((uint8_t)batch->rxBuf[2 * frame] << 8) |
+		(uint8_t)batch->rxBuf[2 * frame + 1];
+}
+
+/**
+ * Check there is room for every frame of a read, so a read is queued
+ * whole or not at all.
+ * Parameters:
+ * 	batch = batch to add to
+ * 	frames = most frames the read can queue
+ * Returns:
+ * 	1 if they fit, 0 if not
+ */
+static int batchRoom(AD5592_Batch *batch, int frames)
+{
+	return batch->count + frames <= AD5592_BATCH_SIZE;
+}
+
+/**
+ * Set pins to digital outputs.
+ * Parameter: Pins as bit mask
+ */
+void batchSetAsDigitalOut(AD5592_Batch *batch, uint8_t pins)
+{
+	batchWrite(batch, AD5592_GPIO_WRITE_CONFIG | pins);
+}
+
+/**
+ * Set pins to digital inputs.
+ * Parameter: Pins as bit mask
+ */
+void batchSetAsDigitalIn(AD5592_Batch *batch, uint8_t pins)
+{
+	batchWrite(batch, AD5592_GPIO_READ_CONFIG | pins);
+}
+
+/**
+ * Set pins to analog outputs.
+ * Parameter: Pins as bit mask
+ */
+void batchSetAsDAC(AD5592_Batch *batch, uint8_t pins)
+{
+	batchWrite(batch, AD5592_DAC_PIN_SELECT | pins);
+}
+
+/**
+ * Set pins to analog inputs.
+ * Parameter: Pins as bit mask
+ */
+void batchSetAsADC(AD5592_Batch *batch, uint8_t pins)
+{
+	batchWrite(batch, AD5592_ADC_PIN_SELECT | pins);
+}
+
+/**
+ * Put pins into a mode with the fewest register writes.
+ * Parameters:
+ * 	pins = pins as bit mask
+ * 	mode = AD5592_MODE_ flags
+ * Returns:
+ * 	Number of words queued
+ */
+int batchSetPinMode(AD5592_Batch *batch, uint8_t pins, uint8_t mode)
+{
+	AD5592_WORD words[AD5592_MODE_COUNT];
+	int count = devicePinModeWords(batch->dev, pins, mode, words);
+	int i;
+
+	for(i = 0; i < count; i++)
+	{
+		batchWrite(batch, words[i]);
+	}
+	return count;
+}
+
+/**
+ * Set a pin to high or low output.
+ * Parameters:
+ * 	All pins with a digital output as bit mask
+ * 	State to be output to all digital out pins as bit mask
+ */
+void batchSetDigitalOut(AD5592_Batch *batch, uint8_t pins, uint8_t states)
+{
+	uint8_t digitalOutPins = deviceRegister(batch->dev, AD5592_GPIO_WRITE_CONFIG);
+
+	if(!deviceKnown(batch->dev, AD5592_GPIO_WRITE_CONFIG) || !(pins == digitalOutPins))
+	{
+		batchSetAsDigitalOut(batch, pins | digitalOutPins);
+	}
+	batchWrite(batch, AD5592_GPIO_WRITE_DATA | states);
+}
+
+/**
+ * Get the digital input states. The pin states come back during the
+ * frame after the read command.
+ * Parameter:
+ * 	All pins to be configured as digital inputs as bit mask
+ * Returns:
+ * 	Frame index of the result, -1 if the batch is full
+ */
+int batchGetDigitalIn(AD5592_Batch *batch, uint8_t pins)
+{
+	uint8_t digitalInPins = deviceRegister(batch->dev, AD5592_GPIO_READ_CONFIG);
+
+	if(!batchRoom(batch, 3))
+	{
+		return -1;
+	}
+	if(!deviceKnown(batch->dev, AD5592_GPIO_READ_CONFIG) || !(pins == digitalInPins))
+	{
+		batchSetAsDigitalIn(batch, pins | digitalInPins);
+	}
+	batchAdd(batch, AD5592_GPIO_READ_INPUT | pins);
+	return batchAdd(batch, AD5592_NOP);
+}
+
+/**
+ * Set an analog output value
+ * Parameters:
+ * 	Pin number to write to as number (0 to 7)
+ *  Value to write in milivolts (assumes 5V reference)
+ */
+void batchSetAnalogOut(AD5592_Batch *batch, uint8_t pin, uint16_t milivolts)
+{
+	uint8_t analogOutPins = deviceRegister(batch->dev, AD5592_DAC_PIN_SELECT);
+
+	if(!deviceKnown(batch->dev, AD5592_DAC_PIN_SELECT) || !((analogOutPins >> pin ) & 0x1))
+	{
+		batchSetAsDAC(batch, analogOutPins | (0x1 << pin));
+	}
+	/* Leave hold mode so the write reaches the pin */
+	batchWrite(batch, AD5592_CNTRL_REG_READBACK | AD5592_LDAC_IMMEDIATE);
+	batchWrite(batch, AD5592_DAC_WRITE_MASK | 	/* DAC write command */
+	((pin <<12) & AD5592_DAC_ADDRESS_MASK)|		/* Set which pin to write */
+	a2d(milivolts));							/* Load digital value */
+}
+
+/**
+ * Set several analog outputs so they all change at the same time. The
+ * outputs match the input registers unless LDAC is in hold mode, so
+ * outside hold mode a pin whose shadow already has the value is left
+ * out.
+ * Parameters:
+ * 	Pins to write as bit mask
+ * 	milivolts[] = 8 entry array indexed by pin number. Only the
+ * 		requested pins are used. (assumes 5V reference)
+ */
+void batchSetAnalogOutAll(AD5592_Batch *batch, uint8_t pins, uint16_t milivolts[])
+{
+	AD5592_Device *dev = batch->dev;
+	uint8_t analogOutPins = deviceRegister(dev, AD5592_DAC_PIN_SELECT);
+	uint8_t ldacKnown = deviceKnown(dev, AD5592_CNTRL_REG_READBACK);
+	uint8_t changed = 0x00;
+	uint16_t count[8];
+	int changes = 0;
+	int pin;
+
+	for(pin = 0; pin < 8; pin++)
+	{
+		if(!((pins >> pin) & 0x1))
+		{
+			continue;
+		}
+		count[pin] = a2d(milivolts[pin]);
+		if(!ldacKnown ||
+			deviceRegister(dev, AD5592_CNTRL_REG_READBACK) == AD5592_LDAC_HOLD ||
+			!((dev->dacKnown >> pin) & 0x1) || dev->dac[pin] != count[pin])
+		{
+			changed |= 0x1 << pin;
+			changes++;
+		}
+	}
+	if(changes == 0)
+	{
+		return;
+	}
+
+	if(!deviceKnown(dev, AD5592_DAC_PIN_SELECT) || (analogOutPins & pins) != pins)
+	{
+		batchSetAsDAC(batch, analogOutPins | pins);
+	}
+	if(changes == 1)
+	{
+		for(pin = 0; !((changed >> pin) & 0x1); pin++);
+		batchSetAnalogOut(batch, pin, milivolts[pin]);
+		return;
+	}
+
+	batchWrite(batch, AD5592_CNTRL_REG_READBACK | AD5592_LDAC_HOLD);
+	for(pin = 0; pin < 8; pin++)
+	{
+		if((changed >> pin) & 0x1)
+		{
+			batchWrite(batch, AD5592_DAC_WRITE_MASK |
+				((pin << 12) & AD5592_DAC_ADDRESS_MASK) | count[pin]);
+		}
+	}
+	batchWrite(batch, AD5592_CNTRL_REG_READBACK | AD5592_LDAC_LOAD);
+}
+
+/**
+ * Get analog input value. The conversion runs during the frame after
+ * the sequence write and the result comes out in the frame after that.
+ * Parameter:
+ * 	Pin number to to get value for as number (0 to 7)
+ * Returns:
+ * 	Frame index of the result, -1 if the batch is full
+ */
+int batchGetAnalogIn(AD5592_Batch *batch, uint8_t pin)
+{
+	uint8_t analogInPins = deviceRegister(batch->dev, AD5592_ADC_PIN_SELECT);
+
+	if(!batchRoom(batch, 4))
+	{
+		return -1;
+	}
+	if(!deviceKnown(batch->dev, AD5592_ADC_PIN_SELECT) || !((analogInPins >> pin ) & 0x1))
+	{
+		batchSetAsADC(batch, analogInPins | (0x1 << pin));
+	}
+	batchWrite(batch, AD5592_ADC_READ | (0x1 << pin));
+	batchAdd(batch, AD5592_NOP);
+	return batchAdd(batch, AD5592_NOP);
+}
+
+/**
+ * Get analog input values for several pins with one ADC sequence.
+ * Parameters:
+ * 	Pins to read as bit mask
+ * 	repeat = non zero to use the repeat mode of the ADC sequencer
+ * Returns:
+ * 	Frame index of the first result, -1 if the batch is full
+ */
+int batchGetAnalogInMulti(AD5592_Batch *batch, uint8_t pins, uint8_t repeat)
+{
+	uint8_t analogInPins = deviceRegister(batch->dev, AD5592_ADC_PIN_SELECT);
+	AD5592_WORD sequence = AD5592_ADC_READ | pins;
+	int channels = 0;
+	int first;
+	int i;
+
+	for(i = 0; i < 8; i++)
+	{
+		channels += (pins >> i) & 0x1;
+	}
+	/* Pin select, sequence and its NOP, then the results */
+	if(!batchRoom(batch, 3 + channels))
+	{
+		return -1;
+	}
+	if(!deviceKnown(batch->dev, AD5592_ADC_PIN_SELECT) || (analogInPins & pins) != pins)
+	{
+		batchSetAsADC(batch, analogInPins | pins);
+	}
+	if(repeat)
+	{
+		sequence |= AD5592_ADC_SEQ_REP;
+	}
+
+	if(!deviceKnown(batch->dev, AD5592_ADC_READ) ||
+		sequence != (AD5592_ADC_READ | deviceRegister(batch->dev, AD5592_ADC_READ)) || !repeat)
+	{
+		/* Program the sequence. The first conversion runs during the
+		 * next frame and its result comes out the frame after that. */
+		batchWrite(batch, sequence);
+		batchAdd(batch, AD5592_NOP);
+	}else
+	{
+		/* The sequence is still running. The first word out is the
+		 * conversion left over from the last scan so clock one extra
+		 * frame and let the fresh result overwrite it. */
+		channels++;
+	}
+
+	first = batch->count;
+	for(i = 0; i < channels; i++)
+	{
+		batchAdd(batch, AD5592_NOP);
+	}
+	return first;
+}
+
+/**
+ * Decode digital input states.
+ * Parameters:
+ * 	batch = batch that was sent
+ * 	frame = frame index returned by batchGetDigitalIn()
+ * Returns:
+ * 	Pin states as bit mask
+ */
+uint8_t batchDigitalResult(AD5592_Batch *batch, int frame)
+{
+	return batchResponse(batch, frame) & AD5592_PIN_SELECT_MASK;
+}
+
+/**
+ * Decode an analog input value.
+ * Parameters:
+ * 	batch = batch that was sent
+ * 	frame = frame index returned by batchGetAnalogIn()
+ * Returns:
+ * 	milivolts (assumes 5V reference)
+ */
+uint16_t batchAnalogResult(AD5592_Batch *batch, int frame)
+{
+	return d2a(batchResponse(batch, frame) & AD5592_ADC_VALUE_MASK);
+}
+
+/**
+ * Scan ADC pins of a board once with one sequence and sort the counts
+ * by the pin address each result carries.
+ * Parameters:
+ * 	dev = board, the pins must be ADC inputs
+ * 	pins = pins as bit mask
+ * 	counts[] = 8 entry array of counts indexed by pin number. Only the
+ * 		requested pins are written, all 8 on failure.
+ * Returns:
+ * 	1 on success, 0 if the transfer failed. counts[] is filled with
+ * 	AD5592_BATCH_NO_RESULT then.
+ */
+int batchScanAdc(AD5592_Device *dev, uint8_t pins, uint16_t counts[])
+{
+	AD5592_Batch batch;
+	AD5592_WORD word;
+	int first;
+	int i;
+
+	batchInit(&batch, dev);
+	first = batchGetAnalogInMulti(&batch, pins, 0);
+	if(first < 0 || !batchSend(&batch))
+	{
+		for(i = 0; i < 8; i++)
+		{
+			counts[i] = AD5592_BATCH_NO_RESULT;
+		}
+		return 0;
+	}
+	for(i = first; i < batch.count; i++)
+	{
+		word = batchResponse(&batch, i);
+		counts[(word & AD5592_ADC_ADDRESS_MASK) >> 12] = word & AD5592_ADC_VALUE_MASK;
+	}
+	return 1;
+}
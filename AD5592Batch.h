@@ -0,0 +1,218 @@
+/*********************************************************************
+ * File: AD5592Batch.h
+ * Target: AD5592 on a Raspberry Pi
+ * Function: Command batching for the AD5592 device driver
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release. Collects AD5592 command words into one
+ * 			contiguous buffer and sends them with a single call to
+ * 			spiTransfer(). Batched variants of the driver functions.
+ * 	* Version 1.1.0: 16 October 2026
+ * 		- Batches belong to an AD5592_Device and use its shadow
+ * 			registers to drop configuration writes that change nothing.
+ * 		- Added batchSetAnalogOutAll().
+ * 	* Version 1.1.1: 16 October 2026
+ * 		- The batched reads return -1 and queue nothing when the batch
+ * 			has no room for all of their frames.
+ * 		- batchSend() returns whether the transfer worked.
+ * 		- Added batchScanAdc().
+ **********************************************************************/
+
+#ifndef SOURCES_AD5592BATCH_H_
+#define SOURCES_AD5592BATCH_H_
+
+#include "AD5592RPI.h"
+
+/**
+ * Maximum number of 16 bit frames in one batch.
+ */
+#define AD5592_BATCH_SIZE	64
+
+/**
+ * Count or state left in a result array by a read that did not fit its
+ * batch. No 12 bit count or pin state can have this value so it fails
+ * every check.
+ */
+#define AD5592_BATCH_NO_RESULT	0xFFFF
+
+/**
+ * A batch of AD5592 frames. The AD5592 returns the result of a read
+ * during a later frame, so the batched read functions return the index
+ * of the frame that will carry their result. Use batchResponse() with
+ * that index after batchSend().
+ */
+typedef struct
+{
+	AD5592_Device *dev;					/* Board the batch is sent to */
+	char txBuf[2 * AD5592_BATCH_SIZE];	/* Frames to send, MSB first */
+	char rxBuf[2 * AD5592_BATCH_SIZE];	/* Frames received, MSB first */
+	int count;							/* Number of frames queued */
+} AD5592_Batch;
+
+/**
+ * Set up an empty batch for a board.
+ * Parameters:
+ * 	batch = batch to set up
+ * 	dev = board the batch is sent to
+ */
+void batchInit(AD5592_Batch *batch, AD5592_Device *dev);
+
+/**
+ * Empty the batch.
+ * Parameters:
+ * 	batch = batch to clear
+ */
+void batchClear(AD5592_Batch *batch);
+
+/**
+ * Queue a command word.
+ * Parameters:
+ * 	batch = batch to add to
+ * 	command = AD5592 word
+ * Returns:
+ * 	Frame index of the command or -1 if the batch is full
+ */
+int batchAdd(AD5592_Batch *batch, AD5592_WORD command);
+
+/**
+ * Queue a command word unless the board shadow shows it would not
+ * change anything. The shadow is updated as the word is queued so
+ * every batch built this way must be sent.
+ * Parameters:
+ * 	batch = batch to add to
+ * 	command = AD5592 word
+ * Returns:
+ * 	Frame index of the command, -1 if it was skipped or the batch is full
+ */
+int batchWrite(AD5592_Batch *batch, AD5592_WORD command);
+
+/**
+ * Send every queued frame with one call to deviceTransfer(). The batch
+ * keeps its frames so it can be sent again.
+ * Parameters:
+ * 	batch = batch to send
+ * Returns:
+ * 	1 on success, 0 if the transfer failed
+ */
+int batchSend(AD5592_Batch *batch);
+
+/**
+ * Get the word received during a frame.
+ * Parameters:
+ * 	batch = batch that was sent
+ * 	frame = frame index
+ * Returns:
+ * 	Received word
+ */
+AD5592_WORD batchResponse(AD5592_Batch *batch, int frame);
+
+/**
+ * Batched pin configuration. Same bookkeeping as the unbatched
+ * functions but without their settling delays. Send the batch and wait
+ * before queueing anything that relies on the pins having settled.
+ * Parameter: Pins as bit mask
+ */
+void batchSetAsDigitalOut(AD5592_Batch *batch, uint8_t pins);
+void batchSetAsDigitalIn(AD5592_Batch *batch, uint8_t pins);
+void batchSetAsDAC(AD5592_Batch *batch, uint8_t pins);
+void batchSetAsADC(AD5592_Batch *batch, uint8_t pins);
+
+/**
+ * Batched deviceSetPinMode().
+ * Parameters:
+ * 	pins = pins as bit mask
+ * 	mode = AD5592_MODE_ flags
+ * Returns:
+ * 	Number of words queued
+ */
+int batchSetPinMode(AD5592_Batch *batch, uint8_t pins, uint8_t mode);
+
+/**
+ * Batched setDigitalOut().
+ * Parameters:
+ * 	All pins with a digital output as bit mask
+ * 	State to be output to all digital out pins as bit mask
+ */
+void batchSetDigitalOut(AD5592_Batch *batch, uint8_t pins, uint8_t states);
+
+/**
+ * Batched getDigitalIn().
+ * Parameter:
+ * 	All pins to be configured as digital inputs as bit mask
+ * Returns:
+ * 	Frame index of the result, -1 if the batch is full. Read it with
+ * 	batchDigitalResult().
+ */
+int batchGetDigitalIn(AD5592_Batch *batch, uint8_t pins);
+
+/**
+ * Batched setAnalogOut().
+ * Parameters:
+ * 	Pin number to write to as number (0 to 7)
+ *  Value to write in milivolts (assumes 5V reference)
+ */
+void batchSetAnalogOut(AD5592_Batch *batch, uint8_t pin, uint16_t milivolts);
+
+/**
+ * Batched setAnalogOutAll(). Queues nothing when every output already
+ * has its value.
+ * Parameters:
+ * 	Pins to write as bit mask
+ * 	milivolts[] = 8 entry array indexed by pin number. Only the
+ * 		requested pins are used. (assumes 5V reference)
+ */
+void batchSetAnalogOutAll(AD5592_Batch *batch, uint8_t pins, uint16_t milivolts[]);
+
+/**
+ * Batched getAnalogIn().
+ * Parameter:
+ * 	Pin number to to get value for as number (0 to 7)
+ * Returns:
+ * 	Frame index of the result, -1 if the batch is full. Read it with
+ * 	batchAnalogResult().
+ */
+int batchGetAnalogIn(AD5592_Batch *batch, uint8_t pin);
+
+/**
+ * Batched getAnalogInMulti(). Queues the sequence and one frame per
+ * result. The results arrive in the frames from the returned index to
+ * the end of the batch at the time of the call.
+ * Parameters:
+ * 	Pins to read as bit mask
+ * 	repeat = non zero to use the repeat mode of the ADC sequencer
+ * Returns:
+ * 	Frame index of the first result, -1 if the batch is full
+ */
+int batchGetAnalogInMulti(AD5592_Batch *batch, uint8_t pins, uint8_t repeat);
+
+/**
+ * Decode results of a sent batch.
+ * Parameters:
+ * 	batch = batch that was sent
+ * 	frame = frame index returned when the read was queued
+ * Returns:
+ * 	Pin states as bit mask or milivolts (assumes 5V reference)
+ */
+uint8_t batchDigitalResult(AD5592_Batch *batch, int frame);
+uint16_t batchAnalogResult(AD5592_Batch *batch, int frame);
+
+/**
+ * Scan ADC pins of a board once with one sequence and sort the counts
+ * by the pin address each result carries.
+ * Parameters:
+ * 	dev = board, the pins must be ADC inputs
+ * 	pins = pins as bit mask
+ * 	counts[] = 8 entry array of counts indexed by pin number. Only the
+ * 		requested pins are written, all 8 on failure.
+ * Returns:
+ * 	1 on success, 0 if the transfer failed. counts[] is filled with
+ * 	AD5592_BATCH_NO_RESULT then.
+ */
+int batchScanAdc(AD5592_Device *dev, uint8_t pins, uint16_t counts[]);
+
+#endif /* SOURCES_AD5592BATCH_H_ */
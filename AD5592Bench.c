@@ -0,0 +1,621 @@
+/**
+ * File: AD5592Bench.c
+ * Target: Raspberry Pi or any Linux host
+ * Function: Benchmark for the AD5592 driver hot paths
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Batch.h v1.1.0
+ * 		-AD5592Transport.h v1.0.0
+ * 		-AD5592Sim.h v1.0.1
+ * 		-AD5592Pipe.h v1.0.0
+ * 		-AD5592Decode.h v1.0.0
+ * 		-AD5592Stats.h v1.0.0
+ * 		-AD5592Trace.h v1.0.0
+ * 		-AD5592Filter.h v1.0.0
+ * 		-AD5592Cmd.h v1.0.0
+ * 		-AD5592Clock.h v1.0.0
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version: 1.0.0:
+ * 		-Runs each workload against the chosen transport and reports
+ * 		ops/sec, SPI words per operation, bus idle time and p50/p99
+ * 		latency.
+ *
+ * 		-Transports: sim (default, two cross wired simulated boards),
+ * 		loopback, spidev and bcm2835 (unless built with
+ * 		AD5592_NO_BCM2835). Hardware transports need the ATP jig: the
+ * 		board on CS0 drives and the board on CS1 measures.
+ *
+ * 		-The atp workload repeats the SPI traffic of one analogIOTest()
+ * 		level for all 8 pins without the delays, so it measures bus work
+ * 		and not sleeping.
+ *
+ * 		-Usage: AD5592Bench [-t transport] [-n iterations] [-o results]
+ * 			[-b baseline] [-r max ops/sec drop in percent]
+ * 		The results file has one line per workload:
+ * 			workload ops_per_sec words_per_op bus_idle_pct p50_us p99_us
+ * 		Compared with a baseline the exit status is 1 if any workload
+ * 		uses more words per operation, or drops more ops/sec than -r
+ * 		allows when -r is given.
+ *
+ * 	* Version: 1.1.0:
+ * 		-Added the loop and loopPipe workloads. Both read one ADC pin
+ * 		and write one DAC pin per operation on the CS0 board, loop with
+ * 		the unpipelined functions and loopPipe through an AD5592_Pipe
+ * 		flushed every 4 operations.
+ *
+ * 		-Added the setAnalogOutAll workload. It updates all 8 DAC pins
+ * 		of the CS0 board together per operation.
+ *
+ * 		-Added the decode1k workload. It decodes 1024 ADC result frames
+ * 		per operation with decodeAdcFrames() and uses no bus time.
+ *
+ * 	* Version: 1.2.0:
+ * 		-Added -s file to write the driver statistics of the whole run.
+ * 		Build with -DAD5592_STATS and AD5592Stats.c to collect them.
+ *
+ * 	* Version: 1.3.0:
+ * 		-Added -w file to record every transfer of the run to a trace
+ * 		for AD5592Replay. Writing the trace lowers ops/sec; words per
+ * 		operation are unchanged.
+ *
+ * 	* Version: 1.4.0:
+ * 		-Added the filter1k workload. It runs the decode1k frames through
+ * 		an AD5592_Filter with a boxcar, a FIR and a moving average per
+ * 		operation and uses no bus time.
+ *
+ * 	* Version: 1.5.0:
+ * 		-Added the scan8Const workload. It does the scan8 reads with a
+ * 		constant sequence from AD5592Cmd.h sent by deviceSend(), so no
+ * 		words are built or byte swapped per operation.
+ *
+ * 	* Version: 1.5.1:
+ * 		-Times with clockNowNs() from AD5592Clock.h.
+ * 		-scan8Const only takes the ADC pins as set when the shadow is
+ * 		known.
+ *
+ **********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "AD5592RPI.h"
+#include "AD5592Batch.h"
+#include "AD5592Cmd.h"
+#include "AD5592Pipe.h"
+#include "AD5592Decode.h"
+#include "AD5592Stats.h"
+#include "AD5592Trace.h"
+#include "AD5592Filter.h"
+#include "AD5592Clock.h"
+#include "AD5592Sim.h"
+
+#define	DEFAULT_ITERATIONS	2000	/* Operations per workload */
+#define MAX_WORKLOADS		16		/* Workloads in a results file */
+#define	NAME_LENGTH			32		/* Longest workload name */
+#define DECODE_FRAMES		1024	/* Frames per decode1k operation */
+
+/**
+ * Transport wrapper that adds up the time spent on the bus.
+ */
+typedef struct
+{
+	AD5592_Transport *inner;	/* Transport doing the work */
+	uint64_t busyNs;			/* Time spent in transfers */
+} TimedBus;
+
+/**
+ * Result of one workload.
+ */
+typedef struct
+{
+	char name[NAME_LENGTH];
+	double opsPerSec;
+	double wordsPerOp;
+	double idlePct;
+	double p50Us;
+	double p99Us;
+} BenchResult;
+
+typedef void (*Workload)(int i);
+
+AD5592_Transport hardwareBus;	/* Transport picked on the command line */
+AD5592_Transport timedBus;		/* Timing wrapper around it */
+TimedBus timing;				/* Timing wrapper data */
+AD5592_Transport traceBus;		/* Trace recorder around the timing wrapper for -w */
+AD5592_Trace trace;				/* Trace for -w */
+AD5592_Pipe loopPipe;			/* Pipe for the loopPipe workload */
+char decodeBuf[2 * DECODE_FRAMES];	/* Frames for the decode1k and filter1k workloads */
+AD5592_Filter benchFilter;		/* Filter for the filter1k workload */
+uint16_t scanMilivolts[8];		/* Results of the scan8Const workload */
+AD5592_Sim sim;					/* Simulator for -t sim */
+AD5592_Spidev spidev;			/* spidev data for -t spidev */
+
+/**
+ * Timing wrapper transfer.
+ */
+int timedTransfer(AD5592_Transport *bus, uint8_t cs, const char txBuf[],
+	char rxBuf[], int frames)
+{
+	TimedBus *timed = bus->context;
+	uint64_t start = clockNowNs();
+	int ok = transportTransfer(timed->inner, cs, txBuf, rxBuf, frames);
+
+	timed->busyNs += clockNowNs() - start;
+	return ok;
+}
+
+/**
+ * Workloads. The argument is the iteration number.
+ */
+void benchGetAnalogIn(int i)
+{
+	setAD5592Ch(1);
+	getAnalogIn(i & 0x7);
+}
+
+void benchSetAnalogOut(int i)
+{
+	setAD5592Ch(0);
+	setAnalogOut(i & 0x7, (i * 37) % 5000);
+}
+
+void benchSetAnalogOutAll(int i)
+{
+	uint16_t milivolts[8];
+	int pin;
+
+	for(pin = 0; pin < 8; pin++)
+	{
+		milivolts[pin] = (i * 37 + pin * 500) % 5000;
+	}
+	setAD5592Ch(0);
+	setAnalogOutAll(AD5592_PIN_SELECT_MASK, milivolts);
+}
+
+void benchGetDigitalIn(int i)
+{
+	(void)i;
+	setAD5592Ch(1);
+	getDigitalIn(AD5592_PIN_SELECT_MASK);
+}
+
+void benchScan(int i)
+{
+	uint16_t milivolts[8];
+
+	(void)i;
+	setAD5592Ch(1);
+	getAnalogInMulti(AD5592_PIN_SELECT_MASK, milivolts, 0);
+}
+
+void benchScanRepeat(int i)
+{
+	uint16_t milivolts[8];
+
+	(void)i;
+	setAD5592Ch(1);
+	getAnalogInMulti(AD5592_PIN_SELECT_MASK, milivolts, 1);
+}
+
+void benchScanConst(int i)
+{
+	static const char scan[] =
+	{
+		AD5592_FRAME(AD5592_CMD_ADC_SEQ(AD5592_PIN_SELECT_MASK, 0)),
+		AD5592_FRAME(AD5592_CMD_NOP),
+		AD5592_FRAME(AD5592_CMD_NOP), AD5592_FRAME(AD5592_CMD_NOP),
+		AD5592_FRAME(AD5592_CMD_NOP), AD5592_FRAME(AD5592_CMD_NOP),
+		AD5592_FRAME(AD5592_CMD_NOP), AD5592_FRAME(AD5592_CMD_NOP),
+		AD5592_FRAME(AD5592_CMD_NOP), AD5592_FRAME(AD5592_CMD_NOP)
+	};
+	char rxBuf[sizeof(scan)];
+	AD5592_WORD word;
+	int frame;
+
+	(void)i;
+	setAD5592Ch(1);
+	if(!deviceKnown(currentDevice, AD5592_ADC_PIN_SELECT) ||
+		deviceRegister(currentDevice, AD5592_ADC_PIN_SELECT) != AD5592_PIN_SELECT_MASK)
+	{
+		setAsADC(AD5592_PIN_SELECT_MASK);
+	}
+	deviceSend(currentDevice, scan, rxBuf, AD5592_FRAMES(scan));
+	for(frame = 2; frame < AD5592_FRAMES(scan); frame++)
+	{
+		word = ((uint8_t)rxBuf[2 * frame] << 8) | (uint8_t)rxBuf[2 * frame + 1];
+		scanMilivolts[(word & AD5592_ADC_ADDRESS_MASK) >> 12] = d2a(word & AD5592_ADC_VALUE_MASK);
+	}
+}
+
+void benchLoop(int i)
+{
+	setAD5592Ch(0);
+	getAnalogIn(4 + (i & 0x3));
+	setAnalogOut(i & 0x3, (i * 37) % 5000);
+}
+
+void benchLoopPipe(int i)
+{
+	static uint16_t milivolts[8];
+
+	pipeGetAnalogIn(&loopPipe, 0x10 << (i & 0x3), milivolts);
+	pipeSetAnalogOut(&loopPipe, i & 0x3, (i * 37) % 5000);
+	if((i & 0x3) == 0x3)
+	{
+		pipeFlush(&loopPipe);
+	}
+}
+
+void benchDecode(int i)
+{
+	static uint16_t samples[8][DECODE_FRAMES / 8];
+	uint16_t *channel[8];
+	int count[8];
+	int pin;
+
+	(void)i;
+	for(pin = 0; pin < 8; pin++)
+	{
+		channel[pin] = samples[pin];
+		count[pin] = 0;
+	}
+	decodeAdcFrames(decodeBuf, DECODE_FRAMES, channel, count, DECODE_FRAMES / 8);
+}
+
+void benchFilter1k(int i)
+{
+	static int16_t outputs[8][DECODE_FRAMES / 8];
+	int16_t *channel[8];
+	int count[8];
+	int pin;
+
+	(void)i;
+	for(pin = 0; pin < 8; pin++)
+	{
+		channel[pin] = outputs[pin];
+		count[pin] = 0;
+	}
+	filterFrames(&benchFilter, decodeBuf, DECODE_FRAMES, channel, count, DECODE_FRAMES / 8);
+}
+
+void benchAtp(int i)
+{
+	int pin;
+
+	(void)i;
+	for(pin = 0; pin < 8; pin++)
+	{
+		setAD5592Ch(0);
+		spiComs(AD5592_SW_RESET);
+		spiComs(AD5592_DAC_PIN_SELECT | (0x1 << pin));
+		spiComs(AD5592_DAC_WRITE_MASK | ((pin << 12) & AD5592_DAC_ADDRESS_MASK) | a2d(2500));
+		setAD5592Ch(1);
+		spiComs(AD5592_SW_RESET);
+		spiComs(AD5592_ADC_PIN_SELECT | (0x1 << pin));
+		spiComs(AD5592_ADC_READ | (0x1 << pin));
+		spiComs(AD5592_NOP);
+		spiComs(AD5592_NOP);
+	}
+}
+
+/**
+ * Compare two latencies for qsort().
+ */
+int compareLatency(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * Run one workload and fill in its result.
+ * Parameters:
+ * 	name = workload name
+ * 	workload = function to run
+ * 	iterations = operations to run
+ * 	latency[] = scratch space for iterations latencies
+ * 	result = result to fill in
+ */
+void runWorkload(const char *name, Workload workload, int iterations,
+	uint32_t latency[], BenchResult *result)
+{
+	uint64_t start;
+	uint64_t opStart;
+	uint64_t wall;
+	uint32_t frames;
+	int i;
+
+	/* Known register state on both boards, then a warm up pass over
+	 * every pin so pin configuration is not timed */
+	deviceReset(&ad5592Channel[0]);
+	deviceReset(&ad5592Channel[1]);
+	for(i = 0; i < 8; i++)
+	{
+		workload(i);
+	}
+
+	frames = timedBus.frames;
+	timing.busyNs = 0;
+	start = clockNowNs();
+	for(i = 0; i < iterations; i++)
+	{
+		opStart = clockNowNs();
+		workload(i);
+		latency[i] = clockNowNs() - opStart;
+	}
+	wall = clockNowNs() - start;
+	qsort(latency, iterations, sizeof(latency[0]), compareLatency);
+
+	strncpy(result->name, name, NAME_LENGTH - 1);
+	result->name[NAME_LENGTH - 1] = '\0';
+	result->opsPerSec = iterations * 1e9 / wall;
+	result->wordsPerOp = (double)(timedBus.frames - frames) / iterations;
+	result->idlePct = 100.0 * (wall - timing.busyNs) / wall;
+	result->p50Us = latency[iterations / 2] / 1000.0;
+	result->p99Us = latency[(iterations * 99) / 100] / 1000.0;
+}
+
+/**
+ * Write results in the results file format.
+ * Parameters:
+ * 	file = where to write
+ * 	results[] = results
+ * 	count = number of results
+ */
+void writeResults(FILE *file, BenchResult results[], int count)
+{
+	int i;
+
+	fprintf(file, "# workload ops_per_sec words_per_op bus_idle_pct p50_us p99_us\n");
+	for(i = 0; i < count; i++)
+	{
+		fprintf(file, "%s %.1f %.3f %.1f %.2f %.2f\n", results[i].name,
+			results[i].opsPerSec, results[i].wordsPerOp, results[i].idlePct,
+			results[i].p50Us, results[i].p99Us);
+	}
+}
+
+/**
+ * Read a results file.
+ * Parameters:
+ * 	path = file name
+ * 	results[] = MAX_WORKLOADS entry array to fill in
+ * Returns:
+ * 	Number of results read, -1 if the file could not be opened
+ */
+int readResults(const char *path, BenchResult results[])
+{
+	FILE *file = fopen(path, "r");
+	char line[256];
+	int count = 0;
+
+	if(file == NULL)
+	{
+		return -1;
+	}
+	while(count < MAX_WORKLOADS && fgets(line, sizeof(line), file))
+	{
+		if(line[0] == '#')
+		{
+			continue;
+		}
+		if(sscanf(line, "%31s %lf %lf %lf %lf %lf", results[count].name,
+			&results[count].opsPerSec, &results[count].wordsPerOp,
+			&results[count].idlePct, &results[count].p50Us,
+			&results[count].p99Us) == 6)
+		{
+			count++;
+		}
+	}
+	fclose(file);
+	return count;
+}
+
+/**
+ * Compare results with a baseline and report the differences.
+ * Parameters:
+ * 	results[] = this run
+ * 	count = number of results
+ * 	baseline[] = stored run
+ * 	baseCount = number of stored results
+ * 	maxDrop = largest allowed ops/sec drop in percent, < 0 to not check
+ * Returns:
+ * 	Number of regressions
+ */
+int compareResults(BenchResult results[], int count, BenchResult baseline[],
+	int baseCount, double maxDrop)
+{
+	int regressions = 0;
+	double change;
+	int i;
+	int j;
+
+	printf("\n%-14s %12s %12s %10s\n", "workload", "ops/s change", "words/op", "baseline");
+	for(i = 0; i < count; i++)
+	{
+		for(j = 0; j < baseCount && strcmp(results[i].name, baseline[j].name); j++);
+		if(j == baseCount)
+		{
+			printf("%-14s %12s\n", results[i].name, "new");
+			continue;
+		}
+		change = 100.0 * (results[i].opsPerSec - baseline[j].opsPerSec) / baseline[j].opsPerSec;
+		printf("%-14s %+11.1f%% %12.3f %10.3f", results[i].name, change,
+			results[i].wordsPerOp, baseline[j].wordsPerOp);
+		if(results[i].wordsPerOp > baseline[j].wordsPerOp + 0.0005 ||
+			(maxDrop >= 0 && -change > maxDrop))
+		{
+			printf("  REGRESSION");
+			regressions++;
+		}
+		printf("\n");
+	}
+	return regressions;
+}
+
+int main(int argc, char **argv)
+{
+	const char *transport = "sim";
+	const char *outPath = NULL;
+	const char *basePath = NULL;
+	const char *statsPath = NULL;
+	const char *tracePath = NULL;
+	static AD5592_FilterConfig filterConfig;
+	double maxDrop = -1;
+	int iterations = DEFAULT_ITERATIONS;
+	BenchResult results[MAX_WORKLOADS];
+	BenchResult baseline[MAX_WORKLOADS];
+	uint32_t *latency;
+	int count = 0;
+	int i;
+	int baseCount;
+	int option;
+	FILE *file;
+
+	while((option = getopt(argc, argv, "t:n:o:b:r:s:w:")) != -1)
+	{
+		switch(option)
+		{
+			case 't': transport = optarg; break;
+			case 'n': iterations = atoi(optarg); break;
+			case 'o': outPath = optarg; break;
+			case 'b': basePath = optarg; break;
+			case 'r': maxDrop = atof(optarg); break;
+			case 's': statsPath = optarg; break;
+			case 'w': tracePath = optarg; break;
+			default:
+				printf("Usage: %s [-t sim|loopback|spidev|bcm2835] [-n iterations]"
+					" [-o results] [-b baseline] [-r max ops/sec drop %%] [-s stats]"
+					" [-w trace]\n", argv[0]);
+				return 1;
+		}
+	}
+	if(iterations < 1)
+	{
+		iterations = DEFAULT_ITERATIONS;
+	}
+
+	/* Set up the transport */
+	if(strcmp(transport, "sim") == 0)
+	{
+		simInit(&sim, 1);
+		simTransportInit(&hardwareBus, &sim);
+	}else if(strcmp(transport, "loopback") == 0)
+	{
+		loopbackTransportInit(&hardwareBus);
+	}else if(strcmp(transport, "spidev") == 0)
+	{
+		if(!spidevTransportInit(&hardwareBus, &spidev, 0, AD5592_SPI_SPEED_HZ))
+		{
+			printf("Could not open /dev/spidev0.0\n");
+			return 1;
+		}
+#ifndef AD5592_NO_BCM2835
+	}else if(strcmp(transport, "bcm2835") == 0)
+	{
+		if(!bcm2835TransportInit(&hardwareBus))
+		{
+			printf("bcm2835_init failed. Are you running as root??\n");
+			return 1;
+		}
+#endif
+	}else
+	{
+		printf("Unknown transport %s\n", transport);
+		return 1;
+	}
+	timing.inner = &hardwareBus;
+	memset(&timedBus, 0, sizeof(timedBus));
+	timedBus.transfer = timedTransfer;
+	timedBus.context = &timing;
+	AD5592_InitTransport(&timedBus);
+	if(tracePath)
+	{
+		if(!traceOpen(&trace, tracePath, "AD5592Bench"))
+		{
+			printf("Could not create %s\n", tracePath);
+			return 1;
+		}
+		traceTransportInit(&traceBus, &trace, &timedBus);
+		AD5592_InitTransport(&traceBus);
+	}
+	pipeInit(&loopPipe, &ad5592Channel[0]);
+	for(i = 0; i < DECODE_FRAMES; i++)
+	{
+		makeWord(&decodeBuf[2 * i], ((i & 0x7) << 12) | ((i * 37) & AD5592_ADC_VALUE_MASK));
+	}
+	filterConfig.cicOrder = 1;
+	filterConfig.cicRatio = 4;
+	filterConfig.firRatio = 2;
+	filterConfig.average = 4;
+	filterLowpass(&filterConfig, 16, 0.2);
+	filterInit(&benchFilter, &filterConfig);
+
+	latency = malloc(iterations * sizeof(latency[0]));
+	if(latency == NULL)
+	{
+		return 1;
+	}
+
+	/* Run the workloads */
+	runWorkload("getAnalogIn", benchGetAnalogIn, iterations, latency, &results[count++]);
+	runWorkload("setAnalogOut", benchSetAnalogOut, iterations, latency, &results[count++]);
+	runWorkload("setAnalogOutAll", benchSetAnalogOutAll, iterations, latency, &results[count++]);
+	runWorkload("getDigitalIn", benchGetDigitalIn, iterations, latency, &results[count++]);
+	runWorkload("scan8", benchScan, iterations, latency, &results[count++]);
+	runWorkload("scan8Repeat", benchScanRepeat, iterations, latency, &results[count++]);
+	runWorkload("scan8Const", benchScanConst, iterations, latency, &results[count++]);
+	runWorkload("loop", benchLoop, iterations, latency, &results[count++]);
+	runWorkload("loopPipe", benchLoopPipe, iterations, latency, &results[count++]);
+	runWorkload("decode1k", benchDecode, iterations, latency, &results[count++]);
+	runWorkload("filter1k", benchFilter1k, iterations, latency, &results[count++]);
+	runWorkload("atp", benchAtp, iterations / 8 + 1, latency, &results[count++]);
+	free(latency);
+	if(tracePath && !traceClose(&trace))
+	{
+		printf("Could not write %s\n", tracePath);
+		return 1;
+	}
+
+	printf("Transport: %s, %d iterations\n\n", transport, iterations);
+	writeResults(stdout, results, count);
+
+	if(outPath)
+	{
+		file = fopen(outPath, "w");
+		if(file == NULL)
+		{
+			printf("Could not write %s\n", outPath);
+			return 1;
+		}
+		writeResults(file, results, count);
+		fclose(file);
+	}
+
+	if(statsPath && !statsDumpFile(statsPath))
+	{
+		printf("Could not write %s\n", statsPath);
+		return 1;
+	}
+
+	if(basePath)
+	{
+		baseCount = readResults(basePath, baseline);
+		if(baseCount < 0)
+		{
+			printf("Could not read %s\n", basePath);
+			return 1;
+		}
+		if(compareResults(results, count, baseline, baseCount, maxDrop))
+		{
+			return 1;
+		}
+	}
+
+	transportClose(&hardwareBus);
+	return 0;
+}
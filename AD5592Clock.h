@@ -0,0 +1,36 @@
+/*********************************************************************
+ * File: AD5592Clock.h
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Monotonic clock for the AD5592 driver and tools
+ * Dependancies:
+ * 		-none
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release. Replaces the copies of the same function in
+ * 			the timing, stats, log, trace, stream, GPIO and control
+ * 			modules and the bench.
+ **********************************************************************/
+
+#ifndef SOURCES_AD5592CLOCK_H_
+#define SOURCES_AD5592CLOCK_H_
+
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * Read CLOCK_MONOTONIC.
+ * Returns:
+ * 	Nanoseconds
+ */
+static inline uint64_t clockNowNs(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000u + now.tv_nsec;
+}
+
+#endif /* SOURCES_AD5592CLOCK_H_ */
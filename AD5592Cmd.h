@@ -0,0 +1,137 @@
+/*********************************************************************
+ * File: AD5592Cmd.h
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: AD5592 commands and frames checked at compile time
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Conv.h v1.0.0
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ *
+ * The AD5592_CMD_ macros build a command word from constant arguments.
+ * The result is a constant too, so it can go in a static initializer or
+ * a case label. A pin, mask or value that does not fit its field stops
+ * the build with an error on the AD5592_CMD_CHECK bit-field, and so
+ * does an argument that is not a constant. Use the driver functions for
+ * values only known at run time.
+ *
+ * AD5592_FRAME() splits a command into the two bytes the transport
+ * sends, most significant first, so a fixed sequence can be kept in
+ * read only memory ready to send:
+ *
+ * 	static const char scan[] =
+ * 	{
+ * 		AD5592_FRAME(AD5592_CMD_ADC_SEQ(AD5592_IO0 | AD5592_IO1, 0)),
+ * 		AD5592_FRAME(AD5592_CMD_NOP),
+ * 		AD5592_FRAME(AD5592_CMD_NOP),
+ * 		AD5592_FRAME(AD5592_CMD_NOP)
+ * 	};
+ *
+ * 	deviceSend(dev, scan, rxBuf, AD5592_FRAMES(scan));
+ *
+ * deviceSend() keeps the shadow registers in step with the sequence.
+ **********************************************************************/
+
+#ifndef SOURCES_AD5592CMD_H_
+#define SOURCES_AD5592CMD_H_
+
+#include "AD5592RPI.h"
+#include "AD5592Conv.h"
+
+/**
+ * 0 if cond is true. Does not compile if cond is false or not a
+ * constant expression.
+ */
+#define AD5592_CMD_CHECK(cond)		((int)(0 * sizeof(struct { int ad5592CmdCheck : (cond) ? 1 : -1; })))
+
+/**
+ * No operation. Clocks out the result of the last ADC conversion or
+ * readback.
+ */
+#define AD5592_CMD_NOP				((AD5592_WORD)AD5592_NOP)
+
+/**
+ * Control register write with data bits.
+ * Parameters:
+ * 	reg = register command, for example AD5592_CNTRL_REG_READBACK
+ * 	data = data bits, up to AD5592_REG_VALUE_MASK
+ */
+#define AD5592_CMD_REG(reg, data)												\
+	((AD5592_WORD)((reg) | (data)												\
+		| AD5592_CMD_CHECK(((reg) & ~AD5592_CNTRL_ADDRESS_MASK) == 0)		\
+		| AD5592_CMD_CHECK((data) >= 0 && (data) <= AD5592_REG_VALUE_MASK)))
+
+/**
+ * Control register write with a pin mask, for the pin mode registers,
+ * GPIO data and the like.
+ * Parameters:
+ * 	reg = register command, for example AD5592_ADC_PIN_SELECT
+ * 	pins = pins as bit mask
+ */
+#define AD5592_CMD_PINS(reg, pins)												\
+	AD5592_CMD_REG(reg, (pins) | AD5592_CMD_CHECK((pins) >= 0 && (pins) <= AD5592_PIN_SELECT_MASK))
+
+/**
+ * DAC write of a count.
+ * Parameters:
+ * 	pin = pin number, 0 to 7
+ * 	count = 12 bit count
+ */
+#define AD5592_CMD_DAC(pin, count)												\
+	((AD5592_WORD)(AD5592_DAC_WRITE_MASK | ((pin) << 12) | (count)				\
+		| AD5592_CMD_CHECK((pin) >= 0 && (pin) <= 7)								\
+		| AD5592_CMD_CHECK((count) >= 0 && (count) <= AD5592_DAC_VALUE_MASK)))
+
+/**
+ * DAC write of a voltage.
+ * Parameters:
+ * 	pin = pin number, 0 to 7
+ * 	mv = millivolts, up to AD5592_FULL_SCALE_MV
+ */
+#define AD5592_CMD_DAC_MV(pin, mv)												\
+	AD5592_CMD_DAC(pin, (int)AD5592_MV_TO_COUNT(mv)								\
+		| AD5592_CMD_CHECK((mv) >= 0 && (mv) <= AD5592_FULL_SCALE_MV))
+
+/**
+ * ADC sequence register write. The first result comes out two frames
+ * after it.
+ * Parameters:
+ * 	pins = pins to convert as bit mask
+ * 	flags = 0, AD5592_ADC_SEQ_REP and/or AD5592_ADC_SEQ_TEMP
+ */
+#define AD5592_CMD_ADC_SEQ(pins, flags)										\
+	AD5592_CMD_REG(AD5592_ADC_READ, (pins) | (flags)							\
+		| AD5592_CMD_CHECK((pins) >= 0 && (pins) <= AD5592_PIN_SELECT_MASK)	\
+		| AD5592_CMD_CHECK(((flags) & ~(AD5592_ADC_SEQ_REP | AD5592_ADC_SEQ_TEMP)) == 0))
+
+/**
+ * GPIO input read. The states come out in the next frame.
+ * Parameters:
+ * 	pins = GPIO input pins as bit mask
+ */
+#define AD5592_CMD_GPIO_READ(pins)												\
+	((AD5592_WORD)(AD5592_CMD_PINS(AD5592_GPIO_READ_CONFIG, pins) | AD5592_GPIO_READ_INPUT_BIT))
+
+/**
+ * The two bytes of a frame, most significant first, for a char array
+ * initializer.
+ * Parameters:
+ * 	word = command
+ */
+#define AD5592_FRAME(word)		(char)(((word) >> 8) & 0xFF), (char)((word) & 0xFF)
+
+/**
+ * Number of frames in a char array of frames.
+ */
+#define AD5592_FRAMES(frames)	((int)(sizeof(frames) / 2))
+
+_Static_assert(AD5592_CMD_DAC(5, 0x123) ==
+	(AD5592_DAC_WRITE_MASK | ((5 << 12) & AD5592_DAC_ADDRESS_MASK) | 0x123), "DAC command layout");
+_Static_assert(AD5592_CMD_ADC_SEQ(0xFF, AD5592_ADC_SEQ_REP) ==
+	(AD5592_ADC_READ | AD5592_ADC_SEQ_REP | 0xFF), "ADC sequence command layout");
+
+#endif /* SOURCES_AD5592CMD_H_ */
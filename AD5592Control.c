@@ -0,0 +1,450 @@
+/***********************************************************************
+ * File: AD5592Control.c
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Fixed rate closed loop control, ADC in to DAC out
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Pipe.h v1.1.0
+ * 		-AD5592Control.h
+ * 		-pthread
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- A cycle whose transfer fails runs no law, and no output is
+ * 			written until a law has run on good inputs again.
+ * 		- Memory is locked once for every running engine and unlocked
+ * 			when the last one stops.
+ **********************************************************************/
+
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include "AD5592Control.h"
+#include "AD5592Clock.h"
+
+#define CONTROL_STACK_PREFAULT	(64 * 1024)		/* Stack touched before the first cycle */
+
+static pthread_mutex_t controlLockMutex = PTHREAD_MUTEX_INITIALIZER;
+static int controlLockCount;	/* Running engines that hold the memory lock */
+
+/**
+ * Lock all memory for an engine. The first engine calls mlockall(),
+ * the others share its lock.
+ * Returns:
+ * 	1 if memory is locked, 0 if not
+ */
+static int controlLockMemory(void)
+{
+	int locked;
+
+	pthread_mutex_lock(&controlLockMutex);
+	locked = controlLockCount > 0 || mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+	if(locked)
+	{
+		controlLockCount++;
+	}
+	pthread_mutex_unlock(&controlLockMutex);
+	return locked;
+}
+
+/**
+ * Drop an engine's share of the memory lock. The last one unlocks.
+ */
+static void controlUnlockMemory(void)
+{
+	pthread_mutex_lock(&controlLockMutex);
+	if(--controlLockCount == 0)
+	{
+		munlockall();
+	}
+	pthread_mutex_unlock(&controlLockMutex);
+}
+
+/**
+ * Sleep until an absolute CLOCK_MONOTONIC time.
+ */
+static void controlSleepUntil(uint64_t ns)
+{
+	struct timespec until;
+
+	until.tv_sec = ns / 1000000000u;
+	until.tv_nsec = ns % 1000000000u;
+	while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL) != 0);
+}
+
+/**
+ * Touch the stack the thread will use so no page faults land in a cycle.
+ */
+static void controlPrefaultStack(void)
+{
+	volatile char stack[CONTROL_STACK_PREFAULT];
+
+	memset((char *)stack, 0, sizeof(stack));
+}
+
+/**
+ * Record the timing of one cycle.
+ */
+static void controlRecord(AD5592_ControlStats *stats, uint64_t wakeNs, uint64_t cycleNs)
+{
+	uint64_t us = wakeNs / 1000;
+	int bucket = us ? 63 - __builtin_clzll(us) : 0;
+
+	if(bucket >= AD5592_CONTROL_BUCKETS)
+	{
+		bucket = AD5592_CONTROL_BUCKETS - 1;
+	}
+	stats->wakeUs[bucket]++;
+	if(stats->cycles == 0 || wakeNs < stats->wakeMinNs)
+	{
+		stats->wakeMinNs = wakeNs;
+	}
+	if(wakeNs > stats->wakeMaxNs)
+	{
+		stats->wakeMaxNs = wakeNs;
+	}
+	if(cycleNs > stats->cycleMaxNs)
+	{
+		stats->cycleMaxNs = cycleNs;
+	}
+	stats->wakeTotalNs += wakeNs;
+	stats->cycles++;
+}
+
+/**
+ * Control thread.
+ */
+static void *controlThread(void *arg)
+{
+	AD5592_Control *control = arg;
+	AD5592_ControlLoop *loop;
+	uint64_t periodNs = control->periodUs * 1000ull;
+	uint64_t deadline;
+	uint64_t wake;
+	uint64_t done;
+	uint8_t inPins = 0;
+	int i;
+
+	controlPrefaultStack();
+	for(i = 0; i < control->loops; i++)
+	{
+		inPins |= 0x1 << control->loop[i].inPin;
+	}
+
+	deadline = clockNowNs() + periodNs;
+	while(atomic_load_explicit(&control->running, memory_order_relaxed))
+	{
+		controlSleepUntil(deadline);
+		wake = clockNowNs();
+
+		/* Read every input, and write the outputs of the cycle before in
+		 * the frames between the conversions, in one transfer */
+		pipeGetAnalogIn(&control->pipe, inPins, control->input);
+		for(i = 0; i < control->loops; i++)
+		{
+			loop = &control->loop[i];
+			if(loop->primed)
+			{
+				pipeSetAnalogOut(&control->pipe, loop->outPin, loop->output);
+			}
+		}
+		if(pipeFlush(&control->pipe))
+		{
+			for(i = 0; i < control->loops; i++)
+			{
+				loop = &control->loop[i];
+				loop->output = loop->law(loop, control->input[loop->inPin],
+					atomic_load_explicit(&loop->setpoint, memory_order_relaxed));
+				loop->primed = 1;
+			}
+		}else
+		{
+			/* The inputs are stale. Run no law, and write no output
+			 * until a law has run on good inputs */
+			control->stats.failed++;
+			for(i = 0; i < control->loops; i++)
+			{
+				control->loop[i].primed = 0;
+			}
+		}
+
+		done = clockNowNs();
+		controlRecord(&control->stats, wake - deadline, done - wake);
+		deadline += periodNs;
+		if(done > deadline)
+		{
+			control->stats.misses++;
+			while(deadline < done)
+			{
+				deadline += periodNs;
+				control->stats.skipped++;
+			}
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Set up a control engine with no loops.
+ * Parameters:
+ * 	control = engine to set up
+ * 	dev = board
+ * 	periodUs = cycle period
+ */
+void controlInit(AD5592_Control *control, AD5592_Device *dev, uint32_t periodUs)
+{
+	memset(control, 0, sizeof(*control));
+	control->dev = dev;
+	control->periodUs = periodUs ? periodUs : 1;
+	pipeInit(&control->pipe, dev);
+	atomic_init(&control->running, 0);
+}
+
+/**
+ * Check that a new loop fits and its pins do not clash with the others.
+ * Outputs may not be inputs of any loop and each output has one loop.
+ */
+static AD5592_ControlLoop *controlNewLoop(AD5592_Control *control, uint8_t inPin, uint8_t outPin,
+	uint16_t setpoint)
+{
+	AD5592_ControlLoop *loop;
+	int i;
+
+	if(control->loops >= AD5592_CONTROL_LOOPS || inPin > 7 || outPin > 7 || inPin == outPin)
+	{
+		return NULL;
+	}
+	for(i = 0; i < control->loops; i++)
+	{
+		loop = &control->loop[i];
+		if(loop->outPin == outPin || loop->outPin == inPin || loop->inPin == outPin)
+		{
+			return NULL;
+		}
+	}
+	loop = &control->loop[control->loops];
+	memset(loop, 0, sizeof(*loop));
+	loop->inPin = inPin;
+	loop->outPin = outPin;
+	atomic_init(&loop->setpoint, setpoint);
+	return loop;
+}
+
+/**
+ * Add a loop with the built in PID.
+ * Parameters:
+ * 	control = engine
+ * 	inPin = ADC pin (0 to 7)
+ * 	outPin = DAC pin (0 to 7), not an input of any loop
+ * 	setpoint = millivolts
+ * 	kp, ki, kd = gains, Q16.16 per cycle
+ * Returns:
+ * 	Loop number, or -1 if there is no room or the pins clash
+ */
+int controlAddPid(AD5592_Control *control, uint8_t inPin, uint8_t outPin, uint16_t setpoint,
+	int32_t kp, int32_t ki, int32_t kd)
+{
+	AD5592_ControlLoop *loop = controlNewLoop(control, inPin, outPin, setpoint);
+
+	if(loop == NULL)
+	{
+		return -1;
+	}
+	loop->law = controlPid;
+	loop->kp = kp;
+	loop->ki = ki;
+	loop->kd = kd;
+	return control->loops++;
+}
+
+/**
+ * Add a loop with a user control law.
+ * Parameters:
+ * 	control = engine
+ * 	inPin = ADC pin (0 to 7)
+ * 	outPin = DAC pin (0 to 7), not an input of any loop
+ * 	setpoint = millivolts
+ * 	law = control law
+ * 	context = stored in the loop for the law
+ * Returns:
+ * 	Loop number, or -1 if there is no room or the pins clash
+ */
+int controlAddLaw(AD5592_Control *control, uint8_t inPin, uint8_t outPin, uint16_t setpoint,
+	AD5592_ControlLaw law, void *context)
+{
+	AD5592_ControlLoop *loop = controlNewLoop(control, inPin, outPin, setpoint);
+
+	if(loop == NULL)
+	{
+		return -1;
+	}
+	loop->law = law;
+	loop->context = context;
+	return control->loops++;
+}
+
+/**
+ * Change a setpoint.
+ * Parameters:
+ * 	control = engine
+ * 	loop = loop number
+ * 	setpoint = millivolts
+ */
+void controlSetpoint(AD5592_Control *control, int loop, uint16_t setpoint)
+{
+	atomic_store_explicit(&control->loop[loop].setpoint, setpoint, memory_order_relaxed);
+}
+
+/**
+ * The built in PID law.
+ * Parameters:
+ * 	loop = the loop and its gains
+ * 	input = input pin, millivolts
+ * 	setpoint = setpoint, millivolts
+ * Returns:
+ * 	Output pin, millivolts
+ */
+uint16_t controlPid(AD5592_ControlLoop *loop, uint16_t input, uint16_t setpoint)
+{
+	const int64_t top = (int64_t)AD5592_FULL_SCALE_MV * AD5592_CONTROL_ONE;
+	int32_t error = (int32_t)setpoint - input;
+	int64_t output;
+
+	/* Clamp the integral to the output range so it cannot wind up */
+	loop->integral += (int64_t)loop->ki * error;
+	if(loop->integral < 0)
+	{
+		loop->integral = 0;
+	}else if(loop->integral > top)
+	{
+		loop->integral = top;
+	}
+
+	/* Derivative on the input so setpoint steps do not kick */
+	output = (int64_t)loop->kp * error + loop->integral;
+	if(loop->primed)
+	{
+		output -= (int64_t)loop->kd * ((int32_t)input - loop->lastInput);
+	}
+	loop->lastInput = input;
+
+	if(output < 0)
+	{
+		return 0;
+	}
+	if(output > top)
+	{
+		return AD5592_FULL_SCALE_MV;
+	}
+	return (output + AD5592_CONTROL_ONE / 2) / AD5592_CONTROL_ONE;
+}
+
+/**
+ * Configure the pins and start the control thread.
+ * Parameters:
+ * 	control = engine
+ * 	priority = SCHED_FIFO priority, 1 to 99
+ * Returns:
+ * 	1 on success, 0 if the thread could not be started
+ */
+int controlStart(AD5592_Control *control, int priority)
+{
+	struct sched_param param;
+	pthread_attr_t attr;
+	uint8_t inPins = 0;
+	uint8_t outPins = 0;
+	int i;
+
+	for(i = 0; i < control->loops; i++)
+	{
+		inPins |= 0x1 << control->loop[i].inPin;
+		outPins |= 0x1 << control->loop[i].outPin;
+	}
+	deviceSetPinMode(control->dev, inPins, AD5592_MODE_ADC);
+	deviceSetPinMode(control->dev, outPins, AD5592_MODE_DAC);
+	deviceWrite(control->dev, AD5592_CNTRL_REG_READBACK | AD5592_LDAC_IMMEDIATE);
+
+	memset(&control->stats, 0, sizeof(control->stats));
+	control->stats.locked = controlLockMemory();
+	control->priority = priority;
+	atomic_store_explicit(&control->running, 1, memory_order_relaxed);
+
+	/* Ask for SCHED_FIFO and fall back to normal scheduling without the
+	 * privilege for it */
+	param.sched_priority = priority;
+	pthread_attr_init(&attr);
+	pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+	pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+	pthread_attr_setschedparam(&attr, &param);
+	control->stats.realtime = pthread_create(&control->thread, &attr, controlThread, control) == 0;
+	pthread_attr_destroy(&attr);
+	if(control->stats.realtime)
+	{
+		return 1;
+	}
+	if(pthread_create(&control->thread, NULL, controlThread, control) != 0)
+	{
+		atomic_store_explicit(&control->running, 0, memory_order_relaxed);
+		if(control->stats.locked)
+		{
+			controlUnlockMemory();
+			control->stats.locked = 0;
+		}
+		return 0;
+	}
+	return 1;
+}
+
+/**
+ * Stop the control thread.
+ * Parameters:
+ * 	control = engine
+ */
+void controlStop(AD5592_Control *control)
+{
+	atomic_store_explicit(&control->running, 0, memory_order_relaxed);
+	pthread_join(control->thread, NULL);
+	if(control->stats.locked)
+	{
+		controlUnlockMemory();
+	}
+}
+
+/**
+ * Print the timing of a stopped engine.
+ * Parameters:
+ * 	control = engine
+ * 	out = stream to print to
+ */
+void controlReport(AD5592_Control *control, FILE *out)
+{
+	AD5592_ControlStats *stats = &control->stats;
+	int i;
+
+	fprintf(out, "period %u us, %s, memory %s\n", control->periodUs,
+		stats->realtime ? "SCHED_FIFO" : "not real time", stats->locked ? "locked" : "not locked");
+	fprintf(out, "cycles %llu misses %llu skipped %llu failed %llu longest cycle %llu us\n",
+		(unsigned long long)stats->cycles, (unsigned long long)stats->misses,
+		(unsigned long long)stats->skipped, (unsigned long long)stats->failed,
+		(unsigned long long)stats->cycleMaxNs / 1000);
+	if(stats->cycles == 0)
+	{
+		return;
+	}
+	fprintf(out, "wake latency min %llu mean %llu max %llu ns\n",
+		(unsigned long long)stats->wakeMinNs,
+		(unsigned long long)(stats->wakeTotalNs / stats->cycles),
+		(unsigned long long)stats->wakeMaxNs);
+	for(i = 0; i < AD5592_CONTROL_BUCKETS; i++)
+	{
+		if(stats->wakeUs[i])
+		{
+			fprintf(out, "%6u-%-6u us %10u\n", i ? 1u << i : 0u, (2u << i) - 1, stats->wakeUs[i]);
+		}
+	}
+}
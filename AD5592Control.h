@@ -0,0 +1,210 @@
+/*********************************************************************
+ * File: AD5592Control.h
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Fixed rate closed loop control, ADC in to DAC out
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Pipe.h v1.1.0
+ * 		-pthread
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- Cycles whose transfer failed are counted in stats.failed and
+ * 			run no law.
+ * 		- The memory lock is shared by every running engine.
+ *
+ * A control thread runs every loop of one board at a fixed period. Each
+ * cycle is one SPI transfer, built with an AD5592_Pipe: an ADC sequence
+ * read of every input pin, with the DAC writes of the outputs worked out
+ * in the cycle before filling the frames between the conversions. The
+ * control laws then run on the new inputs and their outputs go out in
+ * the next cycle's transfer. The loop delay is therefore one period,
+ * the same every cycle, and pins are only configured at controlStart().
+ *
+ * The thread asks for SCHED_FIFO at the priority given and locks all
+ * memory with mlockall(). Both need root or CAP_SYS_NICE and
+ * CAP_IPC_LOCK; without them the loop still runs and the stats say so.
+ * The lock is shared by every running engine and only the last
+ * controlStop() calls munlockall().
+ *
+ * A cycle whose transfer fails does not run the laws, since the inputs
+ * were not read. No output is written until the laws have run on the
+ * inputs of a good cycle, so the DACs hold their last good values.
+ * Cycles start on absolute CLOCK_MONOTONIC deadlines so the time spent
+ * in a cycle does not stretch the period. A cycle that ends after the
+ * next deadline is a miss and the deadlines it overran are skipped, not
+ * run late.
+ *
+ * Control laws work in millivolts with integer math. controlAddPid()
+ * adds the built in PID. Its gains are Q16.16 fixed point per cycle:
+ * 	output = kp x error + sum(ki x error) - kd x (input - last input)
+ * with the integral clamped to the output range.
+ *
+ * The control thread owns the board from controlStart() to
+ * controlStop(). Nothing else may use the board or its chip select in
+ * that time.
+ **********************************************************************/
+
+#ifndef SOURCES_AD5592CONTROL_H_
+#define SOURCES_AD5592CONTROL_H_
+
+#include <stdio.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "AD5592RPI.h"
+#include "AD5592Pipe.h"
+
+#define AD5592_CONTROL_LOOPS		8		/* Most loops on one board */
+#define AD5592_CONTROL_BUCKETS		16		/* Wake latency buckets, bucket n holds 2^n to 2^(n+1) - 1 us */
+#define AD5592_CONTROL_ONE			65536	/* 1.0 in Q16.16 */
+
+typedef struct AD5592_ControlLoop AD5592_ControlLoop;
+
+/**
+ * A control law. Called on the control thread once a cycle.
+ * Parameters:
+ * 	loop = the loop, with its context
+ * 	input = input pin, millivolts
+ * 	setpoint = setpoint, millivolts
+ * Returns:
+ * 	Output pin, millivolts
+ */
+typedef uint16_t (*AD5592_ControlLaw)(AD5592_ControlLoop *loop, uint16_t input, uint16_t setpoint);
+
+/**
+ * One loop from an input pin to an output pin.
+ */
+struct AD5592_ControlLoop
+{
+	uint8_t inPin;					/* ADC pin */
+	uint8_t outPin;					/* DAC pin */
+	AD5592_ControlLaw law;			/* Control law */
+	void *context;					/* For a user law */
+	atomic_uint setpoint;			/* Millivolts */
+	int32_t kp;						/* PID gains, Q16.16 per cycle */
+	int32_t ki;
+	int32_t kd;
+	int64_t integral;				/* PID integral, Q16.16 millivolts */
+	uint16_t lastInput;				/* Input of the cycle before */
+	uint16_t output;				/* Output to write next cycle */
+	uint8_t primed;					/* Output holds a value */
+};
+
+/**
+ * Timing of the control thread.
+ */
+typedef struct
+{
+	uint64_t cycles;							/* Cycles run */
+	uint64_t misses;							/* Cycles that ended after the next deadline */
+	uint64_t failed;							/* Cycles whose transfer failed */
+	uint64_t skipped;							/* Deadlines skipped after misses */
+	uint64_t wakeMinNs;							/* Least wake up latency */
+	uint64_t wakeMaxNs;							/* Most wake up latency */
+	uint64_t wakeTotalNs;						/* Sum of wake up latencies */
+	uint64_t cycleMaxNs;						/* Longest transfer and compute */
+	uint32_t wakeUs[AD5592_CONTROL_BUCKETS];	/* Wake up latency histogram */
+	uint8_t realtime;							/* 1 if SCHED_FIFO was granted */
+	uint8_t locked;								/* 1 if mlockall() succeeded */
+} AD5592_ControlStats;
+
+/**
+ * A control engine for one board.
+ */
+typedef struct
+{
+	AD5592_Device *dev;							/* Board */
+	uint32_t periodUs;							/* Cycle period */
+	int priority;								/* SCHED_FIFO priority */
+	AD5592_ControlLoop loop[AD5592_CONTROL_LOOPS];	/* Loops */
+	int loops;									/* Loops in use */
+	AD5592_Pipe pipe;							/* Transfer of each cycle */
+	uint16_t input[8];							/* Inputs by pin, millivolts */
+	AD5592_ControlStats stats;					/* Written by the control thread */
+	atomic_int running;							/* Cleared to stop the thread */
+	pthread_t thread;							/* Control thread */
+} AD5592_Control;
+
+/**
+ * Set up a control engine with no loops.
+ * Parameters:
+ * 	control = engine to set up
+ * 	dev = board
+ * 	periodUs = cycle period
+ */
+void controlInit(AD5592_Control *control, AD5592_Device *dev, uint32_t periodUs);
+
+/**
+ * Add a loop with the built in PID. Call before controlStart().
+ * Parameters:
+ * 	control = engine
+ * 	inPin = ADC pin (0 to 7)
+ * 	outPin = DAC pin (0 to 7), not an input of any loop
+ * 	setpoint = millivolts
+ * 	kp, ki, kd = gains, Q16.16 per cycle
+ * Returns:
+ * 	Loop number, or -1 if there is no room or the pins clash
+ */
+int controlAddPid(AD5592_Control *control, uint8_t inPin, uint8_t outPin, uint16_t setpoint,
+	int32_t kp, int32_t ki, int32_t kd);
+
+/**
+ * Add a loop with a user control law. Call before controlStart().
+ * Parameters:
+ * 	control = engine
+ * 	inPin = ADC pin (0 to 7)
+ * 	outPin = DAC pin (0 to 7), not an input of any loop
+ * 	setpoint = millivolts
+ * 	law = control law
+ * 	context = stored in the loop for the law
+ * Returns:
+ * 	Loop number, or -1 if there is no room or the pins clash
+ */
+int controlAddLaw(AD5592_Control *control, uint8_t inPin, uint8_t outPin, uint16_t setpoint,
+	AD5592_ControlLaw law, void *context);
+
+/**
+ * Change a setpoint. May be called from any thread while the engine
+ * runs. Takes effect at the next cycle.
+ * Parameters:
+ * 	control = engine
+ * 	loop = loop number
+ * 	setpoint = millivolts
+ */
+void controlSetpoint(AD5592_Control *control, int loop, uint16_t setpoint);
+
+/**
+ * Configure the pins and start the control thread.
+ * Parameters:
+ * 	control = engine
+ * 	priority = SCHED_FIFO priority, 1 to 99
+ * Returns:
+ * 	1 on success, 0 if the thread could not be started
+ */
+int controlStart(AD5592_Control *control, int priority);
+
+/**
+ * Stop the control thread. The outputs keep their last values.
+ * Parameters:
+ * 	control = engine
+ */
+void controlStop(AD5592_Control *control);
+
+/**
+ * The built in PID law. Exposed so a user law can wrap it.
+ */
+uint16_t controlPid(AD5592_ControlLoop *loop, uint16_t input, uint16_t setpoint);
+
+/**
+ * Print the timing of a stopped engine.
+ * Parameters:
+ * 	control = engine
+ * 	out = stream to print to
+ */
+void controlReport(AD5592_Control *control, FILE *out);
+
+#endif /* SOURCES_AD5592CONTROL_H_ */
@@ -0,0 +1,261 @@
+/**
+ * File: AD5592ControlBench.c
+ * Target: Raspberry Pi or any Linux host
+ * Function: Closed loop timing and failure handling of an AD5592_Control
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Control.h v1.0.1
+ * 		-AD5592Sim.h v1.2.1
+ * 		-AD5592Clock.h v1.0.0
+ * 		-pthread
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version: 1.0.0:
+ * 		-Usage: AD5592ControlBench [-m ms] [-p us per cycle] [-r priority]
+ * 			[-e fail every nth transfer]
+ *
+ * 		-Runs two PI loops on a simulated board for -m ms (2000 by
+ * 		default) at -p us a cycle (1000 by default), asking for
+ * 		SCHED_FIFO priority -r (10 by default). With -e every nth
+ * 		transfer fails without reaching the board. An output is only
+ * 		written by the cycle after a good one, so -e 2 writes none.
+ *
+ * 		-Each loop drives a DAC pin into a first order plant whose
+ * 		output is the loop's ADC pin: half the DAC voltage, lagged with
+ * 		a time constant of 10 ms or 30 ms. The plant is worked out from
+ * 		the time at each transfer, on the control thread, so nothing
+ * 		else touches the simulator. Halfway through the run both
+ * 		setpoints step.
+ *
+ * 		-Prints the controlReport() of the engine, then:
+ * 			failed injected written_after_fail
+ * 		and one line per loop:
+ * 			loop tau_ms setpoint input_mv settle_ms
+ * 		written_after_fail counts DAC writes sent in the transfer after a
+ * 		failed one, before any law has run on good inputs. settle_ms is
+ * 		the time from the setpoint step until the input stays within
+ * 		BENCH_TOLERANCE_MV of it. Exits with 1 if a loop has not settled
+ * 		by the end, if failed is not injected, or if any output was
+ * 		written after a failure.
+ *
+ * 		-Builds on a Linux host with:
+ * 			gcc -O2 -DAD5592_NO_BCM2835 -o AD5592ControlBench \
+ * 				AD5592ControlBench.c AD5592Control.c AD5592Pipe.c \
+ * 				AD5592RPI.c AD5592Batch.c AD5592Timing.c \
+ * 				AD5592Transport.c AD5592Sim.c -lm -lpthread
+ * 		Run as root for SCHED_FIFO and locked memory.
+ *
+ **********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include "AD5592RPI.h"
+#include "AD5592Control.h"
+#include "AD5592Sim.h"
+#include "AD5592Clock.h"
+
+#define BENCH_LOOPS				2		/* Loops run */
+#define BENCH_TOLERANCE_MV		10		/* Settled band around the setpoint */
+
+/**
+ * One plant and what it did.
+ */
+typedef struct
+{
+	uint8_t inPin;			/* ADC pin, the plant output */
+	uint8_t outPin;			/* DAC pin, the plant input */
+	double tauMs;			/* Time constant */
+	uint16_t setpoint[2];	/* Setpoints before and after the step */
+	double milivolts;		/* Plant output */
+	uint16_t lastSetpoint;	/* Setpoint seen at the last transfer */
+	uint64_t stepNs;		/* Time the setpoint last changed */
+	uint64_t outsideNs;		/* Last time the output was outside the band */
+} BenchPlant;
+
+BenchPlant plant[BENCH_LOOPS] =
+{
+	{0, 4, 10.0, {1000, 2000}, 0.0, 0, 0, 0},
+	{1, 5, 30.0, {1500, 1000}, 0.0, 0, 0, 0},
+};
+
+AD5592_Sim sim;
+AD5592_Transport simBus;			/* Simulator transport */
+AD5592_Transport plantBus;			/* Transport that runs the plants, the engine uses it */
+AD5592_Device dev;
+AD5592_Control control;
+uint64_t lastNs;					/* Time of the last transfer */
+uint32_t failEvery = 0;				/* Every nth transfer fails, 0 for none */
+uint32_t transfers = 0;				/* Transfers since failures were armed */
+uint32_t injected = 0;				/* Transfers made to fail */
+uint32_t writtenAfterFail = 0;		/* DAC writes sent right after a failure */
+int lastFailed = 0;					/* The last transfer failed */
+atomic_int armed;					/* Set once the engine has set up the board */
+
+/**
+ * Move the plants on to this time and apply their outputs to the ADC
+ * pins.
+ */
+static void benchPlants(uint64_t nowNs)
+{
+	BenchPlant *p;
+	double target;
+	double error;
+	uint16_t setpoint;
+	int i;
+
+	for(i = 0; i < BENCH_LOOPS; i++)
+	{
+		p = &plant[i];
+		target = simPinVoltage(&sim, 0, p->outPin) / 2.0;
+		p->milivolts = target + (p->milivolts - target) *
+			exp(-(double)(nowNs - lastNs) / (p->tauMs * 1e6));
+		simSetInput(&sim, 0, p->inPin, (uint16_t)(p->milivolts + 0.5));
+
+		setpoint = atomic_load_explicit(&control.loop[i].setpoint, memory_order_relaxed);
+		if(setpoint != p->lastSetpoint)
+		{
+			p->lastSetpoint = setpoint;
+			p->stepNs = nowNs;
+		}
+		error = p->milivolts - setpoint;
+		if(error > BENCH_TOLERANCE_MV || error < -BENCH_TOLERANCE_MV)
+		{
+			p->outsideNs = nowNs;
+		}
+	}
+	lastNs = nowNs;
+}
+
+/**
+ * Run the plants, then transfer on the simulator. Every failEvery-th
+ * transfer fails instead. Only the control thread transfers once
+ * failures are armed.
+ */
+static int plantTransfer(AD5592_Transport *bus, uint8_t cs, const char txBuf[],
+	char rxBuf[], int frames)
+{
+	AD5592_Transport *inner = bus->context;
+	int i;
+
+	benchPlants(clockNowNs());
+	if(atomic_load_explicit(&armed, memory_order_relaxed))
+	{
+		if(failEvery && ++transfers % failEvery == 0)
+		{
+			injected++;
+			lastFailed = 1;
+			return 0;
+		}
+		/* Outputs must hold until a law has run on good inputs */
+		for(i = 0; lastFailed && i < frames; i++)
+		{
+			writtenAfterFail += (txBuf[2 * i] & 0x80) != 0;
+		}
+		lastFailed = 0;
+	}
+	return transportTransfer(inner, cs, txBuf, rxBuf, frames);
+}
+
+int main(int argc, char **argv)
+{
+	long ms = 2000;
+	long periodUs = 1000;
+	int priority = 10;
+	uint64_t endNs;
+	struct timespec wait;
+	BenchPlant *p;
+	int bad = 0;
+	int settled;
+	int option;
+	int i;
+
+	while((option = getopt(argc, argv, "m:p:r:e:")) != -1)
+	{
+		switch(option)
+		{
+			case 'm':
+				ms = atol(optarg);
+				break;
+			case 'p':
+				periodUs = atol(optarg);
+				break;
+			case 'r':
+				priority = atoi(optarg);
+				break;
+			case 'e':
+				failEvery = atoi(optarg);
+				break;
+			default:
+				ms = 0;
+				break;
+		}
+	}
+	if(ms < 2 || periodUs < 1 || priority < 1 || priority > 99 || failEvery == 1)
+	{
+		printf("Usage: %s [-m ms] [-p us per cycle] [-r priority, 1 to 99]"
+			" [-e fail every nth transfer, 2 or more]\n", argv[0]);
+		return 1;
+	}
+
+	simInit(&sim, 0);
+	simTransportInit(&simBus, &sim);
+	memset(&plantBus, 0, sizeof(plantBus));
+	plantBus.transfer = plantTransfer;
+	plantBus.context = &simBus;
+	deviceInit(&dev, &plantBus, 0);
+	atomic_init(&armed, 0);
+	lastNs = clockNowNs();
+
+	/* Per cycle gains: the plant halves the output and lags it by tens
+	 * of cycles */
+	controlInit(&control, &dev, periodUs);
+	for(i = 0; i < BENCH_LOOPS; i++)
+	{
+		controlAddPid(&control, plant[i].inPin, plant[i].outPin, plant[i].setpoint[0],
+			AD5592_CONTROL_ONE, AD5592_CONTROL_ONE / 10, 0);
+	}
+	if(!controlStart(&control, priority))
+	{
+		printf("Could not start the control thread\n");
+		return 1;
+	}
+	atomic_store_explicit(&armed, 1, memory_order_relaxed);
+
+	wait.tv_sec = ms / 2000;
+	wait.tv_nsec = (ms / 2 % 1000) * 1000000;
+	nanosleep(&wait, NULL);
+	for(i = 0; i < BENCH_LOOPS; i++)
+	{
+		controlSetpoint(&control, i, plant[i].setpoint[1]);
+	}
+	nanosleep(&wait, NULL);
+	controlStop(&control);
+	endNs = lastNs;
+
+	controlReport(&control, stdout);
+	printf("failed injected written_after_fail\n");
+	printf("%llu %u %u\n", (unsigned long long)control.stats.failed, injected, writtenAfterFail);
+	printf("loop tau_ms setpoint input_mv settle_ms\n");
+	for(i = 0; i < BENCH_LOOPS; i++)
+	{
+		p = &plant[i];
+		/* Settled if the output stayed in the band for the last tenth of the run */
+		settled = p->outsideNs < endNs - (endNs - p->stepNs) / 10;
+		printf("%d %.0f %u %.0f ", i, p->tauMs, p->lastSetpoint, p->milivolts);
+		if(settled)
+		{
+			printf("%.1f\n", p->outsideNs > p->stepNs ? (p->outsideNs - p->stepNs) / 1e6 : 0.0);
+		}else
+		{
+			printf("not settled\n");
+		}
+		bad += !settled;
+	}
+	return bad || control.stats.failed != injected || writtenAfterFail ? 1 : 0;
+}
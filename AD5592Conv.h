@@ -0,0 +1,103 @@
+/*********************************************************************
+ * File: AD5592Conv.h
+ * Target: Any
+ * Function: Millivolt and count conversions for the AD5592 ADC and DAC
+ * Dependancies:
+ * 		-none
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release. Replaces the float conversions in a2d() and
+ * 			d2a().
+ *
+ * The range is fixed at compile time. Define AD5592_VREF_MV and
+ * AD5592_GAIN before including this file or on the command line to
+ * change it:
+ * 	-DAD5592_VREF_MV=2500	internal reference
+ * 	-DAD5592_VREF_MV=5000	5V reference on the Snack board (default)
+ * 	-DAD5592_GAIN=2			ADC and DAC range of 2 x Vref
+ *
+ * Both directions round to nearest with integer math only:
+ * 	count = mv * 4096 / full scale, clamped to 4095
+ * 	mv = count * full scale / 4096
+ * Millivolts to counts is a multiply by a 2^28 scaled reciprocal and a
+ * shift. Up to full scale the reciprocal error stays below
+ * full scale / 2^29, which is less than the 1 / (2 x full scale) an
+ * exact result can sit from a rounding boundary, so the result is
+ * exact. Inputs past full scale clamp.
+ * The AD5592_MV_TO_COUNT() and AD5592_COUNT_TO_MV() forms are constant
+ * expressions so constant setpoints fold to literal counts.
+ **********************************************************************/
+
+#ifndef SOURCES_AD5592CONV_H_
+#define SOURCES_AD5592CONV_H_
+
+#include <stdint.h>
+
+#ifndef AD5592_VREF_MV
+#define AD5592_VREF_MV		5000	/* Reference voltage */
+#endif
+
+#ifndef AD5592_GAIN
+#define AD5592_GAIN			1		/* 1 for 0 to Vref, 2 for 0 to 2 x Vref */
+#endif
+
+#define AD5592_FULL_SCALE_MV	(AD5592_VREF_MV * AD5592_GAIN)	/* Voltage of count 4096 */
+#define AD5592_COUNT_MAX		0x0FFF							/* Largest 12 bit count */
+
+_Static_assert(AD5592_GAIN == 1 || AD5592_GAIN == 2, "AD5592_GAIN must be 1 or 2");
+_Static_assert(AD5592_VREF_MV >= 1000 && AD5592_VREF_MV <= 5500,
+	"AD5592_VREF_MV is outside the AD5592 reference range");
+
+/**
+ * Constant expression conversions for any full scale.
+ * Parameters:
+ * 	mv or count = value to convert
+ * 	fullScale = voltage of count 4096 in millivolts
+ */
+#define AD5592_MV_TO_COUNT_FS(mv, fullScale)									\
+	((((uint32_t)(mv) * 4096u + (fullScale) / 2) / (fullScale)) > AD5592_COUNT_MAX ?	\
+	AD5592_COUNT_MAX : (((uint32_t)(mv) * 4096u + (fullScale) / 2) / (fullScale)))
+#define AD5592_COUNT_TO_MV_FS(count, fullScale)								\
+	(((uint32_t)(count) * (fullScale) + 2048u) >> 12)
+
+/**
+ * Constant expression conversions for the compiled in range.
+ */
+#define AD5592_MV_TO_COUNT(mv)		AD5592_MV_TO_COUNT_FS(mv, AD5592_FULL_SCALE_MV)
+#define AD5592_COUNT_TO_MV(count)	AD5592_COUNT_TO_MV_FS(count, AD5592_FULL_SCALE_MV)
+
+/**
+ * Reciprocal of the full scale for the multiply and shift.
+ */
+#define AD5592_CONV_SHIFT	28
+#define AD5592_CONV_MULT	(((4096ull << AD5592_CONV_SHIFT) + AD5592_FULL_SCALE_MV / 2) / AD5592_FULL_SCALE_MV)
+
+_Static_assert(AD5592_CONV_MULT <= 0xFFFFFFFFull, "AD5592_CONV_MULT must fit 32 bits");
+
+/**
+ * Convert millivolts to a 12 bit count.
+ * Parameter: millivolts
+ * Returns: count, rounded to nearest and clamped to 4095
+ */
+static inline uint16_t ad5592MvToCount(uint16_t millivolts)
+{
+	uint32_t count = ((uint64_t)millivolts * (uint32_t)AD5592_CONV_MULT +
+		(1u << (AD5592_CONV_SHIFT - 1))) >> AD5592_CONV_SHIFT;
+
+	return count > AD5592_COUNT_MAX ? AD5592_COUNT_MAX : count;
+}
+
+/**
+ * Convert a 12 bit count to millivolts.
+ * Parameter: count
+ * Returns: millivolts, rounded to nearest
+ */
+static inline uint16_t ad5592CountToMv(uint16_t count)
+{
+	return AD5592_COUNT_TO_MV(count & AD5592_COUNT_MAX);
+}
+
+#endif /* SOURCES_AD5592CONV_H_ */
@@ -0,0 +1,212 @@
+/***********************************************************************
+ * File: AD5592Coro.c
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Coroutine scripts for AD5592 boards on one thread
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Pipe.h v1.0.1
+ * 		-AD5592Timing.h v1.0.0
+ * 		-AD5592Coro.h
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- Scripts stopped with AD5592_CORO_ERROR are dropped and counted
+ * 			in errors. coroSetPinMode() returns 0 for a board with no
+ * 			pipe.
+ **********************************************************************/
+
+#include <stddef.h>
+#include "AD5592Coro.h"
+
+/**
+ * Set up an empty scheduler.
+ * Parameters:
+ * 	sched = scheduler
+ */
+void coroSchedInit(AD5592_CoroSched *sched)
+{
+	sched->boards = 0;
+	sched->coros = 0;
+	sched->passes = 0;
+	sched->flushes = 0;
+	sched->errors = 0;
+}
+
+/**
+ * Add a script to a scheduler.
+ * Parameters:
+ * 	sched = scheduler
+ * 	co = script state, must stay put until the script is done
+ * 	fn = script
+ * 	ctx = passed to the script as co->ctx
+ * Returns:
+ * 	1 on success, 0 if the scheduler is full
+ */
+int coroSpawn(AD5592_CoroSched *sched, AD5592_Coro *co, int (*fn)(AD5592_Coro *co),
+	void *ctx)
+{
+	if(sched->coros == AD5592_CORO_MAX)
+	{
+		return 0;
+	}
+	co->line = 0;
+	co->state = AD5592_CORO_READY;
+	co->waitUs = 0;
+	co->wakeNs = 0;
+	co->fn = fn;
+	co->ctx = ctx;
+	co->sched = sched;
+	sched->coro[sched->coros++] = co;
+	return 1;
+}
+
+/**
+ * Get the pipe a script queues commands for a board in.
+ * Parameters:
+ * 	co = script
+ * 	dev = board
+ * Returns:
+ * 	Pipe, or NULL if the scheduler already drives AD5592_CORO_BOARDS
+ * 	other boards
+ */
+AD5592_Pipe *coroPipe(AD5592_Coro *co, AD5592_Device *dev)
+{
+	AD5592_CoroSched *sched = co->sched;
+	int i;
+
+	for(i = 0; i < sched->boards; i++)
+	{
+		if(sched->dev[i] == dev)
+		{
+			return &sched->pipe[i];
+		}
+	}
+	if(sched->boards == AD5592_CORO_BOARDS)
+	{
+		return NULL;
+	}
+	sched->dev[i] = dev;
+	pipeInit(&sched->pipe[i], dev);
+	sched->boards++;
+	return &sched->pipe[i];
+}
+
+/**
+ * Queue the writes that put pins into a mode.
+ * Parameters:
+ * 	co = script
+ * 	dev = board
+ * 	pins = pins as bit mask
+ * 	mode = AD5592_MODE_ flags
+ * Returns:
+ * 	1 on success, 0 if the scheduler has no pipe for the board
+ */
+int coroSetPinMode(AD5592_Coro *co, AD5592_Device *dev, uint8_t pins, uint8_t mode)
+{
+	AD5592_Pipe *pipe = coroPipe(co, dev);
+	AD5592_WORD words[AD5592_MODE_COUNT];
+	int count;
+	int i;
+
+	if(pipe == NULL)
+	{
+		return 0;
+	}
+	count = devicePinModeWords(dev, pins, mode, words);
+	for(i = 0; i < count; i++)
+	{
+		pipeWrite(pipe, words[i]);
+	}
+	return 1;
+}
+
+/**
+ * Run every script until all are done.
+ * Parameters:
+ * 	sched = scheduler
+ */
+void coroRun(AD5592_CoroSched *sched)
+{
+	AD5592_Coro *co;
+	uint64_t now;
+	uint64_t first;
+	int ready;
+	int i;
+
+	while(sched->coros > 0)
+	{
+		/* Run every ready script until it waits */
+		for(i = 0; i < sched->coros; i++)
+		{
+			co = sched->coro[i];
+			if(co->state == AD5592_CORO_READY)
+			{
+				co->state = co->fn(co);
+			}
+		}
+		sched->passes++;
+
+		/* One transfer per board for everything the scripts queued */
+		for(i = 0; i < sched->boards; i++)
+		{
+			if(sched->pipe[i].count > 0)
+			{
+				pipeFlush(&sched->pipe[i]);
+				sched->flushes++;
+			}
+		}
+		now = clockNowNs();
+
+		/* Drop finished scripts and start settle times */
+		ready = 0;
+		first = UINT64_MAX;
+		for(i = 0; i < sched->coros; i++)
+		{
+			co = sched->coro[i];
+			if(co->state == AD5592_CORO_DONE || co->state == AD5592_CORO_ERROR)
+			{
+				sched->errors += co->state == AD5592_CORO_ERROR;
+				sched->coro[i--] = sched->coro[--sched->coros];
+				continue;
+			}
+			if(co->state == AD5592_CORO_BUS)
+			{
+				co->state = AD5592_CORO_READY;
+			}else if(co->state == AD5592_CORO_SLEEP && co->waitUs)
+			{
+				co->wakeNs = now + (uint64_t)co->waitUs * 1000;
+				co->waitUs = 0;
+			}
+			if(co->state == AD5592_CORO_SLEEP)
+			{
+				if(co->wakeNs <= now)
+				{
+					co->state = AD5592_CORO_READY;
+				}else if(co->wakeNs < first)
+				{
+					first = co->wakeNs;
+				}
+			}
+			ready |= co->state == AD5592_CORO_READY;
+		}
+
+		/* Every script is settling, sleep until the first is due */
+		if(!ready && first != UINT64_MAX)
+		{
+			timingWaitUs((first - now + 999) / 1000);
+			now = clockNowNs();
+			for(i = 0; i < sched->coros; i++)
+			{
+				co = sched->coro[i];
+				if(co->state == AD5592_CORO_SLEEP && co->wakeNs <= now)
+				{
+					co->state = AD5592_CORO_READY;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,222 @@
+/*********************************************************************
+ * File: AD5592Coro.h
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Coroutine scripts for AD5592 boards on one thread
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Pipe.h v1.0.1
+ * 		-AD5592Timing.h v1.0.0
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- The AD5592_CORO_ command macros stop the script with
+ * 			AD5592_CORO_ERROR when the scheduler has no pipe left for
+ * 			its board, instead of using a NULL pipe.
+ *
+ * A script is a function written between AD5592_CORO_BEGIN() and
+ * AD5592_CORO_END() that waits with the AD5592_CORO_ macros instead of
+ * blocking. Many scripts on many boards run on one thread:
+ *
+ * 	int blink(AD5592_Coro *co)
+ * 	{
+ * 		Blink *b = co->ctx;
+ *
+ * 		AD5592_CORO_BEGIN(co);
+ * 		AD5592_CORO_SET_MODE(co, b->dev, 0x01, AD5592_MODE_GPIO_OUT);
+ * 		for(b->i = 0; b->i < 10; b->i++)
+ * 		{
+ * 			AD5592_CORO_WRITE_GPIO(co, b->dev, 0x01, b->i & 0x1);
+ * 			AD5592_CORO_SETTLE(co, 500);
+ * 		}
+ * 		AD5592_CORO_END(co);
+ * 	}
+ *
+ * The scheduler runs every ready script until it waits. Commands go in
+ * a pipe per board, so the commands of every script on a board share
+ * one transfer. Then each pipe is flushed, scripts waiting on the bus
+ * are ready again and settle times start counting. While every script
+ * is settling the thread sleeps until the first one is due.
+ *
+ * A script resumes at a switch label, so local variables do not keep
+ * their values across a wait. Keep them in ctx. A wait may not be used
+ * inside a switch statement of the script.
+ *
+ * A scheduler drives up to AD5592_CORO_BOARDS boards, taken in the order
+ * the scripts first use them. A script that uses one more stops with
+ * AD5592_CORO_ERROR and is counted in errors; the others carry on.
+ **********************************************************************/
+
+#ifndef SOURCES_AD5592CORO_H_
+#define SOURCES_AD5592CORO_H_
+
+#include "AD5592Pipe.h"
+#include "AD5592Timing.h"
+
+#define AD5592_CORO_BOARDS	4		/* Boards one scheduler can drive */
+#define AD5592_CORO_MAX		64		/* Scripts one scheduler can run */
+
+/**
+ * Script states, also returned by the script function.
+ */
+#define AD5592_CORO_READY	0	/* Runs in the next pass */
+#define AD5592_CORO_BUS		1	/* Waits for its commands to be sent */
+#define AD5592_CORO_SLEEP	2	/* Waits for its commands, then for waitUs */
+#define AD5592_CORO_DONE	3	/* Finished */
+#define AD5592_CORO_ERROR	4	/* Stopped, it used more boards than the scheduler drives */
+
+typedef struct AD5592_Coro AD5592_Coro;
+typedef struct AD5592_CoroSched AD5592_CoroSched;
+
+/**
+ * One script.
+ */
+struct AD5592_Coro
+{
+	int line;							/* Resume point, 0 to start */
+	uint8_t state;						/* AD5592_CORO_ */
+	uint32_t waitUs;					/* Settle time asked for */
+	uint64_t wakeNs;					/* End of the settle time */
+	int (*fn)(AD5592_Coro *co);			/* Script */
+	void *ctx;							/* Script state kept across waits */
+	AD5592_CoroSched *sched;			/* Scheduler running the script */
+};
+
+/**
+ * A scheduler.
+ */
+struct AD5592_CoroSched
+{
+	AD5592_Device *dev[AD5592_CORO_BOARDS];		/* Boards in use */
+	AD5592_Pipe pipe[AD5592_CORO_BOARDS];		/* Pipe of each board */
+	int boards;									/* Boards in use */
+	AD5592_Coro *coro[AD5592_CORO_MAX];			/* Scripts */
+	int coros;									/* Scripts not done */
+	uint32_t passes;							/* Passes over the ready scripts */
+	uint32_t flushes;							/* Pipe flushes */
+	uint32_t errors;							/* Scripts stopped with AD5592_CORO_ERROR */
+};
+
+/**
+ * Start a script. Return AD5592_CORO_DONE from it to stop early.
+ */
+#define AD5592_CORO_BEGIN(co)		switch((co)->line) { case 0:
+
+/**
+ * End a script.
+ */
+#define AD5592_CORO_END(co)			} (co)->line = -1; return AD5592_CORO_DONE
+
+/**
+ * Wait until the commands queued so far are sent and their results
+ * stored.
+ */
+#define AD5592_CORO_SYNC(co) \
+	do { (co)->line = __LINE__; return AD5592_CORO_BUS; case __LINE__:; } while(0)
+
+/**
+ * Wait until the commands queued so far are sent, then for us
+ * microseconds.
+ */
+#define AD5592_CORO_SETTLE(co, us) \
+	do { (co)->waitUs = (us); (co)->line = __LINE__; return AD5592_CORO_SLEEP; \
+		case __LINE__:; } while(0)
+
+/**
+ * Stop the script with AD5592_CORO_ERROR if the scheduler has no pipe
+ * for the board.
+ */
+#define AD5592_CORO_BOARD(co, dev) \
+	do { if(coroPipe((co), (dev)) == NULL) { (co)->line = -1; return AD5592_CORO_ERROR; } } while(0)
+
+/**
+ * Read ADC pins into milivolts[], indexed by pin number.
+ */
+#define AD5592_CORO_READ_ADC(co, dev, pins, milivolts) \
+	do { AD5592_CORO_BOARD(co, dev); \
+		pipeGetAnalogIn(coroPipe((co), (dev)), (pins), (milivolts)); \
+		AD5592_CORO_SYNC(co); } while(0)
+
+/**
+ * Read GPIO input pins into *states.
+ */
+#define AD5592_CORO_READ_GPIO(co, dev, pins, states) \
+	do { AD5592_CORO_BOARD(co, dev); \
+		pipeGetDigitalIn(coroPipe((co), (dev)), (pins), (states)); \
+		AD5592_CORO_SYNC(co); } while(0)
+
+/**
+ * Queue a DAC write. Does not wait.
+ */
+#define AD5592_CORO_WRITE_DAC(co, dev, pin, milivolts) \
+	do { AD5592_CORO_BOARD(co, dev); \
+		pipeSetAnalogOut(coroPipe((co), (dev)), (pin), (milivolts)); } while(0)
+
+/**
+ * Queue a GPIO data write. Does not wait.
+ */
+#define AD5592_CORO_WRITE_GPIO(co, dev, pins, states) \
+	do { AD5592_CORO_BOARD(co, dev); \
+		pipeSetDigitalOut(coroPipe((co), (dev)), (pins), (states)); } while(0)
+
+/**
+ * Queue a pin mode change. Does not wait.
+ */
+#define AD5592_CORO_SET_MODE(co, dev, pins, mode) \
+	do { AD5592_CORO_BOARD(co, dev); \
+		coroSetPinMode((co), (dev), (pins), (mode)); } while(0)
+
+/**
+ * Set up an empty scheduler.
+ * Parameters:
+ * 	sched = scheduler
+ */
+void coroSchedInit(AD5592_CoroSched *sched);
+
+/**
+ * Add a script to a scheduler.
+ * Parameters:
+ * 	sched = scheduler
+ * 	co = script state, must stay put until the script is done
+ * 	fn = script
+ * 	ctx = passed to the script as co->ctx
+ * Returns:
+ * 	1 on success, 0 if the scheduler is full
+ */
+int coroSpawn(AD5592_CoroSched *sched, AD5592_Coro *co, int (*fn)(AD5592_Coro *co),
+	void *ctx);
+
+/**
+ * Get the pipe a script queues commands for a board in.
+ * Parameters:
+ * 	co = script
+ * 	dev = board
+ * Returns:
+ * 	Pipe, or NULL if the scheduler already drives AD5592_CORO_BOARDS
+ * 	other boards
+ */
+AD5592_Pipe *coroPipe(AD5592_Coro *co, AD5592_Device *dev);
+
+/**
+ * Queue the writes that put pins into a mode.
+ * Parameters:
+ * 	co = script
+ * 	dev = board
+ * 	pins = pins as bit mask
+ * 	mode = AD5592_MODE_ flags
+ * Returns:
+ * 	1 on success, 0 if the scheduler has no pipe for the board
+ */
+int coroSetPinMode(AD5592_Coro *co, AD5592_Device *dev, uint8_t pins, uint8_t mode);
+
+/**
+ * Run every script until all are done.
+ * Parameters:
+ * 	sched = scheduler
+ */
+void coroRun(AD5592_CoroSched *sched);
+
+#endif /* SOURCES_AD5592CORO_H_ */
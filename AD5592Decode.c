@@ -0,0 +1,134 @@
+/***********************************************************************
+ * File: AD5592Decode.c
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Bulk decoding of AD5592 ADC result frames
+ * Dependancies:
+ * 		-AD5592Decode.h
+ * 		-arm_neon.h or emmintrin.h when the compiler targets them
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ **********************************************************************/
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AD5592_DECODE_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define AD5592_DECODE_SSE2
+#endif
+#include "AD5592Decode.h"
+
+#define DECODE_LANES	8		/* Frames per vector */
+
+_Static_assert(AD5592_FULL_SCALE_MV <= 0x7FFF, "full scale too large for 16 bit lanes");
+
+/**
+ * Store one decoded sample.
+ * Returns:
+ * 	1 if it was stored, 0 if it was dropped
+ */
+static inline int decodeStore(uint16_t *channel[], int count[], int capacity,
+	uint8_t pin, uint16_t milivolts)
+{
+	if(channel[pin] == NULL || count[pin] >= capacity)
+	{
+		return 0;
+	}
+	channel[pin][count[pin]++] = milivolts;
+	return 1;
+}
+
+/**
+ * Same as decodeAdcFrames() without vector instructions.
+ * Parameters:
+ * 	rxBuf[] = received frames, most significant byte first
+ * 	frames = number of frames
+ * 	channel[] = 8 entry array of sample arrays indexed by pin number
+ * 	count[] = 8 entry array of samples already in each sample array
+ * 	capacity = size of each sample array
+ * Returns:
+ * 	Number of samples stored
+ */
+int decodeAdcFramesScalar(const char rxBuf[], int frames, uint16_t *channel[],
+	int count[], int capacity)
+{
+	uint16_t word;
+	int stored = 0;
+	int i;
+
+	for(i = 0; i < frames; i++)
+	{
+		word = ((uint8_t)rxBuf[2 * i] << 8) | (uint8_t)rxBuf[2 * i + 1];
+		if(word & 0x8000)
+		{
+			continue;
+		}
+		stored += decodeStore(channel, count, capacity, (word >> 12) & 0x7,
+			ad5592CountToMv(word & AD5592_COUNT_MAX));
+	}
+	return stored;
+}
+
+/**
+ * Decode ADC result frames into per pin millivolt arrays.
+ * Parameters:
+ * 	rxBuf[] = received frames, most significant byte first
+ * 	frames = number of frames
+ * 	channel[] = 8 entry array of sample arrays indexed by pin number
+ * 	count[] = 8 entry array of samples already in each sample array
+ * 	capacity = size of each sample array
+ * Returns:
+ * 	Number of samples stored
+ */
+int decodeAdcFrames(const char rxBuf[], int frames, uint16_t *channel[],
+	int count[], int capacity)
+{
+	int stored = 0;
+	int i = 0;
+#if defined(AD5592_DECODE_NEON) || defined(AD5592_DECODE_SSE2)
+	uint16_t word[DECODE_LANES];
+	uint16_t milivolts[DECODE_LANES];
+	int lane;
+
+	for(; i + DECODE_LANES <= frames; i += DECODE_LANES)
+	{
+#if defined(AD5592_DECODE_NEON)
+		/* Swap to host order, then count x full scale / 4096 with a
+		 * rounding narrowing shift */
+		uint16x8_t raw = vreinterpretq_u16_u8(vrev16q_u8(vld1q_u8((const uint8_t *)&rxBuf[2 * i])));
+		uint16x8_t value = vandq_u16(raw, vdupq_n_u16(AD5592_COUNT_MAX));
+		uint32x4_t low = vmull_u16(vget_low_u16(value), vdup_n_u16(AD5592_FULL_SCALE_MV));
+		uint32x4_t high = vmull_u16(vget_high_u16(value), vdup_n_u16(AD5592_FULL_SCALE_MV));
+
+		vst1q_u16(word, raw);
+		vst1q_u16(milivolts, vcombine_u16(vrshrn_n_u32(low, 12), vrshrn_n_u32(high, 12)));
+#else
+		/* Swap to host order, then count x 16 x full scale / 65536.
+		 * The top bit of the low half is the rounding bit. */
+		__m128i in = _mm_loadu_si128((const __m128i *)&rxBuf[2 * i]);
+		__m128i raw = _mm_or_si128(_mm_slli_epi16(in, 8), _mm_srli_epi16(in, 8));
+		__m128i value = _mm_slli_epi16(_mm_and_si128(raw, _mm_set1_epi16(AD5592_COUNT_MAX)), 4);
+		__m128i scale = _mm_set1_epi16(AD5592_FULL_SCALE_MV);
+		__m128i high = _mm_mulhi_epu16(value, scale);
+		__m128i round = _mm_srli_epi16(_mm_mullo_epi16(value, scale), 15);
+
+		_mm_storeu_si128((__m128i *)word, raw);
+		_mm_storeu_si128((__m128i *)milivolts, _mm_add_epi16(high, round));
+#endif
+		for(lane = 0; lane < DECODE_LANES; lane++)
+		{
+			if(!(word[lane] & 0x8000))
+			{
+				stored += decodeStore(channel, count, capacity,
+					(word[lane] >> 12) & 0x7, milivolts[lane]);
+			}
+		}
+	}
+#endif
+	return stored + decodeAdcFramesScalar(&rxBuf[2 * i], frames - i, channel,
+		count, capacity);
+}
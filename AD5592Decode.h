@@ -0,0 +1,52 @@
+/*********************************************************************
+ * File: AD5592Decode.h
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Bulk decoding of AD5592 ADC result frames
+ * Dependancies:
+ * 		-AD5592Conv.h v1.0.0
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release. NEON and SSE2 decoders with a scalar
+ * 			fallback.
+ *
+ * An ADC result frame holds a 0 in bit 15, the pin address in bits 14
+ * to 12 and the count in bits 11 to 0. Frames with bit 15 set, like
+ * temperature results and DAC readback, are skipped.
+ * The vector decoders byte swap, mask and convert 8 frames at a time
+ * and give the same millivolts as the scalar decoder bit for bit.
+ **********************************************************************/
+
+#ifndef SOURCES_AD5592DECODE_H_
+#define SOURCES_AD5592DECODE_H_
+
+#include <stdint.h>
+#include "AD5592Conv.h"
+
+/**
+ * Decode ADC result frames into per pin millivolt arrays. Uses NEON or
+ * SSE2 when the compiler targets them.
+ * Parameters:
+ * 	rxBuf[] = received frames, most significant byte first
+ * 	frames = number of frames
+ * 	channel[] = 8 entry array of sample arrays indexed by pin number.
+ * 		Samples for a pin with a NULL entry are dropped.
+ * 	count[] = 8 entry array of samples already in each sample array.
+ * 		Updated as samples are stored.
+ * 	capacity = size of each sample array. Samples past it are dropped.
+ * Returns:
+ * 	Number of samples stored
+ */
+int decodeAdcFrames(const char rxBuf[], int frames, uint16_t *channel[],
+	int count[], int capacity);
+
+/**
+ * Same as decodeAdcFrames() without vector instructions. Used for the
+ * tail of a vector decode and to check the vector decoders.
+ */
+int decodeAdcFramesScalar(const char rxBuf[], int frames, uint16_t *channel[],
+	int count[], int capacity);
+
+#endif /* SOURCES_AD5592DECODE_H_ */
@@ -0,0 +1,339 @@
+/***********************************************************************
+ * File: AD5592Filter.c
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Oversampling and decimation filters for ADC result frames
+ * Dependancies:
+ * 		-AD5592Conv.h v1.0.0
+ * 		-libm, for filterLowpass()
+ * 		-AD5592Filter.h
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ **********************************************************************/
+
+#include <math.h>
+#include <string.h>
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AD5592_FILTER_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define AD5592_FILTER_SSE2
+#endif
+#include "AD5592Filter.h"
+
+#define FILTER_LANES	8		/* Taps per vector */
+#define FILTER_PI		3.14159265358979323846
+
+/**
+ * Set up a filter with every pin at rest.
+ * Parameters:
+ * 	filter = filter to set up
+ * 	config = stages. Values out of range are clamped.
+ */
+void filterInit(AD5592_Filter *filter, const AD5592_FilterConfig *config)
+{
+	AD5592_FilterConfig *mine = &filter->config;
+	int i;
+
+	memset(filter, 0, sizeof(*filter));
+	*mine = *config;
+	if(mine->cicOrder < 1)
+	{
+		mine->cicOrder = 1;
+	}
+	if(mine->cicOrder > AD5592_FILTER_MAX_ORDER)
+	{
+		mine->cicOrder = AD5592_FILTER_MAX_ORDER;
+	}
+	if(mine->cicRatio < 1)
+	{
+		mine->cicRatio = 1;
+	}
+	if(mine->firTaps > AD5592_FILTER_MAX_TAPS)
+	{
+		mine->firTaps = AD5592_FILTER_MAX_TAPS;
+	}
+	if(mine->firRatio < 1)
+	{
+		mine->firRatio = 1;
+	}
+	if(mine->average > AD5592_FILTER_MAX_AVERAGE)
+	{
+		mine->average = AD5592_FILTER_MAX_AVERAGE;
+	}
+
+	/* Pad the taps with zeros in front to whole vectors so the last
+	 * firTaps inputs of the window meet the coefficients */
+	filter->firWindow = (mine->firTaps + FILTER_LANES - 1) & ~(FILTER_LANES - 1);
+	for(i = 0; i < mine->firTaps; i++)
+	{
+		filter->firKernel[filter->firWindow - mine->firTaps + i] = mine->firCoeff[i];
+	}
+
+	filter->cicGain = 1;
+	for(i = 0; i < mine->cicOrder; i++)
+	{
+		filter->cicGain *= mine->cicRatio;
+	}
+}
+
+/**
+ * Design a windowed sinc low pass FIR for a configuration.
+ * Parameters:
+ * 	config = configuration to fill in firCoeff and firTaps of
+ * 	taps = number of taps, up to AD5592_FILTER_MAX_TAPS
+ * 	cutoff = cutoff as a fraction of the FIR input rate, up to 0.5
+ */
+void filterLowpass(AD5592_FilterConfig *config, int taps, double cutoff)
+{
+	double weight[AD5592_FILTER_MAX_TAPS];
+	double total = 0;
+	double x;
+	int32_t sum = 0;
+	int i;
+
+	if(taps > AD5592_FILTER_MAX_TAPS)
+	{
+		taps = AD5592_FILTER_MAX_TAPS;
+	}
+	if(taps < 1)
+	{
+		config->firTaps = 0;
+		return;
+	}
+	for(i = 0; i < taps; i++)
+	{
+		x = i - (taps - 1) / 2.0;
+		weight[i] = x == 0 ? 2 * cutoff : sin(2 * FILTER_PI * cutoff * x) / (FILTER_PI * x);
+		if(taps > 1)
+		{
+			/* Hamming window */
+			weight[i] *= 0.54 - 0.46 * cos(2 * FILTER_PI * i / (taps - 1));
+		}
+		total += weight[i];
+	}
+	for(i = 0; i < taps; i++)
+	{
+		config->firCoeff[i] = lround(weight[i] / total * 32768);
+		sum += config->firCoeff[i];
+	}
+	/* Put the rounding error on the middle tap for a gain of exactly 1 */
+	config->firCoeff[taps / 2] += 32768 - sum;
+	for(i = taps; i < AD5592_FILTER_MAX_TAPS; i++)
+	{
+		config->firCoeff[i] = 0;
+	}
+	config->firTaps = taps;
+}
+
+/**
+ * FIR dot product without vector instructions.
+ * Parameters:
+ * 	window[] = inputs, oldest first
+ * 	coeff[] = Q15 coefficients
+ * 	taps = number of taps, a multiple of 8
+ * Returns:
+ * 	Sum of products
+ */
+int32_t filterDotScalar(const int16_t window[], const int16_t coeff[], int taps)
+{
+	int32_t sum = 0;
+	int i;
+
+	for(i = 0; i < taps; i++)
+	{
+		sum += (int32_t)window[i] * coeff[i];
+	}
+	return sum;
+}
+
+/**
+ * FIR dot product with NEON or SSE2 when the compiler targets them.
+ * Parameters:
+ * 	window[] = inputs, oldest first
+ * 	coeff[] = Q15 coefficients
+ * 	taps = number of taps, a multiple of 8
+ * Returns:
+ * 	Sum of products
+ */
+int32_t filterDot(const int16_t window[], const int16_t coeff[], int taps)
+{
+#if defined(AD5592_FILTER_NEON)
+	int32x4_t sum = vdupq_n_s32(0);
+	int32x2_t half;
+	int16x8_t x;
+	int16x8_t c;
+	int i;
+
+	for(i = 0; i < taps; i += FILTER_LANES)
+	{
+		x = vld1q_s16(&window[i]);
+		c = vld1q_s16(&coeff[i]);
+		sum = vmlal_s16(sum, vget_low_s16(x), vget_low_s16(c));
+		sum = vmlal_s16(sum, vget_high_s16(x), vget_high_s16(c));
+	}
+	half = vadd_s32(vget_low_s32(sum), vget_high_s32(sum));
+	return vget_lane_s32(vpadd_s32(half, half), 0);
+#elif defined(AD5592_FILTER_SSE2)
+	/* Multiply 16 bit lanes into 32 bit pair sums */
+	__m128i sum = _mm_setzero_si128();
+	int i;
+
+	for(i = 0; i < taps; i += FILTER_LANES)
+	{
+		sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)&window[i]),
+			_mm_loadu_si128((const __m128i *)&coeff[i])));
+	}
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum);
+#else
+	return filterDotScalar(window, coeff, taps);
+#endif
+}
+
+/**
+ * CIC stage. Integrators run at the input rate and wrap, combs run at
+ * the output rate, as in a hardware CIC.
+ * Returns:
+ * 	1 with an output in *out, 0 if none is due
+ */
+static inline int filterCic(AD5592_Filter *filter, AD5592_FilterChannel *channel,
+	uint16_t count, int16_t *out)
+{
+	const AD5592_FilterConfig *config = &filter->config;
+	uint64_t value = count;
+	uint64_t delayed;
+	int i;
+
+	for(i = 0; i < config->cicOrder; i++)
+	{
+		channel->integrator[i] += value;
+		value = channel->integrator[i];
+	}
+	if(++channel->cicPhase < config->cicRatio)
+	{
+		return 0;
+	}
+	channel->cicPhase = 0;
+	for(i = 0; i < config->cicOrder; i++)
+	{
+		delayed = channel->comb[i];
+		channel->comb[i] = value;
+		value -= delayed;
+	}
+	*out = ((value << AD5592_FILTER_FRACTION) + filter->cicGain / 2) / filter->cicGain;
+	return 1;
+}
+
+/**
+ * FIR stage.
+ * Returns:
+ * 	1 with an output in *out, 0 if none is due
+ */
+static inline int filterFir(AD5592_Filter *filter, AD5592_FilterChannel *channel,
+	int16_t in, int16_t *out)
+{
+	const AD5592_FilterConfig *config = &filter->config;
+	int window = filter->firWindow;
+	int32_t sum;
+
+	/* The window is the last firWindow inputs, oldest first */
+	channel->history[channel->firPos] = in;
+	channel->history[channel->firPos + window] = in;
+	if(++channel->firPos >= window)
+	{
+		channel->firPos = 0;
+	}
+	if(++channel->firPhase < config->firRatio)
+	{
+		return 0;
+	}
+	channel->firPhase = 0;
+
+	sum = filterDot(&channel->history[channel->firPos], filter->firKernel, window);
+	sum = (sum + (1 << 14)) >> 15;
+	*out = sum < 0 ? 0 : sum > AD5592_FILTER_FULL_SCALE ? AD5592_FILTER_FULL_SCALE : sum;
+	return 1;
+}
+
+/**
+ * Moving average stage.
+ */
+static inline int16_t filterAverage(AD5592_Filter *filter, AD5592_FilterChannel *channel,
+	int16_t in)
+{
+	uint8_t length = filter->config.average;
+
+	if(channel->averageFill == length)
+	{
+		channel->averageSum -= channel->averageBuf[channel->averagePos];
+	}else
+	{
+		channel->averageFill++;
+	}
+	channel->averageBuf[channel->averagePos] = in;
+	channel->averageSum += in;
+	if(++channel->averagePos >= length)
+	{
+		channel->averagePos = 0;
+	}
+	return (channel->averageSum + channel->averageFill / 2) / channel->averageFill;
+}
+
+/**
+ * Filter ADC result frames into per pin output arrays.
+ * Parameters:
+ * 	filter = filter
+ * 	rxBuf[] = received frames, most significant byte first
+ * 	frames = number of frames
+ * 	channel[] = 8 entry array of output arrays indexed by pin number
+ * 	count[] = 8 entry array of outputs already in each output array
+ * 	capacity = size of each output array
+ * Returns:
+ * 	Number of outputs stored
+ */
+int filterFrames(AD5592_Filter *filter, const char rxBuf[], int frames, int16_t *channel[],
+	int count[], int capacity)
+{
+	const AD5592_FilterConfig *config = &filter->config;
+	AD5592_FilterChannel *state;
+	uint16_t word;
+	uint8_t pin;
+	int16_t value;
+	int stored = 0;
+	int i;
+
+	for(i = 0; i < frames; i++)
+	{
+		word = ((uint8_t)rxBuf[2 * i] << 8) | (uint8_t)rxBuf[2 * i + 1];
+		if(word & 0x8000)
+		{
+			continue;
+		}
+		pin = (word >> 12) & 0x7;
+		state = &filter->channel[pin];
+		if(!filterCic(filter, state, word & AD5592_COUNT_MAX, &value))
+		{
+			continue;
+		}
+		if(config->firTaps && !filterFir(filter, state, value, &value))
+		{
+			continue;
+		}
+		if(config->average > 1)
+		{
+			value = filterAverage(filter, state, value);
+		}
+		if(channel[pin] != NULL && count[pin] < capacity)
+		{
+			channel[pin][count[pin]++] = value;
+			stored++;
+		}
+	}
+	return stored;
+}
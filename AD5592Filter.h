@@ -0,0 +1,160 @@
+/*********************************************************************
+ * File: AD5592Filter.h
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Oversampling and decimation filters for ADC result frames
+ * Dependancies:
+ * 		-AD5592Conv.h v1.0.0
+ * 		-libm, for filterLowpass()
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release. NEON and SSE2 FIR kernels with a scalar
+ * 			fallback.
+ *
+ * A filter takes blocks of ADC result frames, from an AD5592_Stream
+ * block or a sequence scan, and runs each pin through up to three
+ * stages in integer arithmetic:
+ * 	1. CIC decimation of order 1 to AD5592_FILTER_MAX_ORDER by cicRatio.
+ * 		Order 1 is a boxcar: the mean of each cicRatio samples.
+ * 	2. FIR decimation by firRatio, if firTaps is not 0. Coefficients are
+ * 		Q15 and should add up to 32768 for unity gain; coefficient 0
+ * 		applies to the oldest sample. filterLowpass() designs them.
+ * 	3. A moving average of the last average outputs, if average is more
+ * 		than 1. It does not decimate.
+ *
+ * Outputs are counts with AD5592_FILTER_FRACTION extra bits, 0 to
+ * 4095 << AD5592_FILTER_FRACTION. Averaging 4^n samples gives up to n
+ * extra effective bits when the noise is at least one count. One output
+ * comes out for every cicRatio x firRatio samples of a pin.
+ *
+ * Frames with bit 15 set, like temperature results, are skipped.
+ **********************************************************************/
+
+#ifndef SOURCES_AD5592FILTER_H_
+#define SOURCES_AD5592FILTER_H_
+
+#include <stdint.h>
+#include "AD5592Conv.h"
+
+#define AD5592_FILTER_FRACTION		3		/* Extra bits in an output */
+#define AD5592_FILTER_MAX_ORDER		3		/* Highest CIC order */
+#define AD5592_FILTER_MAX_TAPS		64		/* Most FIR taps, a multiple of 8 */
+#define AD5592_FILTER_MAX_AVERAGE	64		/* Longest moving average */
+#define AD5592_FILTER_FULL_SCALE	(AD5592_COUNT_MAX << AD5592_FILTER_FRACTION)
+
+_Static_assert(AD5592_FILTER_MAX_TAPS % 8 == 0, "AD5592_FILTER_MAX_TAPS must be a multiple of 8");
+_Static_assert(AD5592_FILTER_FULL_SCALE <= 0x7FFF, "filter outputs must fit 16 bit lanes");
+
+/**
+ * What a filter does.
+ */
+typedef struct
+{
+	uint8_t cicOrder;							/* CIC order, 1 for a boxcar */
+	uint16_t cicRatio;							/* CIC decimation, 1 for none */
+	uint8_t firTaps;							/* FIR taps, 0 for no FIR stage */
+	uint8_t firRatio;							/* FIR decimation */
+	int16_t firCoeff[AD5592_FILTER_MAX_TAPS];	/* Q15 coefficients */
+	uint8_t average;							/* Moving average length, 0 or 1 for none */
+} AD5592_FilterConfig;
+
+/**
+ * State of one pin.
+ */
+typedef struct
+{
+	uint64_t integrator[AD5592_FILTER_MAX_ORDER];	/* CIC integrators */
+	uint64_t comb[AD5592_FILTER_MAX_ORDER];			/* CIC comb delays */
+	uint16_t cicPhase;								/* Samples into this CIC output */
+	int16_t history[2 * AD5592_FILTER_MAX_TAPS];	/* FIR inputs, kept twice so the window is contiguous */
+	uint8_t firPos;									/* Next history slot */
+	uint8_t firPhase;								/* Inputs into this FIR output */
+	int16_t averageBuf[AD5592_FILTER_MAX_AVERAGE];	/* Last outputs */
+	int32_t averageSum;								/* Sum of averageBuf */
+	uint8_t averagePos;								/* Next averageBuf slot */
+	uint8_t averageFill;							/* Outputs in averageBuf */
+} AD5592_FilterChannel;
+
+/**
+ * A filter.
+ */
+typedef struct
+{
+	AD5592_FilterConfig config;					/* Stages */
+	int firWindow;								/* FIR taps rounded up to a multiple of 8 */
+	int16_t firKernel[AD5592_FILTER_MAX_TAPS];	/* Coefficients zero padded in front to firWindow */
+	uint64_t cicGain;							/* cicRatio ^ cicOrder */
+	AD5592_FilterChannel channel[8];			/* State by pin */
+} AD5592_Filter;
+
+/**
+ * Set up a filter with every pin at rest.
+ * Parameters:
+ * 	filter = filter to set up
+ * 	config = stages. Values out of range are clamped.
+ */
+void filterInit(AD5592_Filter *filter, const AD5592_FilterConfig *config);
+
+/**
+ * Design a windowed sinc low pass FIR for a configuration. Uses floating
+ * point once, at set up.
+ * Parameters:
+ * 	config = configuration to fill in firCoeff and firTaps of
+ * 	taps = number of taps, up to AD5592_FILTER_MAX_TAPS
+ * 	cutoff = cutoff as a fraction of the FIR input rate, up to 0.5
+ */
+void filterLowpass(AD5592_FilterConfig *config, int taps, double cutoff);
+
+/**
+ * Filter ADC result frames into per pin output arrays. Uses NEON or
+ * SSE2 for the FIR stage when the compiler targets them.
+ * Parameters:
+ * 	filter = filter
+ * 	rxBuf[] = received frames, most significant byte first
+ * 	frames = number of frames
+ * 	channel[] = 8 entry array of output arrays indexed by pin number.
+ * 		Outputs for a pin with a NULL entry are dropped, but the pin
+ * 		is still filtered.
+ * 	count[] = 8 entry array of outputs already in each output array.
+ * 		Updated as outputs are stored.
+ * 	capacity = size of each output array. Outputs past it are dropped.
+ * Returns:
+ * 	Number of outputs stored
+ */
+int filterFrames(AD5592_Filter *filter, const char rxBuf[], int frames, int16_t *channel[],
+	int count[], int capacity);
+
+/**
+ * FIR dot product of a window of inputs and the coefficients without
+ * vector instructions. Used to check the vector kernels.
+ * Parameters:
+ * 	window[] = inputs, oldest first
+ * 	coeff[] = Q15 coefficients
+ * 	taps = number of taps, a multiple of 8
+ * Returns:
+ * 	Sum of products
+ */
+int32_t filterDotScalar(const int16_t window[], const int16_t coeff[], int taps);
+
+/**
+ * FIR dot product with NEON or SSE2 when the compiler targets them.
+ * Same parameters and result as filterDotScalar().
+ */
+int32_t filterDot(const int16_t window[], const int16_t coeff[], int taps);
+
+/**
+ * Convert a filter output to millivolts.
+ * Parameters:
+ * 	value = filter output
+ * Returns:
+ * 	millivolts, rounded to nearest
+ */
+static inline uint16_t filterToMv(int16_t value)
+{
+	return ((uint32_t)value * AD5592_FULL_SCALE_MV + (1u << (11 + AD5592_FILTER_FRACTION))) >>
+		(12 + AD5592_FILTER_FRACTION);
+}
+
+#endif /* SOURCES_AD5592FILTER_H_ */
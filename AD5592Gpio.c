@@ -0,0 +1,289 @@
+/***********************************************************************
+ * File: AD5592Gpio.c
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Digital input monitor with edge detection and debounce
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Gpio.h
+ * 		-pthread
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- A poll whose transfer fails gives no sample and is counted in
+ * 			failed. The next good poll only primes the read again.
+ **********************************************************************/
+
+#include <string.h>
+#include <time.h>
+#include "AD5592Gpio.h"
+#include "AD5592Clock.h"
+
+/**
+ * Pass a change to every subscriber watching it. Each subscriber only
+ * sees the edges and pins it asked for.
+ */
+static void gpioDeliver(AD5592_GpioMonitor *monitor, const AD5592_GpioEvent *event)
+{
+	AD5592_GpioSubscriber *subscriber;
+	AD5592_GpioEvent mine;
+	int i;
+
+	pthread_mutex_lock(&monitor->lock);
+	for(i = 0; i < monitor->subscribers; i++)
+	{
+		subscriber = &monitor->subscriber[i];
+		mine = *event;
+		mine.rising &= (subscriber->edges & AD5592_GPIO_RISING) ? subscriber->pins : 0;
+		mine.falling &= (subscriber->edges & AD5592_GPIO_FALLING) ? subscriber->pins : 0;
+		if(mine.rising | mine.falling)
+		{
+			subscriber->callback(&mine, subscriber->context);
+		}
+	}
+	pthread_mutex_unlock(&monitor->lock);
+}
+
+/**
+ * Debounce one sample of the inputs and report any change.
+ */
+static void gpioSample(AD5592_GpioMonitor *monitor, uint8_t raw, uint64_t timeNs)
+{
+	AD5592_GpioEvent event;
+	uint8_t states = atomic_load_explicit(&monitor->states, memory_order_relaxed);
+	uint8_t bit;
+	int pin;
+
+	raw &= monitor->pins;
+	if(!monitor->started)
+	{
+		/* The first sample sets the states without a change */
+		atomic_store_explicit(&monitor->states, raw, memory_order_relaxed);
+		monitor->started = 1;
+		return;
+	}
+
+	event.rising = 0;
+	event.falling = 0;
+	for(pin = 0; pin < 8; pin++)
+	{
+		bit = 0x1 << pin;
+		if(!((raw ^ states) & bit))
+		{
+			monitor->held[pin] = 0;
+		}else if(++monitor->held[pin] >= monitor->debounce[pin])
+		{
+			monitor->held[pin] = 0;
+			states ^= bit;
+			if(raw & bit)
+			{
+				event.rising |= bit;
+			}else
+			{
+				event.falling |= bit;
+			}
+		}
+	}
+	if(event.rising | event.falling)
+	{
+		atomic_store_explicit(&monitor->states, states, memory_order_relaxed);
+		event.timeNs = timeNs;
+		event.states = states;
+		monitor->events++;
+		gpioDeliver(monitor, &event);
+	}
+}
+
+/**
+ * Monitor thread. Polls run on absolute deadlines one period apart so
+ * the time spent in a poll does not stretch the period.
+ */
+static void *gpioThread(void *arg)
+{
+	AD5592_GpioMonitor *monitor = arg;
+	AD5592_Device *dev = monitor->dev;
+	char txBuf[2];
+	char rxBuf[2];
+	struct timespec next;
+	uint64_t sampledNs = 0;
+	uint64_t pollNs;
+	uint64_t nextNs;
+	int primed = 0;
+
+	/* Keep the read configuration of every input pin on the board */
+	makeWord(txBuf, AD5592_GPIO_READ_INPUT | deviceRegister(dev, AD5592_GPIO_READ_CONFIG));
+	nextNs = clockNowNs();
+
+	while(atomic_load_explicit(&monitor->running, memory_order_relaxed))
+	{
+		pollNs = clockNowNs();
+		if(deviceTransfer(dev, txBuf, rxBuf, 1))
+		{
+			/* The frame carries the states the poll before sampled */
+			if(primed)
+			{
+				gpioSample(monitor, rxBuf[1], sampledNs);
+			}
+			primed = 1;
+			sampledNs = pollNs;
+			monitor->polls++;
+		}else
+		{
+			/* Nothing was received and the read may not have reached
+			 * the board, so the next poll only asks again */
+			primed = 0;
+			monitor->failed++;
+		}
+
+		nextNs += monitor->periodUs * 1000ull;
+		pollNs = clockNowNs();
+		if(pollNs > nextNs + monitor->periodUs * 1000ull)
+		{
+			monitor->overruns++;
+			nextNs = pollNs;
+		}
+		next.tv_sec = nextNs / 1000000000u;
+		next.tv_nsec = nextNs % 1000000000u;
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+	}
+	return NULL;
+}
+
+/**
+ * Set up a monitor.
+ * Parameters:
+ * 	monitor = monitor to set up
+ * 	dev = board to read
+ * 	pins = pins to monitor as bit mask
+ * 	periodUs = time between polls, at least AD5592_GPIO_MIN_PERIOD_US
+ */
+void gpioMonitorInit(AD5592_GpioMonitor *monitor, AD5592_Device *dev, uint8_t pins,
+	uint32_t periodUs)
+{
+	int pin;
+
+	monitor->dev = dev;
+	monitor->pins = pins;
+	monitor->periodUs = periodUs < AD5592_GPIO_MIN_PERIOD_US ? AD5592_GPIO_MIN_PERIOD_US : periodUs;
+	for(pin = 0; pin < 8; pin++)
+	{
+		monitor->debounce[pin] = 1;
+		monitor->held[pin] = 0;
+	}
+	atomic_init(&monitor->states, 0);
+	monitor->started = 0;
+	monitor->subscribers = 0;
+	pthread_mutex_init(&monitor->lock, NULL);
+	monitor->polls = 0;
+	monitor->events = 0;
+	monitor->overruns = 0;
+	monitor->failed = 0;
+	atomic_init(&monitor->running, 0);
+}
+
+/**
+ * Set how long pins must hold a new level before it counts.
+ * Parameters:
+ * 	monitor = monitor
+ * 	pins = pins as bit mask
+ * 	debounceUs = microseconds
+ */
+void gpioSetDebounce(AD5592_GpioMonitor *monitor, uint8_t pins, uint32_t debounceUs)
+{
+	uint32_t polls = (debounceUs + monitor->periodUs - 1) / monitor->periodUs;
+	int pin;
+
+	if(polls < 1)
+	{
+		polls = 1;
+	}
+	if(polls > 0xFFFF)
+	{
+		polls = 0xFFFF;
+	}
+	for(pin = 0; pin < 8; pin++)
+	{
+		if((pins >> pin) & 0x1)
+		{
+			monitor->debounce[pin] = polls;
+		}
+	}
+}
+
+/**
+ * Add a subscriber.
+ * Parameters:
+ * 	monitor = monitor
+ * 	pins = pins to watch as bit mask
+ * 	edges = AD5592_GPIO_RISING, AD5592_GPIO_FALLING or AD5592_GPIO_BOTH
+ * 	callback = called with each change
+ * 	context = passed to callback
+ * Returns:
+ * 	1 on success, 0 if the monitor has AD5592_GPIO_SUBSCRIBERS already
+ */
+int gpioSubscribe(AD5592_GpioMonitor *monitor, uint8_t pins, uint8_t edges,
+	AD5592_GpioCallback callback, void *context)
+{
+	AD5592_GpioSubscriber *subscriber;
+	int ok = 0;
+
+	pthread_mutex_lock(&monitor->lock);
+	if(monitor->subscribers < AD5592_GPIO_SUBSCRIBERS)
+	{
+		subscriber = &monitor->subscriber[monitor->subscribers++];
+		subscriber->pins = pins;
+		subscriber->edges = edges;
+		subscriber->callback = callback;
+		subscriber->context = context;
+		ok = 1;
+	}
+	pthread_mutex_unlock(&monitor->lock);
+	return ok;
+}
+
+/**
+ * Configure the pins as digital inputs and start the monitor thread.
+ * Parameters:
+ * 	monitor = monitor
+ * Returns:
+ * 	1 on success, 0 if the thread could not be started
+ */
+int gpioMonitorStart(AD5592_GpioMonitor *monitor)
+{
+	deviceSetPinMode(monitor->dev, monitor->pins, AD5592_MODE_GPIO_IN);
+	monitor->started = 0;
+	memset(monitor->held, 0, sizeof(monitor->held));
+	atomic_store_explicit(&monitor->running, 1, memory_order_relaxed);
+	if(pthread_create(&monitor->thread, NULL, gpioThread, monitor) != 0)
+	{
+		atomic_store_explicit(&monitor->running, 0, memory_order_relaxed);
+		return 0;
+	}
+	return 1;
+}
+
+/**
+ * Stop the monitor thread.
+ * Parameters:
+ * 	monitor = monitor
+ */
+void gpioMonitorStop(AD5592_GpioMonitor *monitor)
+{
+	atomic_store_explicit(&monitor->running, 0, memory_order_relaxed);
+	pthread_join(monitor->thread, NULL);
+}
+
+/**
+ * Get the debounced states.
+ * Parameters:
+ * 	monitor = monitor
+ * Returns:
+ * 	Pin states as bit mask, monitored pins only
+ */
+uint8_t gpioStates(AD5592_GpioMonitor *monitor)
+{
+	return atomic_load_explicit(&monitor->states, memory_order_relaxed);
+}
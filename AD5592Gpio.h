@@ -0,0 +1,167 @@
+/*********************************************************************
+ * File: AD5592Gpio.h
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Digital input monitor with edge detection and debounce
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-pthread
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- Polls whose transfer failed are counted in failed and give no
+ * 			sample.
+ *
+ * A monitor thread reads the GPIO inputs of one board every period.
+ * Each poll is a single AD5592_GPIO_READ_INPUT frame: it asks for the
+ * inputs and clocks out the states the poll before asked for, so a poll
+ * costs one frame instead of the two getDigitalIn() uses. The states a
+ * poll receives are one period old and are stamped with the time of the
+ * poll that sampled them.
+ *
+ * A pin changes state once its input has read the new level on
+ * debounce polls in a row. Every change is delivered to the subscribers
+ * watching that pin and edge, on the monitor thread, so callbacks must
+ * be short. Polls with no change cost the subscribers nothing.
+ *
+ * The monitor thread owns the board from gpioMonitorStart() to
+ * gpioMonitorStop(). Nothing else may use the board or its chip select
+ * in that time.
+ **********************************************************************/
+
+#ifndef SOURCES_AD5592GPIO_H_
+#define SOURCES_AD5592GPIO_H_
+
+#include <stdatomic.h>
+#include <pthread.h>
+#include "AD5592RPI.h"
+
+#define AD5592_GPIO_SUBSCRIBERS		8		/* Most subscribers of one monitor */
+#define AD5592_GPIO_MIN_PERIOD_US	10		/* Shortest poll period */
+
+/**
+ * Edges a subscriber watches.
+ */
+#define AD5592_GPIO_RISING		0x01
+#define AD5592_GPIO_FALLING		0x02
+#define AD5592_GPIO_BOTH		(AD5592_GPIO_RISING | AD5592_GPIO_FALLING)
+
+/**
+ * A change of one or more debounced inputs.
+ */
+typedef struct
+{
+	uint64_t timeNs;		/* CLOCK_MONOTONIC of the poll that sampled the change */
+	uint8_t states;			/* Debounced states of every monitored pin */
+	uint8_t rising;			/* Pins that went high */
+	uint8_t falling;		/* Pins that went low */
+} AD5592_GpioEvent;
+
+/**
+ * Called on the monitor thread for every change a subscriber watches.
+ * Parameters:
+ * 	event = the change, only valid during the call
+ * 	context = pointer given to gpioSubscribe()
+ */
+typedef void (*AD5592_GpioCallback)(const AD5592_GpioEvent *event, void *context);
+
+/**
+ * One subscriber.
+ */
+typedef struct
+{
+	uint8_t pins;					/* Pins watched */
+	uint8_t edges;					/* AD5592_GPIO_RISING and or AD5592_GPIO_FALLING */
+	AD5592_GpioCallback callback;	/* Called with each change */
+	void *context;					/* Passed to callback */
+} AD5592_GpioSubscriber;
+
+/**
+ * A monitor.
+ */
+typedef struct
+{
+	AD5592_Device *dev;				/* Board being read */
+	uint8_t pins;					/* Pins monitored */
+	uint32_t periodUs;				/* Time between polls */
+	uint16_t debounce[8];			/* Polls a new level must last, by pin */
+	uint16_t held[8];				/* Polls the new level has lasted, by pin */
+	atomic_uint states;				/* Debounced states */
+	uint8_t started;				/* States hold a first sample */
+	AD5592_GpioSubscriber subscriber[AD5592_GPIO_SUBSCRIBERS];	/* Subscribers */
+	int subscribers;				/* Subscribers in use */
+	pthread_mutex_t lock;			/* Guards the subscribers */
+	uint64_t polls;					/* Polls whose transfer worked */
+	uint64_t events;				/* Changes found */
+	uint32_t overruns;				/* Polls that started late by more than a period */
+	uint32_t failed;				/* Polls whose transfer failed */
+	atomic_int running;				/* Cleared to stop the thread */
+	pthread_t thread;				/* Monitor thread */
+} AD5592_GpioMonitor;
+
+/**
+ * Set up a monitor. Nothing is sent to the board until
+ * gpioMonitorStart().
+ * Parameters:
+ * 	monitor = monitor to set up
+ * 	dev = board to read
+ * 	pins = pins to monitor as bit mask
+ * 	periodUs = time between polls, at least AD5592_GPIO_MIN_PERIOD_US
+ */
+void gpioMonitorInit(AD5592_GpioMonitor *monitor, AD5592_Device *dev, uint8_t pins,
+	uint32_t periodUs);
+
+/**
+ * Set how long pins must hold a new level before it counts. Rounded up
+ * to whole poll periods. 0, the default, takes every new level at once.
+ * Call before gpioMonitorStart().
+ * Parameters:
+ * 	monitor = monitor
+ * 	pins = pins as bit mask
+ * 	debounceUs = microseconds
+ */
+void gpioSetDebounce(AD5592_GpioMonitor *monitor, uint8_t pins, uint32_t debounceUs);
+
+/**
+ * Add a subscriber. May be called while the monitor runs.
+ * Parameters:
+ * 	monitor = monitor
+ * 	pins = pins to watch as bit mask
+ * 	edges = AD5592_GPIO_RISING, AD5592_GPIO_FALLING or AD5592_GPIO_BOTH
+ * 	callback = called with each change
+ * 	context = passed to callback
+ * Returns:
+ * 	1 on success, 0 if the monitor has AD5592_GPIO_SUBSCRIBERS already
+ */
+int gpioSubscribe(AD5592_GpioMonitor *monitor, uint8_t pins, uint8_t edges,
+	AD5592_GpioCallback callback, void *context);
+
+/**
+ * Configure the pins as digital inputs and start the monitor thread.
+ * Parameters:
+ * 	monitor = monitor
+ * Returns:
+ * 	1 on success, 0 if the thread could not be started
+ */
+int gpioMonitorStart(AD5592_GpioMonitor *monitor);
+
+/**
+ * Stop the monitor thread. The pins stay digital inputs.
+ * Parameters:
+ * 	monitor = monitor
+ */
+void gpioMonitorStop(AD5592_GpioMonitor *monitor);
+
+/**
+ * Get the debounced states. May be called from any thread.
+ * Parameters:
+ * 	monitor = monitor
+ * Returns:
+ * 	Pin states as bit mask, monitored pins only
+ */
+uint8_t gpioStates(AD5592_GpioMonitor *monitor);
+
+#endif /* SOURCES_AD5592GPIO_H_ */
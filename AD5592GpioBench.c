@@ -0,0 +1,274 @@
+/**
+ * File: AD5592GpioBench.c
+ * Target: Raspberry Pi or any Linux host
+ * Function: Edge detection, debounce and failure handling of an
+ * 		AD5592_GpioMonitor
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Gpio.h v1.0.1
+ * 		-AD5592Sim.h v1.2.1
+ * 		-AD5592Clock.h v1.0.0
+ * 		-pthread
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version: 1.0.0:
+ * 		-Usage: AD5592GpioBench [-m ms] [-p us per poll] [-w us per toggle]
+ * 			[-b bounce us] [-d debounce us] [-e fail every nth transfer]
+ *
+ * 		-Monitors pins 0 to 3 of a simulated board for -m ms (1000 by
+ * 		default), polling every -p us (100 by default). Pin n toggles
+ * 		every (n + 1) x -w us (5000 by default), and after each toggle
+ * 		it bounces between the two levels for -b us (300 by default).
+ * 		The monitor debounces every pin with -d us (400 by default).
+ * 		With -e every nth transfer fails without reaching the board. A
+ * 		poll only gives a sample when the poll before it worked, so
+ * 		-e 2 gives none.
+ *
+ * 		-The levels are worked out from the time at each transfer, on
+ * 		the monitor thread, so nothing else touches the simulator.
+ * 		Every event is matched to the toggle before it:
+ * 			-missed counts toggles with no event,
+ * 			-bad counts events in the wrong direction, a second event
+ * 			for one toggle, or an event more than half a toggle period
+ * 			after its toggle.
+ * 		A bounce the debounce does not cover shows up as bad.
+ *
+ * 		-Prints:
+ * 			polls failed injected overruns events missed bad max_delay_us
+ * 		max_delay_us is the longest time from a toggle to the poll that
+ * 		sampled its event. Exits with 1 if any event is bad or, with no
+ * 		-e, if any toggle is missed.
+ *
+ * 		-Builds on a Linux host with:
+ * 			gcc -O2 -DAD5592_NO_BCM2835 -o AD5592GpioBench \
+ * 				AD5592GpioBench.c AD5592Gpio.c AD5592RPI.c \
+ * 				AD5592Batch.c AD5592Timing.c AD5592Transport.c \
+ * 				AD5592Sim.c -lpthread
+ * 		Add -fsanitize=thread to check the monitor for data races.
+ *
+ **********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "AD5592RPI.h"
+#include "AD5592Gpio.h"
+#include "AD5592Sim.h"
+#include "AD5592Clock.h"
+
+#define BENCH_PINS			0x0F	/* Pins toggled and monitored */
+#define BENCH_HIGH_MV		3300	/* Level of a high input */
+
+/**
+ * Events seen on one pin.
+ */
+typedef struct
+{
+	int64_t toggle;			/* Toggle of the last event, -1 for none */
+	uint32_t events;
+	uint32_t missed;		/* Toggles with no event */
+	uint32_t bad;			/* Events that match no toggle */
+} BenchPin;
+
+AD5592_Sim sim;
+AD5592_Transport simBus;			/* Simulator transport */
+AD5592_Transport stimBus;			/* Transport that drives the inputs, the monitor uses it */
+AD5592_Device dev;
+AD5592_GpioMonitor monitor;
+BenchPin benchPin[8];
+uint64_t originNs;					/* Time of toggle 0 */
+uint64_t toggleNs = 5000000;		/* Toggle period of pin 0 */
+uint64_t bounceNs = 300000;			/* Bounce after each toggle */
+uint64_t maxDelayNs = 0;			/* Longest toggle to event time */
+uint32_t failEvery = 0;				/* Every nth transfer fails, 0 for none */
+uint32_t transfers = 0;				/* Transfers since failures were armed */
+uint32_t injected = 0;				/* Transfers made to fail */
+int armed = 0;						/* Set once the board is set up */
+
+/**
+ * Toggle period of a pin.
+ */
+static uint64_t benchPeriod(int pin)
+{
+	return toggleNs * (pin + 1);
+}
+
+/**
+ * Level of a pin at a time. Toggle k leaves the pin at level k % 2,
+ * after bouncing for bounceNs.
+ */
+static int benchLevel(int pin, uint64_t timeNs)
+{
+	uint64_t period = benchPeriod(pin);
+	uint64_t toggle = timeNs / period;
+	uint64_t since = timeNs - toggle * period;
+	int level = toggle & 0x1;
+
+	/* Four bounces, back to the old level and forward again */
+	if(toggle > 0 && since < bounceNs && (since * 8 / bounceNs) & 0x1)
+	{
+		level ^= 1;
+	}
+	return level;
+}
+
+/**
+ * Drive the inputs to their levels at this time, then transfer on the
+ * simulator. Every failEvery-th transfer fails instead. Only the monitor
+ * thread transfers once failures are armed.
+ */
+static int stimTransfer(AD5592_Transport *bus, uint8_t cs, const char txBuf[],
+	char rxBuf[], int frames)
+{
+	AD5592_Transport *inner = bus->context;
+	uint64_t nowNs = clockNowNs() - originNs;
+	int pin;
+
+	if(armed && failEvery && ++transfers % failEvery == 0)
+	{
+		injected++;
+		return 0;
+	}
+	for(pin = 0; pin < 8; pin++)
+	{
+		if((BENCH_PINS >> pin) & 0x1)
+		{
+			simSetInput(&sim, cs, pin, benchLevel(pin, nowNs) ? BENCH_HIGH_MV : 0);
+		}
+	}
+	return transportTransfer(inner, cs, txBuf, rxBuf, frames);
+}
+
+/**
+ * Subscriber. Matches each event to the toggle before it.
+ */
+static void benchEvent(const AD5592_GpioEvent *event, void *context)
+{
+	uint64_t timeNs = event->timeNs - originNs;
+	uint64_t period;
+	uint64_t delay;
+	int64_t toggle;
+	BenchPin *bench;
+	int rising;
+	int pin;
+
+	(void)context;
+	for(pin = 0; pin < 8; pin++)
+	{
+		if(!(((event->rising | event->falling) >> pin) & 0x1))
+		{
+			continue;
+		}
+		bench = &benchPin[pin];
+		period = benchPeriod(pin);
+		toggle = timeNs / period;
+		delay = timeNs - toggle * period;
+		rising = (event->rising >> pin) & 0x1;
+		bench->events++;
+		if(rising != (toggle & 0x1) || toggle == bench->toggle || delay > period / 2)
+		{
+			bench->bad++;
+			continue;
+		}
+		if(bench->toggle >= 0)
+		{
+			bench->missed += toggle - bench->toggle - 1;
+		}
+		bench->toggle = toggle;
+		if(delay > maxDelayNs)
+		{
+			maxDelayNs = delay;
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	long ms = 1000;
+	long periodUs = 100;
+	long debounceUs = 400;
+	uint32_t events = 0;
+	uint32_t missed = 0;
+	uint32_t bad = 0;
+	struct timespec wait;
+	int option;
+	int pin;
+
+	while((option = getopt(argc, argv, "m:p:w:b:d:e:")) != -1)
+	{
+		switch(option)
+		{
+			case 'm':
+				ms = atol(optarg);
+				break;
+			case 'p':
+				periodUs = atol(optarg);
+				break;
+			case 'w':
+				toggleNs = atol(optarg) * 1000ull;
+				break;
+			case 'b':
+				bounceNs = atol(optarg) * 1000ull;
+				break;
+			case 'd':
+				debounceUs = atol(optarg);
+				break;
+			case 'e':
+				failEvery = atoi(optarg);
+				break;
+			default:
+				ms = 0;
+				break;
+		}
+	}
+	if(ms < 1 || periodUs < AD5592_GPIO_MIN_PERIOD_US || toggleNs <= bounceNs ||
+		debounceUs < 0 || failEvery == 1)
+	{
+		printf("Usage: %s [-m ms] [-p us per poll, %d or more] [-w us per toggle]"
+			" [-b bounce us, less than -w] [-d debounce us]"
+			" [-e fail every nth transfer, 2 or more]\n", argv[0], AD5592_GPIO_MIN_PERIOD_US);
+		return 1;
+	}
+
+	simInit(&sim, 0);
+	simTransportInit(&simBus, &sim);
+	memset(&stimBus, 0, sizeof(stimBus));
+	stimBus.transfer = stimTransfer;
+	stimBus.context = &simBus;
+	deviceInit(&dev, &stimBus, 0);
+	for(pin = 0; pin < 8; pin++)
+	{
+		benchPin[pin].toggle = -1;
+	}
+
+	gpioMonitorInit(&monitor, &dev, BENCH_PINS, periodUs);
+	gpioSetDebounce(&monitor, BENCH_PINS, debounceUs);
+	gpioSubscribe(&monitor, BENCH_PINS, AD5592_GPIO_BOTH, benchEvent, NULL);
+	originNs = clockNowNs();
+	/* The pin modes go out now, so only the polls fail */
+	deviceSetPinMode(&dev, BENCH_PINS, AD5592_MODE_GPIO_IN);
+	armed = 1;
+	if(!gpioMonitorStart(&monitor))
+	{
+		printf("Could not start the monitor\n");
+		return 1;
+	}
+	wait.tv_sec = ms / 1000;
+	wait.tv_nsec = (ms % 1000) * 1000000;
+	nanosleep(&wait, NULL);
+	gpioMonitorStop(&monitor);
+
+	for(pin = 0; pin < 8; pin++)
+	{
+		events += benchPin[pin].events;
+		missed += benchPin[pin].missed;
+		bad += benchPin[pin].bad;
+	}
+	printf("polls failed injected overruns events missed bad max_delay_us\n");
+	printf("%llu %u %u %u %u %u %u %.0f\n", (unsigned long long)monitor.polls, monitor.failed,
+		injected, monitor.overruns, events, missed, bad, maxDelayNs / 1e3);
+	return bad || (!failEvery && missed) ? 1 : 0;
+}
@@ -0,0 +1,332 @@
+/**
+ * File: AD5592LineATP.c
+ * Target: Raspberry Pi
+ * Function: Acceptance Test Procedure for a batch of AD5592 Snack boards
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Plan.h v1.2.0
+ * 		-AD5592Runner.h v1.0.0
+ * 		-AD5592Timing.h v1.0.0
+ * 		-AD5592Log.h v1.0.0
+ * 		-AD5592Sim.h v1.2.0
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version: 1.0.0:
+ * 		-Usage: AD5592LineATP [-j jig] [plan]
+ *
+ * 		-Runs the AD5592SnackATP test plan, AD5592Snack.plan unless
+ * 		another file is named, on every unit under test of the jig
+ * 		described in AD5592Snack.jig unless another is given with -j.
+ * 		One reference board is shared by all of them. See AD5592Runner.h
+ * 		for the jig format and how the UUTs are interleaved.
+ *
+ * 		-The results of the whole batch go to one binary log named
+ * 		LINE-<UTC date>-<UTC time>.ad5592log. Each result has the UUT
+ * 		number in its board field. Convert it with AD5592LogDump.
+ *
+ * 		-Built with AD5592_NO_BCM2835 every bus of the jig is opened as
+ * 		/dev/spidevX. With the bcm2835 library only bus 0 can be used.
+ *
+ * 		-Exits with 1 if any UUT fails or an SPI transfer fails.
+ *
+ * 	* Version: 1.1.0:
+ * 		-Usage: AD5592LineATP [-j jig] [-t spi|sim] [-f uut] [plan]
+ *
+ * 		-With -t sim the jig is built in AD5592Sim: every board of the
+ * 		jig on buses 0 and 1, with the pins of each UUT joined to the
+ * 		reference by simWire(). The default jig and the half wired one
+ * 		in its comments can both be run without hardware and give their
+ * 		round counts.
+ *
+ * 		-With -t sim, -f leaves the pins of the named UUT unconnected,
+ * 		so that UUT fails and the others must still pass.
+ *
+ * 		-With -t sim the run also fails if any net was read while two
+ * 		boards drove it.
+ *
+ **********************************************************************/
+#include <time.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "AD5592RPI.h"
+#include "AD5592Plan.h"
+#include "AD5592Runner.h"
+#include "AD5592Timing.h"
+#include "AD5592Log.h"
+#include "AD5592Sim.h"
+
+#define DEFAULT_PLAN	"AD5592Snack.plan"
+#define DEFAULT_JIG		"AD5592Snack.jig"
+
+/**
+ * Open the transport of every bus the jig uses.
+ * Returns:
+ * 	1 on success, 0 on failure
+ */
+static int openBuses(AD5592_Runner *runner, AD5592_Transport transport[],
+	AD5592_Transport *bus[])
+{
+	uint8_t used[AD5592_RUNNER_BUSES] = {0};
+	int i;
+
+	used[runner->referenceBus] = 1;
+	for(i = 0; i < runner->uuts; i++)
+	{
+		used[runner->uut[i].bus] = 1;
+	}
+	for(i = 0; i < AD5592_RUNNER_BUSES; i++)
+	{
+		bus[i] = NULL;
+		if(!used[i])
+		{
+			continue;
+		}
+#ifdef AD5592_NO_BCM2835
+		static AD5592_Spidev spidev[AD5592_RUNNER_BUSES];
+
+		if(!spidevTransportInit(&transport[i], &spidev[i], i, AD5592_SPI_SPEED_HZ))
+		{
+			printf("Could not open /dev/spidev%d.0\n", i);
+			return 0;
+		}
+#else
+		if(i != 0)
+		{
+			printf("Bus %d needs a build with AD5592_NO_BCM2835 for spidev\n", i);
+			return 0;
+		}
+		/* Initialize the bcm2835 library and SPI module */
+		if(!bcm2835TransportInit(&transport[i]))
+		{
+			printf("bcm2835 init failed. Are you running as root??\n");
+			return 0;
+		}
+#endif
+		bus[i] = &transport[i];
+	}
+	return 1;
+}
+
+/**
+ * Build the jig in the simulator and give every bus it uses a
+ * transport.
+ * Parameters:
+ * 	fault = name of a UUT to leave unconnected, NULL for none
+ * Returns:
+ * 	1 on success, 0 on failure
+ */
+static int openSim(AD5592_Runner *runner, AD5592_Sim *sim, AD5592_Transport transport[],
+	AD5592_Transport *bus[], const char *fault)
+{
+	AD5592_RunnerUut *uut;
+	int found = fault == NULL;
+	int i;
+
+	for(i = 0; i < AD5592_RUNNER_BUSES; i++)
+	{
+		bus[i] = NULL;
+	}
+	simInit(sim, 0);
+	if(runner->referenceBus >= AD5592_SIM_BUSES)
+	{
+		printf("The simulator has buses 0 to %d\n", AD5592_SIM_BUSES - 1);
+		return 0;
+	}
+	simWire(sim, AD5592_SIM_BOARD(runner->referenceBus, runner->referenceCs), runner->pins);
+	bus[runner->referenceBus] = &transport[runner->referenceBus];
+	for(i = 0; i < runner->uuts; i++)
+	{
+		uut = &runner->uut[i];
+		if(uut->bus >= AD5592_SIM_BUSES)
+		{
+			printf("The simulator has buses 0 to %d\n", AD5592_SIM_BUSES - 1);
+			return 0;
+		}
+		if(fault == NULL || strcmp(fault, uut->name) != 0)
+		{
+			simWire(sim, AD5592_SIM_BOARD(uut->bus, uut->cs), uut->pins);
+		}else
+		{
+			found = 1;
+		}
+		bus[uut->bus] = &transport[uut->bus];
+	}
+	if(!found)
+	{
+		printf("No UUT named %s on the jig\n", fault);
+		return 0;
+	}
+	for(i = 0; i < AD5592_SIM_BUSES; i++)
+	{
+		if(bus[i] != NULL)
+		{
+			simBusTransportInit(bus[i], sim, i);
+		}
+	}
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	static AD5592_Transport transport[AD5592_RUNNER_BUSES];
+	static AD5592_Transport *bus[AD5592_RUNNER_BUSES];
+	static AD5592_Plan plan;
+	static AD5592_Schedule schedule;
+	static AD5592_Runner runner;
+	static AD5592_SettleStats settleStats;
+	static AD5592_Log lineLog;
+	static AD5592_Sim sim;
+	const char *planName = DEFAULT_PLAN;
+	const char *jigName = DEFAULT_JIG;
+	const char *transportName = "spi";
+	const char *fault = NULL;
+	FILE *file;
+	time_t timeStamp;
+	struct timespec start;
+	struct timespec finish;
+	char logName[64];
+	long ms;
+	uint32_t transferErrors;
+	int failed;
+	int option;
+	int i;
+
+	while((option = getopt(argc, argv, "j:t:f:")) != -1)
+	{
+		if(option == 'j')
+		{
+			jigName = optarg;
+		}else if(option == 't' && (strcmp(optarg, "spi") == 0 || strcmp(optarg, "sim") == 0))
+		{
+			transportName = optarg;
+		}else if(option == 'f')
+		{
+			fault = optarg;
+		}else
+		{
+			printf("Usage: %s [-j jig] [-t spi|sim] [-f uut] [plan]\n", argv[0]);
+			return 1;
+		}
+	}
+	if(fault != NULL && strcmp(transportName, "sim") != 0)
+	{
+		printf("-f needs -t sim\n");
+		return 1;
+	}
+	if(optind < argc)
+	{
+		planName = argv[optind];
+	}
+
+	/* Read the jig and the test plan before touching the boards */
+	file = fopen(jigName, "r");
+	if(file == NULL)
+	{
+		printf("Could not open jig %s\n", jigName);
+		return 1;
+	}
+	if(!runnerLoad(&runner, file))
+	{
+		printf("Jig %s: error on line %d\n", jigName, runner.errorLine);
+		fclose(file);
+		return 1;
+	}
+	fclose(file);
+	file = fopen(planName, "r");
+	if(file == NULL)
+	{
+		printf("Could not open test plan %s\n", planName);
+		return 1;
+	}
+	if(!planLoad(&plan, file))
+	{
+		printf("Test plan %s: error on line %d\n", planName, plan.errorLine);
+		fclose(file);
+		return 1;
+	}
+	fclose(file);
+	if(!planCompile(&plan, &schedule))
+	{
+		printf("Test plan %s does not fit in %d operations\n", planName, AD5592_PLAN_OPS);
+		return 1;
+	}
+
+	if(strcmp(transportName, "sim") == 0)
+	{
+		if(!openSim(&runner, &sim, transport, bus, fault))
+		{
+			return 1;
+		}
+	}else if(!openBuses(&runner, transport, bus))
+	{
+		return 1;
+	}
+	if(!runnerAttach(&runner, bus))
+	{
+		return 1;
+	}
+
+	/* One log for the batch */
+	time(&timeStamp);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	strftime(logName, sizeof(logName), "LINE-%Y%m%d-%H%M%S.ad5592log", gmtime(&timeStamp));
+	if(!logOpen(&lineLog, logName, "AD5592 Snack line ATP"))
+	{
+		printf("Could not create %s\n", logName);
+		return 1;
+	}
+	printf("Test start time: %s", ctime(&timeStamp));
+	printf("Jig: %s, %d UUTs, %d waves\n", jigName, runner.uuts, runner.waves);
+	printf("Test plan: %s, %d steps, %d rounds, %d mode changes\n", planName,
+		plan.steps, schedule.rounds, schedule.modeChanges);
+
+	failed = runnerRun(&runner, &plan, &schedule, &lineLog, &settleStats);
+
+	time(&timeStamp);
+	clock_gettime(CLOCK_MONOTONIC, &finish);
+	ms = (finish.tv_sec - start.tv_sec) * 1000 + (finish.tv_nsec - start.tv_nsec) / 1000000;
+
+	printf("\n\n");
+	for(i = 0; i < runner.uuts; i++)
+	{
+		printf("%-16s %s  %d of %d checks failed\n", runner.uut[i].name,
+			runner.uut[i].failed ? "FAIL" : "PASS", runner.uut[i].failed, runner.uut[i].checks);
+	}
+	if(settleStats.count)
+	{
+		printf("Settling: %u waits, mean %u us, max %u us, %u timeouts\n", settleStats.count,
+			(unsigned)(settleStats.totalUs / settleStats.count), settleStats.maxUs, settleStats.timeouts);
+	}
+	printf("Rounds: %d, waiting to settle %ld ms\n", runner.rounds,
+		(long)(runner.settleNs / 1000000));
+	printf("Failed UUTs: %d of %d\n", failed, runner.uuts);
+	transferErrors = runner.reference.transferErrors;
+	for(i = 0; i < runner.uuts; i++)
+	{
+		transferErrors += runner.uut[i].dev.transferErrors;
+	}
+	if(transferErrors)
+	{
+		printf("Failed SPI transfers: %u\n", transferErrors);
+	}
+	if(strcmp(transportName, "sim") == 0)
+	{
+		printf("Simulated nets read while driven twice: %u\n", sim.contention);
+	}
+	printf("Test finish time: %s", ctime(&timeStamp));
+	printf("Test duration: %ld ms\n", ms);
+
+	logClose(&lineLog);
+	printf("Test log: %s\n", logName);
+	for(i = 0; i < AD5592_RUNNER_BUSES; i++)
+	{
+		if(bus[i] != NULL)
+		{
+			transportClose(bus[i]);
+		}
+	}
+	return failed || transferErrors || sim.contention ? 1 : 0;
+}
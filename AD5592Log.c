@@ -0,0 +1,342 @@
+/***********************************************************************
+ * File: AD5592Log.c
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Binary log of AD5592 samples and test results
+ * Dependancies:
+ * 		-AD5592Conv.h v1.0.0
+ * 		-AD5592Log.h
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- logNowNs() is replaced by clockNowNs() from AD5592Clock.h.
+ **********************************************************************/
+
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "AD5592Conv.h"
+#include "AD5592Log.h"
+#include "AD5592Clock.h"
+
+#define LOG_BUFFER	65536		/* stdio buffer for the log file */
+
+static const uint8_t logPadding[AD5592_LOG_ALIGN];	/* Zeros to pad records with */
+
+/**
+ * Create a log, replacing any file of the same name.
+ * Parameters:
+ * 	log = log to set up
+ * 	path = file name
+ * 	title = title stored in the header
+ * Returns:
+ * 	1 on success, 0 if the file could not be written
+ */
+int logOpen(AD5592_Log *log, const char *path, const char *title)
+{
+	AD5592_LogHeader header;
+
+	log->file = fopen(path, "wb");
+	if(log->file == NULL)
+	{
+		return 0;
+	}
+	setvbuf(log->file, NULL, _IOFBF, LOG_BUFFER);
+	log->startNs = clockNowNs();
+	log->records = 0;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, AD5592_LOG_MAGIC, sizeof(header.magic));
+	header.version = AD5592_LOG_VERSION;
+	header.byteOrder = AD5592_LOG_BYTE_ORDER;
+	header.fullScaleMv = AD5592_FULL_SCALE_MV;
+	header.startNs = log->startNs;
+	header.startSec = time(NULL);
+	strncpy(header.title, title, AD5592_LOG_TITLE - 1);
+	log->bytes = sizeof(header);
+	return fwrite(&header, sizeof(header), 1, log->file) == 1;
+}
+
+/**
+ * Write one record and its padding.
+ */
+static int logRecord(AD5592_Log *log, AD5592_LogRecord *record, const void *payload)
+{
+	size_t pad = (AD5592_LOG_ALIGN - record->size % AD5592_LOG_ALIGN) % AD5592_LOG_ALIGN;
+
+	log->records++;
+	log->bytes += sizeof(*record) + record->size + pad;
+	return fwrite(record, sizeof(*record), 1, log->file) == 1 &&
+		fwrite(payload, 1, record->size, log->file) == record->size &&
+		fwrite(logPadding, 1, pad, log->file) == pad;
+}
+
+/**
+ * Append ADC results from one sequence.
+ * Parameters:
+ * 	log = log
+ * 	board = chip select
+ * 	pins = pins in the sequence as bit mask
+ * 	startNs = CLOCK_MONOTONIC at the start of the transfer
+ * 	endNs = CLOCK_MONOTONIC at its end
+ * 	rxBuf[] = received result frames, MSB first
+ * 	frames = number of frames, up to AD5592_LOG_MAX_SAMPLES
+ * Returns:
+ * 	1 on success, 0 on a write error or too many frames
+ */
+int logSamples(AD5592_Log *log, uint8_t board, uint8_t pins, uint64_t startNs,
+	uint64_t endNs, const char rxBuf[], int frames)
+{
+	AD5592_LogRecord record;
+	AD5592_LogSamples *samples = (AD5592_LogSamples *)log->packed;
+	uint8_t *out = log->packed + sizeof(*samples);
+	const uint8_t *in = (const uint8_t *)rxBuf;
+	uint16_t a;
+	uint16_t b;
+	int i;
+
+	if(frames <= 0 || frames > AD5592_LOG_MAX_SAMPLES)
+	{
+		return 0;
+	}
+	record.type = AD5592_LOG_SAMPLES;
+	record.size = sizeof(*samples) + (frames * 3 + 1) / 2;
+	record.board = board;
+	record.pins = pins;
+	record.first = (in[0] >> 4) & 0x7;
+	record.kind = 0;
+	record.timeNs = startNs - log->startNs;
+	samples->spanNs = endNs - startNs;
+	samples->samples = frames;
+	samples->reserved = 0;
+
+	/* Two counts in three bytes */
+	for(i = 0; i + 1 < frames; i += 2)
+	{
+		a = ((in[2 * i] << 8) | in[2 * i + 1]) & AD5592_COUNT_MAX;
+		b = ((in[2 * i + 2] << 8) | in[2 * i + 3]) & AD5592_COUNT_MAX;
+		*out++ = a & 0xFF;
+		*out++ = (a >> 8) | ((b & 0xF) << 4);
+		*out++ = b >> 4;
+	}
+	if(i < frames)
+	{
+		a = ((in[2 * i] << 8) | in[2 * i + 1]) & AD5592_COUNT_MAX;
+		*out++ = a & 0xFF;
+		*out++ = a >> 8;
+	}
+	return logRecord(log, &record, log->packed);
+}
+
+/**
+ * Append a test result.
+ * Parameters:
+ * 	log = log
+ * 	board = chip select of the board measured
+ * 	kind = AD5592_LOG_ANALOG or AD5592_LOG_DIGITAL
+ * 	pins = pin number for analog, pin mask for digital
+ * 	name = step name
+ * 	target = count or states expected
+ * 	value = count or states read
+ * 	pass = 1 if the check passed
+ * Returns:
+ * 	1 on success, 0 on a write error
+ */
+int logResult(AD5592_Log *log, uint8_t board, uint8_t kind, uint8_t pins, const char *name,
+	uint16_t target, uint16_t value, uint8_t pass)
+{
+	AD5592_LogRecord record;
+	AD5592_LogResult result;
+
+	record.type = AD5592_LOG_RESULT;
+	record.size = sizeof(result);
+	record.board = board;
+	record.pins = pins;
+	record.first = 0;
+	record.kind = kind;
+	record.timeNs = clockNowNs() - log->startNs;
+	memset(&result, 0, sizeof(result));
+	result.target = target;
+	result.value = value;
+	result.pass = pass;
+	memcpy(result.name, name, strnlen(name, AD5592_LOG_NAME));
+	return logRecord(log, &record, &result);
+}
+
+/**
+ * Append text.
+ * Parameters:
+ * 	log = log
+ * 	text = terminated text
+ * Returns:
+ * 	1 on success, 0 on a write error
+ */
+int logText(AD5592_Log *log, const char *text)
+{
+	AD5592_LogRecord record;
+	size_t length = strlen(text);
+
+	memset(&record, 0, sizeof(record));
+	record.type = AD5592_LOG_TEXT;
+	record.size = length > 0xFFFF ? 0xFFFF : length;
+	record.timeNs = clockNowNs() - log->startNs;
+	return logRecord(log, &record, text);
+}
+
+/**
+ * Write out and close a log.
+ * Parameters:
+ * 	log = log
+ * Returns:
+ * 	1 on success, 0 on a write error
+ */
+int logClose(AD5592_Log *log)
+{
+	int ok = fclose(log->file) == 0;
+
+	log->file = NULL;
+	return ok;
+}
+
+/**
+ * Map a log for reading.
+ * Parameters:
+ * 	view = view to set up
+ * 	path = file name
+ * Returns:
+ * 	1 on success, 0 if the file is not a log this host can read
+ */
+int logMap(AD5592_LogView *view, const char *path)
+{
+	struct stat info;
+	void *base;
+	int fd = open(path, O_RDONLY);
+
+	view->base = NULL;
+	if(fd < 0)
+	{
+		return 0;
+	}
+	if(fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(AD5592_LogHeader))
+	{
+		close(fd);
+		return 0;
+	}
+	base = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(base == MAP_FAILED)
+	{
+		return 0;
+	}
+	view->base = base;
+	view->size = info.st_size;
+	view->pos = sizeof(AD5592_LogHeader);
+	view->header = base;
+
+	if(memcmp(view->header->magic, AD5592_LOG_MAGIC, sizeof(view->header->magic)) != 0 ||
+		view->header->version != AD5592_LOG_VERSION ||
+		view->header->byteOrder != AD5592_LOG_BYTE_ORDER)
+	{
+		logUnmap(view);
+		return 0;
+	}
+	return 1;
+}
+
+/**
+ * Get the next record of a mapped log.
+ * Parameters:
+ * 	view = view
+ * Returns:
+ * 	Record, its payload follows it, or NULL at the end or at a record
+ * 	cut short
+ */
+const AD5592_LogRecord *logNext(AD5592_LogView *view)
+{
+	const AD5592_LogRecord *record = (const AD5592_LogRecord *)(view->base + view->pos);
+	size_t length;
+
+	if(view->pos + sizeof(*record) > view->size)
+	{
+		return NULL;
+	}
+	length = sizeof(*record) + record->size;
+	if(view->pos + length > view->size)
+	{
+		return NULL;
+	}
+	view->pos += (length + AD5592_LOG_ALIGN - 1) & ~(size_t)(AD5592_LOG_ALIGN - 1);
+	return record;
+}
+
+/**
+ * Unpack one count of a samples record.
+ * Parameters:
+ * 	record = samples record
+ * 	i = sample number
+ * Returns:
+ * 	Count
+ */
+uint16_t logSampleCount(const AD5592_LogRecord *record, int i)
+{
+	const uint8_t *packed = (const uint8_t *)(record + 1) + sizeof(AD5592_LogSamples) + (i / 2) * 3;
+
+	if(i & 0x1)
+	{
+		return (packed[1] >> 4) | (packed[2] << 4);
+	}
+	return packed[0] | ((packed[1] & 0xF) << 8);
+}
+
+/**
+ * Work out the pin of one count of a samples record.
+ * Parameters:
+ * 	record = samples record
+ * 	i = sample number
+ * Returns:
+ * 	Pin number
+ */
+uint8_t logSamplePin(const AD5592_LogRecord *record, int i)
+{
+	uint8_t order[8];
+	int count = 0;
+	int start = 0;
+	int pin;
+
+	for(pin = 0; pin < 8; pin++)
+	{
+		if((record->pins >> pin) & 0x1)
+		{
+			if(pin == record->first)
+			{
+				start = count;
+			}
+			order[count++] = pin;
+		}
+	}
+	if(count == 0)
+	{
+		return record->first;
+	}
+	return order[(start + i) % count];
+}
+
+/**
+ * Unmap a log.
+ * Parameters:
+ * 	view = view
+ */
+void logUnmap(AD5592_LogView *view)
+{
+	if(view->base)
+	{
+		munmap((void *)view->base, view->size);
+		view->base = NULL;
+	}
+}
@@ -0,0 +1,253 @@
+/*********************************************************************
+ * File: AD5592Log.h
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Binary log of AD5592 samples and test results
+ * Dependancies:
+ * 		-AD5592Conv.h v1.0.0
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- logNowNs() is replaced by clockNowNs() from AD5592Clock.h.
+ *
+ * A log is an AD5592_LogHeader followed by records, each an
+ * AD5592_LogRecord and its payload padded to 8 bytes. Records are only
+ * ever appended. Every record starts 8 byte aligned so a mapped log can
+ * be walked in place with logNext(). Numbers are in the byte order of
+ * the host that wrote the log; byteOrder tells a reader which it is.
+ *
+ * Record payloads:
+ * 	AD5592_LOG_SAMPLES
+ * 		AD5592_LogSamples then the counts packed 12 bits each, two
+ * 		counts in three bytes, low count first. The samples are one ADC
+ * 		sequence over pins starting at pin first, as received from the
+ * 		board. timeNs is the start of the transfer and spanNs its length.
+ * 	AD5592_LOG_RESULT
+ * 		AD5592_LogResult. pins is the pin number for an analog check and
+ * 		the pin mask for a digital one.
+ * 	AD5592_LOG_TEXT
+ * 		Text, not terminated.
+ *
+ * AD5592LogDump converts a log to text or CSV.
+ **********************************************************************/
+
+#ifndef SOURCES_AD5592LOG_H_
+#define SOURCES_AD5592LOG_H_
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define AD5592_LOG_MAGIC		"AD5592L"	/* 8 bytes with the terminator */
+#define AD5592_LOG_VERSION		1
+#define AD5592_LOG_BYTE_ORDER	0x0102
+#define AD5592_LOG_ALIGN		8			/* Record alignment */
+#define AD5592_LOG_MAX_SAMPLES	4096		/* Samples in one record */
+#define AD5592_LOG_NAME			16			/* Longest result name */
+#define AD5592_LOG_TITLE		32			/* Longest log title */
+
+/**
+ * Record types.
+ */
+#define AD5592_LOG_SAMPLES		1
+#define AD5592_LOG_RESULT		2
+#define AD5592_LOG_TEXT			3
+
+/**
+ * Result kinds.
+ */
+#define AD5592_LOG_ANALOG		0
+#define AD5592_LOG_DIGITAL		1
+
+/**
+ * Start of a log.
+ */
+typedef struct
+{
+	char magic[8];						/* AD5592_LOG_MAGIC */
+	uint16_t version;					/* AD5592_LOG_VERSION */
+	uint16_t byteOrder;					/* AD5592_LOG_BYTE_ORDER as written */
+	uint32_t fullScaleMv;				/* Millivolts of a full scale count */
+	uint64_t startNs;					/* CLOCK_MONOTONIC at logOpen(), record times count from here */
+	int64_t startSec;					/* Wall clock at logOpen(), seconds since 1970 */
+	char title[AD5592_LOG_TITLE];		/* Terminated title */
+} AD5592_LogHeader;
+
+/**
+ * Start of a record.
+ */
+typedef struct
+{
+	uint16_t type;			/* AD5592_LOG_ */
+	uint16_t size;			/* Payload bytes before padding */
+	uint8_t board;			/* Chip select */
+	uint8_t pins;			/* Pin mask, or pin number for analog results */
+	uint8_t first;			/* Pin of the first sample */
+	uint8_t kind;			/* AD5592_LOG_ANALOG or AD5592_LOG_DIGITAL for results */
+	uint64_t timeNs;		/* Nanoseconds after startNs */
+} AD5592_LogRecord;
+
+/**
+ * Samples record payload.
+ */
+typedef struct
+{
+	uint32_t spanNs;		/* Length of the transfer */
+	uint16_t samples;		/* Counts that follow */
+	uint16_t reserved;
+} AD5592_LogSamples;
+
+/**
+ * Result record payload.
+ */
+typedef struct
+{
+	uint16_t target;				/* Count or pin states expected */
+	uint16_t value;					/* Count or pin states read */
+	uint8_t pass;					/* 1 if the check passed */
+	uint8_t reserved[3];
+	char name[AD5592_LOG_NAME];		/* Step name, terminated if shorter */
+} AD5592_LogResult;
+
+_Static_assert(sizeof(AD5592_LogHeader) == 64, "log header layout");
+_Static_assert(sizeof(AD5592_LogRecord) == 16, "log record layout");
+_Static_assert(sizeof(AD5592_LogSamples) == 8, "log samples layout");
+_Static_assert(sizeof(AD5592_LogResult) == 24, "log result layout");
+
+/**
+ * A log being written.
+ */
+typedef struct
+{
+	FILE *file;							/* Log file */
+	uint64_t startNs;					/* CLOCK_MONOTONIC at logOpen() */
+	uint32_t records;					/* Records written */
+	uint64_t bytes;						/* Bytes written */
+	uint8_t packed[(AD5592_LOG_MAX_SAMPLES * 3 + 1) / 2 + AD5592_LOG_ALIGN];	/* Record staging */
+} AD5592_Log;
+
+/**
+ * A log mapped for reading.
+ */
+typedef struct
+{
+	const uint8_t *base;				/* Mapped file */
+	size_t size;						/* File size */
+	size_t pos;							/* Offset of the next record */
+	const AD5592_LogHeader *header;		/* Header */
+} AD5592_LogView;
+
+/**
+ * Create a log, replacing any file of the same name.
+ * Parameters:
+ * 	log = log to set up
+ * 	path = file name
+ * 	title = title stored in the header
+ * Returns:
+ * 	1 on success, 0 if the file could not be written
+ */
+int logOpen(AD5592_Log *log, const char *path, const char *title);
+
+/**
+ * Append ADC results from one sequence.
+ * Parameters:
+ * 	log = log
+ * 	board = chip select
+ * 	pins = pins in the sequence as bit mask
+ * 	startNs = CLOCK_MONOTONIC at the start of the transfer
+ * 	endNs = CLOCK_MONOTONIC at its end
+ * 	rxBuf[] = received result frames, MSB first
+ * 	frames = number of frames, up to AD5592_LOG_MAX_SAMPLES
+ * Returns:
+ * 	1 on success, 0 on a write error or too many frames
+ */
+int logSamples(AD5592_Log *log, uint8_t board, uint8_t pins, uint64_t startNs,
+	uint64_t endNs, const char rxBuf[], int frames);
+
+/**
+ * Append a test result.
+ * Parameters:
+ * 	log = log
+ * 	board = chip select of the board measured
+ * 	kind = AD5592_LOG_ANALOG or AD5592_LOG_DIGITAL
+ * 	pins = pin number for analog, pin mask for digital
+ * 	name = step name
+ * 	target = count or states expected
+ * 	value = count or states read
+ * 	pass = 1 if the check passed
+ * Returns:
+ * 	1 on success, 0 on a write error
+ */
+int logResult(AD5592_Log *log, uint8_t board, uint8_t kind, uint8_t pins, const char *name,
+	uint16_t target, uint16_t value, uint8_t pass);
+
+/**
+ * Append text.
+ * Parameters:
+ * 	log = log
+ * 	text = terminated text
+ * Returns:
+ * 	1 on success, 0 on a write error
+ */
+int logText(AD5592_Log *log, const char *text);
+
+/**
+ * Write out and close a log.
+ * Parameters:
+ * 	log = log
+ * Returns:
+ * 	1 on success, 0 on a write error
+ */
+int logClose(AD5592_Log *log);
+
+/**
+ * Map a log for reading.
+ * Parameters:
+ * 	view = view to set up
+ * 	path = file name
+ * Returns:
+ * 	1 on success, 0 if the file is not a log this host can read
+ */
+int logMap(AD5592_LogView *view, const char *path);
+
+/**
+ * Get the next record of a mapped log.
+ * Parameters:
+ * 	view = view
+ * Returns:
+ * 	Record, its payload follows it, or NULL at the end or at a record
+ * 	cut short
+ */
+const AD5592_LogRecord *logNext(AD5592_LogView *view);
+
+/**
+ * Unpack one count of a samples record.
+ * Parameters:
+ * 	record = samples record
+ * 	i = sample number
+ * Returns:
+ * 	Count
+ */
+uint16_t logSampleCount(const AD5592_LogRecord *record, int i);
+
+/**
+ * Work out the pin of one count of a samples record.
+ * Parameters:
+ * 	record = samples record
+ * 	i = sample number
+ * Returns:
+ * 	Pin number
+ */
+uint8_t logSamplePin(const AD5592_LogRecord *record, int i);
+
+/**
+ * Unmap a log.
+ * Parameters:
+ * 	view = view
+ */
+void logUnmap(AD5592_LogView *view);
+
+#endif /* SOURCES_AD5592LOG_H_ */
@@ -0,0 +1,177 @@
+/**
+ * File: AD5592LogDump.c
+ * Target: Raspberry Pi or any Linux host
+ * Function: Converts AD5592 binary logs to text or CSV
+ * Dependancies:
+ * 		-AD5592Log.h v1.0.0
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version: 1.0.0:
+ * 		-Usage: AD5592LogDump [-c] log
+ * 		Prints every record of the log in file order, one line per
+ * 		sample, result or text record. Sample times are spread evenly
+ * 		over the transfer they came from. -c prints CSV with the
+ * 		columns:
+ * 			time_s,record,board,pin,name,target,value,pass,mv,text
+ *
+ * 		-Builds on its own with AD5592Log.c:
+ * 			gcc -O2 -o AD5592LogDump AD5592LogDump.c AD5592Log.c
+ *
+ **********************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "AD5592Log.h"
+
+/**
+ * Convert a count to millivolts with the full scale the log was
+ * written with.
+ */
+static unsigned countToMv(const AD5592_LogView *view, uint16_t count)
+{
+	return ((uint32_t)count * view->header->fullScaleMv + 2048) >> 12;
+}
+
+/**
+ * Print the samples of one record.
+ */
+static void dumpSamples(const AD5592_LogView *view, const AD5592_LogRecord *record, int csv)
+{
+	const AD5592_LogSamples *samples = (const AD5592_LogSamples *)(record + 1);
+	double time;
+	uint16_t count;
+	uint8_t pin;
+	int i;
+
+	for(i = 0; i < samples->samples; i++)
+	{
+		time = (record->timeNs + (double)samples->spanNs * i / samples->samples) / 1e9;
+		count = logSampleCount(record, i);
+		pin = logSamplePin(record, i);
+		if(csv)
+		{
+			printf("%.9f,sample,%d,%d,,,%d,,%u,\n", time, record->board, pin, count,
+				countToMv(view, count));
+		}else
+		{
+			printf("%14.9f CS%d IO%d %4d %5u mV\n", time, record->board, pin, count,
+				countToMv(view, count));
+		}
+	}
+}
+
+/**
+ * Print one result record.
+ */
+static void dumpResult(const AD5592_LogRecord *record, int csv)
+{
+	const AD5592_LogResult *result = (const AD5592_LogResult *)(record + 1);
+	double time = record->timeNs / 1e9;
+	const char *verdict = result->pass ? "PASS" : "FAIL";
+
+	if(csv)
+	{
+		printf("%.9f,result,%d,%d,%.*s,%d,%d,%s,,\n", time, record->board, record->pins,
+			AD5592_LOG_NAME, result->name, result->target, result->value, verdict);
+	}else if(record->kind == AD5592_LOG_DIGITAL)
+	{
+		printf("%14.9f CS%d %.*s test on pins %02x target = %x value = %x ... %s\n", time,
+			record->board, AD5592_LOG_NAME, result->name, record->pins, result->target,
+			result->value, verdict);
+	}else
+	{
+		printf("%14.9f CS%d %.*s test on IO%d target = %d value = %d ... %s\n", time,
+			record->board, AD5592_LOG_NAME, result->name, record->pins, result->target,
+			result->value, verdict);
+	}
+}
+
+/**
+ * Print one text record. CSV text is quoted with quotes doubled.
+ */
+static void dumpText(const AD5592_LogRecord *record, int csv)
+{
+	const char *text = (const char *)(record + 1);
+	int i;
+
+	if(!csv)
+	{
+		printf("%14.9f %.*s\n", record->timeNs / 1e9, record->size, text);
+		return;
+	}
+	printf("%.9f,text,,,,,,,,\"", record->timeNs / 1e9);
+	for(i = 0; i < record->size; i++)
+	{
+		if(text[i] == '"')
+		{
+			putchar('"');
+		}
+		putchar(text[i]);
+	}
+	printf("\"\n");
+}
+
+int main(int argc, char **argv)
+{
+	AD5592_LogView view;
+	const AD5592_LogRecord *record;
+	time_t start;
+	int csv = 0;
+	int option;
+
+	while((option = getopt(argc, argv, "c")) != -1)
+	{
+		if(option == 'c')
+		{
+			csv = 1;
+		}else
+		{
+			fprintf(stderr, "Usage: AD5592LogDump [-c] log\n");
+			return 1;
+		}
+	}
+	if(optind >= argc)
+	{
+		fprintf(stderr, "Usage: AD5592LogDump [-c] log\n");
+		return 1;
+	}
+	if(!logMap(&view, argv[optind]))
+	{
+		fprintf(stderr, "%s is not an AD5592 log this host can read\n", argv[optind]);
+		return 1;
+	}
+
+	start = view.header->startSec;
+	if(csv)
+	{
+		printf("time_s,record,board,pin,name,target,value,pass,mv,text\n");
+	}else
+	{
+		printf("%.*s, started %s", AD5592_LOG_TITLE, view.header->title, ctime(&start));
+	}
+
+	while((record = logNext(&view)) != NULL)
+	{
+		switch(record->type)
+		{
+			case AD5592_LOG_SAMPLES:
+				dumpSamples(&view, record, csv);
+				break;
+			case AD5592_LOG_RESULT:
+				dumpResult(record, csv);
+				break;
+			case AD5592_LOG_TEXT:
+				dumpText(record, csv);
+				break;
+		}
+	}
+	if(view.pos < view.size)
+	{
+		fprintf(stderr, "%s: last record cut short\n", argv[optind]);
+	}
+	logUnmap(&view);
+	return 0;
+}
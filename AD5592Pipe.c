@@ -0,0 +1,340 @@
+/***********************************************************************
+ * File: AD5592Pipe.c
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Pipelined command engine for the AD5592 device driver
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Pipe.h
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- pipeSetAnalogOut() leaves LDAC hold mode first.
+ * 	* Version 1.1.0: 16 October 2026
+ * 		- pipeFlush() returns whether the transfer worked and stores no
+ * 			results when it failed.
+ * 		- Pin selects are only taken as set when the shadow is known.
+ **********************************************************************/
+
+#include <string.h>
+#include "AD5592Pipe.h"
+
+/**
+ * Empty the pipe without sending anything.
+ */
+static void pipeClear(AD5592_Pipe *pipe)
+{
+	memset(pipe->kind, AD5592_PIPE_NONE, sizeof(pipe->kind));
+	pipe->next = 0;
+	pipe->count = 0;
+	pipe->adcLast = -1;
+	pipe->claimed = -1;
+}
+
+/**
+ * Put a command in a frame. Frames skipped over get AD5592_NOP.
+ */
+static void pipePlace(AD5592_Pipe *pipe, int frame, AD5592_WORD command)
+{
+	while(pipe->count < frame)
+	{
+		makeWord(&pipe->txBuf[2 * pipe->count], AD5592_NOP);
+		pipe->count++;
+	}
+	makeWord(&pipe->txBuf[2 * frame], command);
+	pipe->count = frame + 1;
+}
+
+/**
+ * Mark a frame as carrying a result.
+ */
+static void pipeClaim(AD5592_Pipe *pipe, int frame, uint8_t kind, void *dest)
+{
+	pipe->kind[frame] = kind;
+	pipe->dest[frame] = dest;
+	if(frame > pipe->claimed)
+	{
+		pipe->claimed = frame;
+	}
+}
+
+/**
+ * Get the first frame at or after a frame with room for more frames
+ * after it. Flushes the pipe when there is no room left.
+ */
+static int pipeRoom(AD5592_Pipe *pipe, int frame, int after)
+{
+	if(frame + after >= AD5592_PIPE_FRAMES)
+	{
+		pipeFlush(pipe);
+		return 0;
+	}
+	return frame;
+}
+
+/**
+ * Queue a read. The read goes in the frame carrying the last
+ * conversion result or later and its result comes out in the next
+ * frame.
+ */
+static void pipeQueueRead(AD5592_Pipe *pipe, AD5592_WORD command, uint8_t kind, void *dest)
+{
+	int frame = pipe->next;
+
+	deviceUpdate(pipe->dev, command);	/* Keep the shadow in step */
+	if(frame < pipe->adcLast)
+	{
+		frame = pipe->adcLast;
+	}
+	frame = pipeRoom(pipe, frame, 1);
+	pipePlace(pipe, frame, command);
+	pipeClaim(pipe, frame + 1, kind, dest);
+	pipe->next = frame + 1;
+}
+
+/**
+ * Set up an empty pipe for a board.
+ * Parameters:
+ * 	pipe = pipe to set up
+ * 	dev = board the pipe is sent to
+ */
+void pipeInit(AD5592_Pipe *pipe, AD5592_Device *dev)
+{
+	pipe->dev = dev;
+	pipe->flushes = 0;
+	pipe->frames = 0;
+	pipeClear(pipe);
+}
+
+/**
+ * Queue a write unless the board shadow shows it would not change
+ * anything. Data writes go in the next free frame, even one inside a
+ * running ADC sequence. Anything else waits for the sequence to finish,
+ * and a reset or sequence write also waits for every pending read
+ * because it drops the word the board was about to send.
+ * Parameters:
+ * 	pipe = pipe to add to
+ * 	command = AD5592 word
+ * Returns:
+ * 	1 if the word was queued, 0 if it was skipped
+ */
+int pipeWrite(AD5592_Pipe *pipe, AD5592_WORD command)
+{
+	int reg = AD5592_REG_INDEX(command);
+	int frame = pipe->next;
+
+	if(!deviceUpdate(pipe->dev, command))
+	{
+		return 0;
+	}
+
+	if(!(command & AD5592_DAC_WRITE_MASK) &&
+		reg != AD5592_REG_INDEX(AD5592_GPIO_WRITE_DATA) &&
+		reg != AD5592_REG_INDEX(AD5592_NOP))
+	{
+		if(reg == AD5592_REG_INDEX(AD5592_ADC_READ) || reg == AD5592_REG_INDEX(AD5592_SW_RESET))
+		{
+			if(frame < pipe->claimed)
+			{
+				frame = pipe->claimed;
+			}
+		}else if(frame < pipe->adcLast)
+		{
+			frame = pipe->adcLast;
+		}
+	}
+
+	frame = pipeRoom(pipe, frame, 0);
+	pipePlace(pipe, frame, command);
+	pipe->next = frame + 1;
+	return 1;
+}
+
+/**
+ * Queue a read whose result comes out in the next frame.
+ * Parameters:
+ * 	pipe = pipe to add to
+ * 	command = GPIO read input, DAC readback or control register readback
+ * 	result = where the received word is stored by pipeFlush()
+ */
+void pipeRead(AD5592_Pipe *pipe, AD5592_WORD command, AD5592_WORD *result)
+{
+	pipeQueueRead(pipe, command, AD5592_PIPE_RAW, result);
+}
+
+/**
+ * Make every command queued after this wait until all outstanding
+ * results are out.
+ * Parameters:
+ * 	pipe = pipe
+ */
+void pipeFence(AD5592_Pipe *pipe)
+{
+	if(pipe->next <= pipe->claimed)
+	{
+		pipe->next = pipe->claimed + 1;
+	}
+}
+
+/**
+ * Send the queued frames and store the results.
+ * Parameters:
+ * 	pipe = pipe to send
+ * Returns:
+ * 	1 on success or with nothing to send, 0 if the transfer failed
+ */
+int pipeFlush(AD5592_Pipe *pipe)
+{
+	int frames = pipe->count;
+	AD5592_WORD word;
+	int i;
+
+	if(frames <= pipe->claimed)
+	{
+		frames = pipe->claimed + 1;
+		pipePlace(pipe, frames - 1, AD5592_NOP);
+	}
+	if(frames == 0)
+	{
+		return 1;
+	}
+
+	pipe->flushes++;
+	pipe->frames += frames;
+	if(!deviceTransfer(pipe->dev, pipe->txBuf, pipe->rxBuf, frames))
+	{
+		/* Nothing received, so every destination keeps its value */
+		pipeClear(pipe);
+		return 0;
+	}
+
+	for(i = 0; i < frames; i++)
+	{
+		if(pipe->kind[i] == AD5592_PIPE_NONE)
+		{
+			continue;
+		}
+		word = ((uint8_t)pipe->rxBuf[2 * i] << 8) | (uint8_t)pipe->rxBuf[2 * i + 1];
+		switch(pipe->kind[i])
+		{
+			case AD5592_PIPE_RAW:
+				*(AD5592_WORD *)pipe->dest[i] = word;
+				break;
+			case AD5592_PIPE_DIGITAL:
+				*(uint8_t *)pipe->dest[i] = word & AD5592_PIN_SELECT_MASK;
+				break;
+			case AD5592_PIPE_ANALOG:
+				((uint16_t *)pipe->dest[i])[(word & AD5592_ADC_ADDRESS_MASK) >> 12] =
+					d2a(word & AD5592_ADC_VALUE_MASK);
+				break;
+		}
+	}
+
+	pipeClear(pipe);
+	return 1;
+}
+
+/**
+ * Set a pin to high or low output.
+ * Parameters:
+ * 	All pins with a digital output as bit mask
+ * 	State to be output to all digital out pins as bit mask
+ */
+void pipeSetDigitalOut(AD5592_Pipe *pipe, uint8_t pins, uint8_t states)
+{
+	uint8_t digitalOutPins = deviceRegister(pipe->dev, AD5592_GPIO_WRITE_CONFIG);
+
+	if(!deviceKnown(pipe->dev, AD5592_GPIO_WRITE_CONFIG) || !(pins == digitalOutPins))
+	{
+		pipeWrite(pipe, AD5592_GPIO_WRITE_CONFIG | pins | digitalOutPins);
+	}
+	pipeWrite(pipe, AD5592_GPIO_WRITE_DATA | states);
+}
+
+/**
+ * Get the digital input states.
+ * Parameters:
+ * 	All pins to be configured as digital inputs as bit mask
+ * 	states = where the pin states are stored by pipeFlush()
+ */
+void pipeGetDigitalIn(AD5592_Pipe *pipe, uint8_t pins, uint8_t *states)
+{
+	uint8_t digitalInPins = deviceRegister(pipe->dev, AD5592_GPIO_READ_CONFIG);
+
+	if(!deviceKnown(pipe->dev, AD5592_GPIO_READ_CONFIG) || !(pins == digitalInPins))
+	{
+		pipeWrite(pipe, AD5592_GPIO_READ_CONFIG | pins | digitalInPins);
+	}
+	pipeQueueRead(pipe, AD5592_GPIO_READ_INPUT | pins, AD5592_PIPE_DIGITAL, states);
+}
+
+/**
+ * Set an analog output value
+ * Parameters:
+ * 	Pin number to write to as number (0 to 7)
+ *  Value to write in milivolts (assumes 5V reference)
+ */
+void pipeSetAnalogOut(AD5592_Pipe *pipe, uint8_t pin, uint16_t milivolts)
+{
+	uint8_t analogOutPins = deviceRegister(pipe->dev, AD5592_DAC_PIN_SELECT);
+
+	if(!deviceKnown(pipe->dev, AD5592_DAC_PIN_SELECT) || !((analogOutPins >> pin ) & 0x1))
+	{
+		pipeWrite(pipe, AD5592_DAC_PIN_SELECT | analogOutPins | (0x1 << pin));
+	}
+	/* Leave hold mode so the write reaches the pin */
+	pipeWrite(pipe, AD5592_CNTRL_REG_READBACK | AD5592_LDAC_IMMEDIATE);
+	pipeWrite(pipe, AD5592_DAC_WRITE_MASK | 	/* DAC write command */
+	((pin <<12) & AD5592_DAC_ADDRESS_MASK)|		/* Set which pin to write */
+	a2d(milivolts));							/* Load digital value */
+}
+
+/**
+ * Get analog input values for several pins with one ADC sequence. The
+ * sequence write waits for every pending result. The n frames after it
+ * are left free for data writes and the results come out in the n
+ * frames after those.
+ * Parameters:
+ * 	Pins to read as bit mask
+ * 	milivolts[] = 8 entry array indexed by pin number. Only the
+ * 		requested pins are written by pipeFlush(). (assumes 5V reference)
+ */
+void pipeGetAnalogIn(AD5592_Pipe *pipe, uint8_t pins, uint16_t milivolts[])
+{
+	uint8_t analogInPins = deviceRegister(pipe->dev, AD5592_ADC_PIN_SELECT);
+	AD5592_WORD sequence = AD5592_ADC_READ | pins;
+	int channels = 0;
+	int frame;
+	int i;
+
+	if(pins == 0x00)
+	{
+		return;
+	}
+	if(!deviceKnown(pipe->dev, AD5592_ADC_PIN_SELECT) || (analogInPins & pins) != pins)
+	{
+		pipeWrite(pipe, AD5592_ADC_PIN_SELECT | analogInPins | pins);
+	}
+	for(i = 0; i < 8; i++)
+	{
+		channels += (pins >> i) & 0x1;
+	}
+
+	deviceUpdate(pipe->dev, sequence);	/* Keep the shadow in step */
+	frame = pipe->next;
+	if(frame < pipe->claimed)
+	{
+		frame = pipe->claimed;
+	}
+	frame = pipeRoom(pipe, frame, channels + 1);
+	pipePlace(pipe, frame, sequence);
+	for(i = 0; i < channels; i++)
+	{
+		pipeClaim(pipe, frame + 2 + i, AD5592_PIPE_ANALOG, milivolts);
+	}
+	pipe->adcLast = frame + channels + 1;
+	pipe->next = frame + 1;
+}
@@ -0,0 +1,156 @@
+/*********************************************************************
+ * File: AD5592Pipe.h
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Pipelined command engine for the AD5592 device driver
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.1.0: 16 October 2026
+ * 		- pipeFlush() returns 1 or 0 for success or failure instead of a
+ * 			frame count. Results are not stored when it fails.
+ *
+ * The AD5592 clocks out the result of a read during a later frame. The
+ * unpipelined functions fill those frames with AD5592_NOP. A pipe
+ * schedules commands as they are queued and puts the next command in
+ * the frame that would have carried a NOP, remembering which frame
+ * carries each result. Nothing moves on the bus until pipeFlush().
+ *
+ * Scheduling rules:
+ * 	- A read (GPIO input, DAC or control register readback) gets its
+ * 		result in the next frame. A read may go in the frame that
+ * 		carries the result of the read before it.
+ * 	- An ADC read writes the sequence register and the results come
+ * 		out 2 to n + 1 frames later. DAC and GPIO data writes queued
+ * 		after it fill the n frames in between.
+ * 	- Reads and every other command wait until the last conversion
+ * 		result is on its way out, so nothing disturbs the sequence.
+ *
+ * A data write queued after an ADC read can take effect while later
+ * channels of that read are still converting. Call pipeFence() between
+ * them when a conversion must not see the write.
+ **********************************************************************/
+
+#ifndef SOURCES_AD5592PIPE_H_
+#define SOURCES_AD5592PIPE_H_
+
+#include "AD5592RPI.h"
+
+/**
+ * Maximum number of 16 bit frames in one flush. A pipe that runs out
+ * of room flushes itself.
+ */
+#define AD5592_PIPE_FRAMES	128
+
+/**
+ * How a result frame is stored when the pipe is flushed.
+ */
+#define AD5592_PIPE_NONE	0	/* Nothing to store */
+#define AD5592_PIPE_RAW		1	/* AD5592_WORD as received */
+#define AD5592_PIPE_DIGITAL	2	/* uint8_t pin states */
+#define AD5592_PIPE_ANALOG	3	/* uint16_t milivolts[8] indexed by the result address */
+
+/**
+ * A pipe of AD5592 frames for one board.
+ */
+typedef struct
+{
+	AD5592_Device *dev;						/* Board the pipe is sent to */
+	char txBuf[2 * AD5592_PIPE_FRAMES];		/* Frames to send, MSB first */
+	char rxBuf[2 * AD5592_PIPE_FRAMES];		/* Frames received, MSB first */
+	void *dest[AD5592_PIPE_FRAMES];			/* Where each received frame goes */
+	uint8_t kind[AD5592_PIPE_FRAMES];		/* AD5592_PIPE_ storage of each frame */
+	int next;								/* First frame free for a command */
+	int count;								/* Frames holding a command */
+	int adcLast;							/* Frame of the last outstanding conversion result */
+	int claimed;							/* Frames up to here carry results */
+	uint32_t flushes;						/* Calls to deviceTransfer() */
+	uint32_t frames;						/* Frames sent */
+} AD5592_Pipe;
+
+/**
+ * Set up an empty pipe for a board.
+ * Parameters:
+ * 	pipe = pipe to set up
+ * 	dev = board the pipe is sent to
+ */
+void pipeInit(AD5592_Pipe *pipe, AD5592_Device *dev);
+
+/**
+ * Queue a write unless the board shadow shows it would not change
+ * anything. Reads must go through pipeRead().
+ * Parameters:
+ * 	pipe = pipe to add to
+ * 	command = AD5592 word
+ * Returns:
+ * 	1 if the word was queued, 0 if it was skipped
+ */
+int pipeWrite(AD5592_Pipe *pipe, AD5592_WORD command);
+
+/**
+ * Queue a read whose result comes out in the next frame.
+ * Parameters:
+ * 	pipe = pipe to add to
+ * 	command = GPIO read input, DAC readback or control register readback
+ * 	result = where the received word is stored by pipeFlush()
+ */
+void pipeRead(AD5592_Pipe *pipe, AD5592_WORD command, AD5592_WORD *result);
+
+/**
+ * Make every command queued after this wait until all outstanding
+ * results are out.
+ * Parameters:
+ * 	pipe = pipe
+ */
+void pipeFence(AD5592_Pipe *pipe);
+
+/**
+ * Send the queued frames with one call to deviceTransfer() and store
+ * the results. The pipe is empty afterwards. When the transfer fails
+ * no result is stored, so every destination keeps what it held, and
+ * the board's shadow registers are no longer trusted.
+ * Parameters:
+ * 	pipe = pipe to send
+ * Returns:
+ * 	1 on success or with nothing to send, 0 if the transfer failed
+ */
+int pipeFlush(AD5592_Pipe *pipe);
+
+/**
+ * Pipelined setDigitalOut().
+ * Parameters:
+ * 	All pins with a digital output as bit mask
+ * 	State to be output to all digital out pins as bit mask
+ */
+void pipeSetDigitalOut(AD5592_Pipe *pipe, uint8_t pins, uint8_t states);
+
+/**
+ * Pipelined getDigitalIn().
+ * Parameters:
+ * 	All pins to be configured as digital inputs as bit mask
+ * 	states = where the pin states are stored by pipeFlush()
+ */
+void pipeGetDigitalIn(AD5592_Pipe *pipe, uint8_t pins, uint8_t *states);
+
+/**
+ * Pipelined setAnalogOut().
+ * Parameters:
+ * 	Pin number to write to as number (0 to 7)
+ *  Value to write in milivolts (assumes 5V reference)
+ */
+void pipeSetAnalogOut(AD5592_Pipe *pipe, uint8_t pin, uint16_t milivolts);
+
+/**
+ * Pipelined getAnalogInMulti() without repeat mode.
+ * Parameters:
+ * 	Pins to read as bit mask
+ * 	milivolts[] = 8 entry array indexed by pin number. Only the
+ * 		requested pins are written by pipeFlush(). (assumes 5V reference)
+ */
+void pipeGetAnalogIn(AD5592_Pipe *pipe, uint8_t pins, uint16_t milivolts[]);
+
+#endif /* SOURCES_AD5592PIPE_H_ */
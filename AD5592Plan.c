@@ -0,0 +1,643 @@
+/***********************************************************************
+ * File: AD5592Plan.c
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Test plans for the AD5592 Snack board ATP
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Batch.h v1.1.0
+ * 		-AD5592Timing.h v1.0.0
+ * 		-AD5592Log.h v1.0.0
+ * 		-AD5592Plan.h
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.1.0: 16 October 2026
+ * 		- Settle times default to the datasheet minimums and are waited
+ * 			with timingWaitUs().
+ * 		- Added the settle stable statement. planRun() records the
+ * 			settling times.
+ * 	* Version 1.2.0: 16 October 2026
+ * 		- planRun() records checks in a binary AD5592_Log instead of
+ * 			a text file.
+ * 	* Version 1.2.1: 16 October 2026
+ * 		- Analog checks pass only when the count is less than the
+ * 			tolerance from the target, as in the original ATP. The
+ * 			1.0.0 check let one more count through either way.
+ **********************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "AD5592Batch.h"
+#include "AD5592Plan.h"
+
+#define LINE_LENGTH		256		/* Longest plan file line */
+#define BOARDS			2		/* Boards a plan can use */
+
+/**
+ * Steps that share a kind, driver and measurer.
+ */
+typedef struct
+{
+	uint8_t kind;
+	uint8_t driver;
+	uint8_t measurer;
+	uint8_t pins;					/* Pins of every step in the group */
+	int steps;
+	int step[AD5592_PLAN_STEPS];	/* Step indexes in file order */
+	uint8_t done;					/* Already scheduled */
+} PlanGroup;
+
+/**
+ * Parse a number token.
+ * Returns:
+ * 	1 on success, 0 if the token is missing or not a number
+ */
+static int planNumber(const char *token, long *value)
+{
+	char *end;
+
+	if(token == NULL)
+	{
+		return 0;
+	}
+	*value = strtol(token, &end, 0);
+	return *end == '\0';
+}
+
+/**
+ * Parse a board name.
+ * Returns:
+ * 	Channel, or -1 if the name is not a board
+ */
+static int planBoard(const char *token)
+{
+	if(token == NULL)
+	{
+		return -1;
+	}
+	if(strcmp(token, "test") == 0)
+	{
+		return CHANNEL0;
+	}
+	if(strcmp(token, "uut") == 0)
+	{
+		return CHANNEL1;
+	}
+	return -1;
+}
+
+/**
+ * Parse the part of a step line after the keyword.
+ * Returns:
+ * 	1 on success, 0 on a syntax error
+ */
+static int planStep(AD5592_PlanStep *step, uint8_t kind, int sweep, uint16_t tolerance)
+{
+	char *name = strtok(NULL, " \t\r\n");
+	int driver = planBoard(strtok(NULL, " \t\r\n"));
+	int measurer = planBoard(strtok(NULL, " \t\r\n"));
+	long from;
+	long to;
+	long by;
+	long value;
+	char *token;
+
+	if(name == NULL || driver < 0 || measurer < 0 || driver == measurer ||
+		!planNumber(strtok(NULL, " \t\r\n"), &value) || value <= 0 || value > 0xFF)
+	{
+		return 0;
+	}
+	strncpy(step->name, name, AD5592_PLAN_NAME - 1);
+	step->name[AD5592_PLAN_NAME - 1] = '\0';
+	step->kind = kind;
+	step->driver = driver;
+	step->measurer = measurer;
+	step->pins = value;
+	step->tolerance = tolerance;
+	step->levels = 0;
+
+	if(sweep)
+	{
+		if(!planNumber(strtok(NULL, " \t\r\n"), &from) ||
+			!planNumber(strtok(NULL, " \t\r\n"), &to) ||
+			!planNumber(strtok(NULL, " \t\r\n"), &by) ||
+			from < 0 || to > 0xFFFF || by <= 0 || from > to)
+		{
+			return 0;
+		}
+		for(value = from; value <= to; value += by)
+		{
+			if(step->levels == AD5592_PLAN_LEVELS)
+			{
+				return 0;
+			}
+			step->level[step->levels++] = value;
+		}
+		return 1;
+	}
+
+	while((token = strtok(NULL, " \t\r\n")) != NULL)
+	{
+		if(!planNumber(token, &value) || value < 0 || value > 0xFFFF ||
+			step->levels == AD5592_PLAN_LEVELS)
+		{
+			return 0;
+		}
+		step->level[step->levels++] = value;
+	}
+	return step->levels > 0;
+}
+
+/**
+ * Read a plan file.
+ * Parameters:
+ * 	plan = plan to fill in
+ * 	file = open plan file
+ * Returns:
+ * 	1 on success, 0 on a syntax error with plan->errorLine set
+ */
+int planLoad(AD5592_Plan *plan, FILE *file)
+{
+	char line[LINE_LENGTH];
+	uint16_t tolerance = AD5592_PLAN_TOLERANCE;
+	int number = 0;
+	int ok;
+	char *keyword;
+	char *comment;
+	long value;
+
+	plan->steps = 0;
+	plan->settleModeUs = AD5592_SETTLE_MODE_US;
+	plan->settleDacUs = AD5592_SETTLE_DAC_US;
+	plan->stableCounts = 0;
+	plan->stableTimeoutUs = 0;
+	plan->errorLine = 0;
+
+	while(fgets(line, sizeof(line), file) != NULL)
+	{
+		number++;
+		comment = strchr(line, '#');
+		if(comment)
+		{
+			*comment = '\0';
+		}
+		keyword = strtok(line, " \t\r\n");
+		if(keyword == NULL)
+		{
+			continue;
+		}
+
+		if(strcmp(keyword, "tolerance") == 0)
+		{
+			ok = planNumber(strtok(NULL, " \t\r\n"), &value) && value >= 0 && value <= 0x0FFF;
+			tolerance = value;
+		}else if(strcmp(keyword, "settle") == 0)
+		{
+			keyword = strtok(NULL, " \t\r\n");
+			ok = keyword && planNumber(strtok(NULL, " \t\r\n"), &value) && value >= 0;
+			if(ok && strcmp(keyword, "mode") == 0)
+			{
+				plan->settleModeUs = value;
+			}else if(ok && strcmp(keyword, "dac") == 0)
+			{
+				plan->settleDacUs = value;
+			}else if(ok && strcmp(keyword, "stable") == 0 && value <= 0x0FFF)
+			{
+				plan->stableCounts = value;
+				ok = planNumber(strtok(NULL, " \t\r\n"), &value) && value > 0;
+				plan->stableTimeoutUs = value;
+			}else
+			{
+				ok = 0;
+			}
+		}else if(plan->steps == AD5592_PLAN_STEPS)
+		{
+			ok = 0;
+		}else if(strcmp(keyword, "analog") == 0 || strcmp(keyword, "sweep") == 0)
+		{
+			ok = planStep(&plan->step[plan->steps], AD5592_PLAN_ANALOG,
+				strcmp(keyword, "sweep") == 0, tolerance);
+			plan->steps += ok;
+		}else if(strcmp(keyword, "digital") == 0)
+		{
+			ok = planStep(&plan->step[plan->steps], AD5592_PLAN_DIGITAL, 0, tolerance);
+			plan->steps += ok;
+		}else
+		{
+			ok = 0;
+		}
+
+		if(!ok)
+		{
+			plan->errorLine = number;
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+ * Append an operation.
+ * Returns:
+ * 	Operation, or NULL if the schedule is full
+ */
+static AD5592_PlanOp *planOp(AD5592_Schedule *schedule, uint8_t op, uint8_t kind,
+	uint8_t board, uint8_t pins)
+{
+	AD5592_PlanOp *next;
+
+	if(schedule->ops == AD5592_PLAN_OPS)
+	{
+		return NULL;
+	}
+	next = &schedule->op[schedule->ops++];
+	memset(next, 0, sizeof(*next));
+	memset(next->step, -1, sizeof(next->step));
+	next->op = op;
+	next->kind = kind;
+	next->board = board;
+	next->pins = pins;
+	return next;
+}
+
+/**
+ * Count the pins that would change mode.
+ */
+static int planModeCost(uint8_t mode[][8], uint8_t board, uint8_t pins, uint8_t target)
+{
+	int cost = 0;
+	int pin;
+
+	for(pin = 0; pin < 8; pin++)
+	{
+		cost += ((pins >> pin) & 0x1) && mode[board][pin] != target;
+	}
+	return cost;
+}
+
+/**
+ * Add a mode operation if any pin changes mode.
+ * Returns:
+ * 	1 if an operation was added, 0 if none was needed, -1 if the
+ * 	schedule is full
+ */
+static int planMode(AD5592_Schedule *schedule, uint8_t mode[][8], uint8_t board,
+	uint8_t pins, uint8_t target)
+{
+	AD5592_PlanOp *op;
+	int pin;
+
+	if(planModeCost(mode, board, pins, target) == 0)
+	{
+		return 0;
+	}
+	op = planOp(schedule, AD5592_PLAN_OP_MODE, 0, board, pins);
+	if(op == NULL)
+	{
+		return -1;
+	}
+	op->mode = target;
+	for(pin = 0; pin < 8; pin++)
+	{
+		if((pins >> pin) & 0x1)
+		{
+			mode[board][pin] = target;
+		}
+	}
+	schedule->modeChanges++;
+	return 1;
+}
+
+/**
+ * Compile a plan into a schedule.
+ * Parameters:
+ * 	plan = plan
+ * 	schedule = schedule to fill in
+ * Returns:
+ * 	1 on success, 0 if the schedule does not fit in AD5592_PLAN_OPS
+ */
+int planCompile(const AD5592_Plan *plan, AD5592_Schedule *schedule)
+{
+	PlanGroup group[AD5592_PLAN_STEPS];
+	uint8_t mode[BOARDS][8];
+	int next[AD5592_PLAN_STEPS];
+	int groups = 0;
+	int best;
+	int cost;
+	int bestCost;
+	int changed;
+	int placed;
+	uint8_t used;
+	uint8_t driveMode;
+	uint8_t measureMode;
+	const AD5592_PlanStep *step;
+	AD5592_PlanOp *drive;
+	AD5592_PlanOp *measure;
+	PlanGroup *g;
+	int i;
+	int j;
+	int pin;
+
+	schedule->ops = 0;
+	schedule->rounds = 0;
+	schedule->modeChanges = 0;
+	memset(mode, 0, sizeof(mode));
+
+	/* Group the steps */
+	for(i = 0; i < plan->steps; i++)
+	{
+		step = &plan->step[i];
+		for(j = 0; j < groups; j++)
+		{
+			if(group[j].kind == step->kind && group[j].driver == step->driver &&
+				group[j].measurer == step->measurer)
+			{
+				break;
+			}
+		}
+		if(j == groups)
+		{
+			memset(&group[groups], 0, sizeof(group[groups]));
+			group[groups].kind = step->kind;
+			group[groups].driver = step->driver;
+			group[groups].measurer = step->measurer;
+			groups++;
+		}
+		group[j].pins |= step->pins;
+		group[j].step[group[j].steps++] = i;
+		next[i] = 0;
+	}
+
+	for(i = 0; i < groups; i++)
+	{
+		/* Next group is the one with the fewest pins changing mode */
+		best = -1;
+		bestCost = 0;
+		for(j = 0; j < groups; j++)
+		{
+			if(group[j].done)
+			{
+				continue;
+			}
+			driveMode = group[j].kind == AD5592_PLAN_ANALOG ? AD5592_MODE_DAC : AD5592_MODE_GPIO_OUT;
+			measureMode = group[j].kind == AD5592_PLAN_ANALOG ? AD5592_MODE_ADC : AD5592_MODE_GPIO_IN;
+			cost = planModeCost(mode, group[j].driver, group[j].pins, driveMode) +
+				planModeCost(mode, group[j].measurer, group[j].pins, measureMode);
+			if(best < 0 || cost < bestCost)
+			{
+				best = j;
+				bestCost = cost;
+			}
+		}
+		g = &group[best];
+		g->done = 1;
+		driveMode = g->kind == AD5592_PLAN_ANALOG ? AD5592_MODE_DAC : AD5592_MODE_GPIO_OUT;
+		measureMode = g->kind == AD5592_PLAN_ANALOG ? AD5592_MODE_ADC : AD5592_MODE_GPIO_IN;
+
+		/* The measuring board lets go of the pins before the driving
+		 * board takes them */
+		changed = planMode(schedule, mode, g->measurer, g->pins, measureMode);
+		if(changed >= 0)
+		{
+			j = planMode(schedule, mode, g->driver, g->pins, driveMode);
+			changed = j < 0 ? j : changed | j;
+		}
+		if(changed < 0)
+		{
+			return 0;
+		}
+		if(changed && plan->settleModeUs)
+		{
+			if(planOp(schedule, AD5592_PLAN_OP_SETTLE, 0, 0, 0) == NULL)
+			{
+				return 0;
+			}
+			schedule->op[schedule->ops - 1].us = plan->settleModeUs;
+		}
+
+		/* Rounds. Each step puts its next level in the round if its
+		 * pins are still free. */
+		do
+		{
+			placed = 0;
+			used = 0x00;
+			drive = planOp(schedule, AD5592_PLAN_OP_DRIVE, g->kind, g->driver, 0);
+			if(drive == NULL)
+			{
+				return 0;
+			}
+			for(j = 0; j < g->steps; j++)
+			{
+				step = &plan->step[g->step[j]];
+				if(next[g->step[j]] == step->levels || (used & step->pins))
+				{
+					continue;
+				}
+				used |= step->pins;
+				for(pin = 0; pin < 8; pin++)
+				{
+					if((step->pins >> pin) & 0x1)
+					{
+						drive->value[pin] = step->kind == AD5592_PLAN_ANALOG ?
+							step->level[next[g->step[j]]] :
+							(step->level[next[g->step[j]]] >> pin) & 0x1;
+						drive->step[pin] = g->step[j];
+					}
+				}
+				next[g->step[j]]++;
+				placed++;
+			}
+			if(placed == 0)
+			{
+				schedule->ops--;
+				break;
+			}
+			drive->pins = used;
+
+			/* With settle stable the measurement waits for itself */
+			if(g->kind == AD5592_PLAN_ANALOG && plan->settleDacUs && !plan->stableCounts)
+			{
+				if(planOp(schedule, AD5592_PLAN_OP_SETTLE, 0, 0, 0) == NULL)
+				{
+					return 0;
+				}
+				schedule->op[schedule->ops - 1].us = plan->settleDacUs;
+			}
+			measure = planOp(schedule, AD5592_PLAN_OP_MEASURE, g->kind, g->measurer, used);
+			if(measure == NULL)
+			{
+				return 0;
+			}
+			for(pin = 0; pin < 8; pin++)
+			{
+				measure->value[pin] = g->kind == AD5592_PLAN_ANALOG ?
+					a2d(drive->value[pin]) : drive->value[pin];
+				measure->step[pin] = drive->step[pin];
+			}
+			schedule->rounds++;
+		}while(placed);
+	}
+	return 1;
+}
+
+/**
+ * Check an analog measurement. As in the original ATP the count must be
+ * closer to the target than the tolerance, so the default of 41 allows
+ * 40 counts either way.
+ * Parameters:
+ * 	target = expected count
+ * 	counts = measured count
+ * 	tolerance = tolerance of the step in counts
+ * Returns:
+ * 	1 if it passes, 0 if not
+ */
+int planAnalogPass(uint16_t target, uint16_t counts, uint16_t tolerance)
+{
+	return abs((int)counts - (int)target) < tolerance;
+}
+
+/**
+ * Check and report a measurement.
+ * Returns:
+ * 	Number of failed checks
+ */
+static int planCheck(const AD5592_Plan *plan, const AD5592_PlanOp *op, AD5592_Log *log,
+	AD5592_SettleStats *stats)
+{
+	const AD5592_PlanStep *step;
+	uint16_t counts[8];
+	uint8_t states;
+	uint8_t mask;
+	uint8_t expected;
+	uint8_t reported = 0x00;
+	uint8_t pass;
+	uint32_t errors;
+	int lost;
+	int failed = 0;
+	int pin;
+	int i;
+
+	if(op->kind == AD5592_PLAN_ANALOG)
+	{
+		if(plan->stableCounts)
+		{
+			timingSettleAdc(currentDevice, op->pins, counts, plan->stableCounts,
+				plan->stableTimeoutUs, stats);
+		}else
+		{
+			batchScanAdc(currentDevice, op->pins, counts);
+		}
+		for(pin = 0; pin < 8; pin++)
+		{
+			if(!((op->pins >> pin) & 0x1))
+			{
+				continue;
+			}
+			step = &plan->step[op->step[pin]];
+			pass = planAnalogPass(op->value[pin], counts[pin], step->tolerance);
+			printf("\n%s test on IO%d target = %d...Result = %d...%s", step->name, pin,
+				op->value[pin], counts[pin], pass ? "PASS" : "FAIL");
+			if(log)
+			{
+				logResult(log, op->board, AD5592_LOG_ANALOG, pin, step->name, op->value[pin],
+					counts[pin], pass);
+			}
+			failed += !pass;
+		}
+		return failed;
+	}
+
+	/* Digital results are reported per step. A failed transfer leaves
+	 * states undefined, so every check of it fails. */
+	errors = currentDevice->transferErrors;
+	states = getDigitalIn(op->pins);
+	lost = currentDevice->transferErrors != errors;
+	for(pin = 0; pin < 8; pin++)
+	{
+		if(!((op->pins >> pin) & 0x1) || ((reported >> pin) & 0x1))
+		{
+			continue;
+		}
+		step = &plan->step[op->step[pin]];
+		mask = op->pins & step->pins;
+		expected = 0x00;
+		for(i = 0; i < 8; i++)
+		{
+			expected |= ((mask >> i) & 0x1) ? op->value[i] << i : 0;
+		}
+		reported |= mask;
+		pass = (states & mask) == expected && !lost;
+		printf("\n%s test: %s ... Target = %x Value = %x", step->name, pass ? "PASS" : "FAIL",
+			expected, states & mask);
+		if(log)
+		{
+			logResult(log, op->board, AD5592_LOG_DIGITAL, mask, step->name, expected,
+				states & mask, pass);
+		}
+		failed += !pass;
+	}
+	return failed;
+}
+
+/**
+ * Run a schedule on CHANNEL0 and CHANNEL1 and report every check.
+ * Parameters:
+ * 	plan = plan the schedule was compiled from
+ * 	schedule = schedule
+ * 	log = log to record every check in as well as printing it, may be NULL
+ * 	stats = settling record for settle stable, may be NULL
+ * Returns:
+ * 	Number of failed checks
+ */
+int planRun(const AD5592_Plan *plan, const AD5592_Schedule *schedule, AD5592_Log *log,
+	AD5592_SettleStats *stats)
+{
+	const AD5592_PlanOp *op;
+	uint16_t milivolts[8];
+	uint8_t states;
+	int failed = 0;
+	int i;
+	int pin;
+
+	for(i = 0; i < schedule->ops; i++)
+	{
+		op = &schedule->op[i];
+		switch(op->op)
+		{
+			case AD5592_PLAN_OP_MODE:
+				setAD5592Ch(op->board);
+				deviceSetPinMode(currentDevice, op->pins, op->mode);
+				break;
+			case AD5592_PLAN_OP_SETTLE:
+				timingWaitUs(op->us);
+				break;
+			case AD5592_PLAN_OP_DRIVE:
+				setAD5592Ch(op->board);
+				if(op->kind == AD5592_PLAN_ANALOG)
+				{
+					for(pin = 0; pin < 8; pin++)
+					{
+						milivolts[pin] = op->value[pin];
+					}
+					setAnalogOutAll(op->pins, milivolts);
+				}else
+				{
+					states = 0x00;
+					for(pin = 0; pin < 8; pin++)
+					{
+						states |= ((op->pins >> pin) & 0x1) ? op->value[pin] << pin : 0;
+					}
+					deviceWrite(currentDevice, AD5592_GPIO_WRITE_DATA | states);
+				}
+				break;
+			case AD5592_PLAN_OP_MEASURE:
+				setAD5592Ch(op->board);
+				failed += planCheck(plan, op, log, stats);
+				break;
+		}
+	}
+	return failed;
+}
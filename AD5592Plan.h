@@ -0,0 +1,190 @@
+/*********************************************************************
+ * File: AD5592Plan.h
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Test plans for the AD5592 Snack board ATP
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Batch.h v1.1.0
+ * 		-AD5592Timing.h v1.0.0
+ * 		-AD5592Log.h v1.0.0
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.1.0: 16 October 2026
+ * 		- Settle times default to the datasheet minimums and are waited
+ * 			with timingWaitUs().
+ * 		- Added the settle stable statement. planRun() records the
+ * 			settling times.
+ * 	* Version 1.2.0: 16 October 2026
+ * 		- planRun() records checks in a binary AD5592_Log instead of
+ * 			a text file.
+ * 	* Version 1.2.1: 16 October 2026
+ * 		- Analog checks pass only when the count is less than the
+ * 			tolerance from the target, as in the original ATP. Added
+ * 			planAnalogPass().
+ *
+ * Plan file format, one statement per line, # starts a comment:
+ * 	tolerance <counts>
+ * 		Analog tolerance for the steps after it. A count passes when
+ * 		it is less than this far from the target. Default 41.
+ * 	settle mode <us>
+ * 	settle dac <us>
+ * 		Settling after pins change mode and after the DACs change.
+ * 		Defaults are the datasheet minimums in AD5592Timing.h.
+ * 	settle stable <counts> <timeout us>
+ * 		Instead of waiting settle dac, scan the ADCs after each DAC
+ * 		change until two scans in a row agree within counts.
+ * 	analog <name> <driver> <measurer> <pins> <mV> [<mV> ...]
+ * 		Drive the pins of the driver board with its DACs at each level
+ * 		and measure them with the ADCs of the measurer board.
+ * 	sweep <name> <driver> <measurer> <pins> <from mV> <to mV> <step mV>
+ * 		analog with evenly spaced levels.
+ * 	digital <name> <driver> <measurer> <pins> <states> [<states> ...]
+ * 		Drive the pins of the driver board as GPIO outputs with each set
+ * 		of states and read them with the GPIO inputs of the measurer.
+ * Boards are "test" (CS0) and "uut" (CS1). Pins and states are bit
+ * masks, for example 0xFF.
+ *
+ * planCompile() turns a plan into a schedule:
+ * 	- Steps with the same kind, driver and measurer are grouped, and
+ * 		the groups are ordered so the fewest pins change mode.
+ * 	- Within a group, steps on different pins share rounds. Each round
+ * 		is one DAC or GPIO update of every pin in it, one settle, and
+ * 		one ADC scan or GPIO read.
+ * 	- The measuring board is always configured before the driving
+ * 		board so two boards never drive a pin together.
+ **********************************************************************/
+
+#ifndef SOURCES_AD5592PLAN_H_
+#define SOURCES_AD5592PLAN_H_
+
+#include <stdio.h>
+#include "AD5592RPI.h"
+#include "AD5592Timing.h"
+#include "AD5592Log.h"
+
+#define AD5592_PLAN_STEPS		32		/* Steps in a plan */
+#define AD5592_PLAN_LEVELS		64		/* Levels in a step */
+#define AD5592_PLAN_OPS			1024	/* Operations in a schedule */
+#define AD5592_PLAN_NAME		16		/* Longest step name */
+#define AD5592_PLAN_TOLERANCE	41		/* Default analog tolerance in counts */
+
+/**
+ * Step kinds.
+ */
+#define AD5592_PLAN_ANALOG		0
+#define AD5592_PLAN_DIGITAL		1
+
+/**
+ * Schedule operations.
+ */
+#define AD5592_PLAN_OP_MODE		0	/* Put pins of a board in a mode */
+#define AD5592_PLAN_OP_SETTLE	1	/* Wait */
+#define AD5592_PLAN_OP_DRIVE	2	/* Set DAC outputs or GPIO outputs */
+#define AD5592_PLAN_OP_MEASURE	3	/* Scan ADC inputs or read GPIO inputs and check them */
+
+/**
+ * One step of a plan.
+ */
+typedef struct
+{
+	char name[AD5592_PLAN_NAME];			/* Name used in the report */
+	uint8_t kind;							/* AD5592_PLAN_ANALOG or AD5592_PLAN_DIGITAL */
+	uint8_t driver;							/* Channel of the driving board */
+	uint8_t measurer;						/* Channel of the measuring board */
+	uint8_t pins;							/* Pins as bit mask */
+	uint16_t tolerance;						/* Analog tolerance in counts */
+	int levels;								/* Number of levels */
+	uint16_t level[AD5592_PLAN_LEVELS];		/* Millivolts or pin states */
+} AD5592_PlanStep;
+
+/**
+ * A test plan.
+ */
+typedef struct
+{
+	int steps;								/* Number of steps */
+	AD5592_PlanStep step[AD5592_PLAN_STEPS];	/* Steps in file order */
+	uint32_t settleModeUs;					/* Settling after a mode change */
+	uint32_t settleDacUs;					/* Settling after a DAC update */
+	uint16_t stableCounts;					/* Settle stable window, 0 if off */
+	uint32_t stableTimeoutUs;				/* Settle stable timeout */
+	int errorLine;							/* Line of the first error, 0 if none */
+} AD5592_Plan;
+
+/**
+ * One operation of a schedule.
+ */
+typedef struct
+{
+	uint8_t op;					/* AD5592_PLAN_OP_ */
+	uint8_t kind;				/* AD5592_PLAN_ANALOG or AD5592_PLAN_DIGITAL */
+	uint8_t board;				/* Channel */
+	uint8_t pins;				/* Pins as bit mask */
+	uint8_t mode;				/* AD5592_MODE_ flags for AD5592_PLAN_OP_MODE */
+	uint32_t us;				/* Microseconds for AD5592_PLAN_OP_SETTLE */
+	uint16_t value[8];			/* Millivolts or states to drive, counts or states expected, by pin */
+	int8_t step[8];				/* Step each pin belongs to, by pin */
+} AD5592_PlanOp;
+
+/**
+ * A compiled schedule.
+ */
+typedef struct
+{
+	int ops;								/* Number of operations */
+	AD5592_PlanOp op[AD5592_PLAN_OPS];		/* Operations in order */
+	int rounds;								/* Drive and measure rounds */
+	int modeChanges;						/* Mode operations */
+} AD5592_Schedule;
+
+/**
+ * Read a plan file.
+ * Parameters:
+ * 	plan = plan to fill in
+ * 	file = open plan file
+ * Returns:
+ * 	1 on success, 0 on a syntax error with plan->errorLine set
+ */
+int planLoad(AD5592_Plan *plan, FILE *file);
+
+/**
+ * Compile a plan into a schedule.
+ * Parameters:
+ * 	plan = plan
+ * 	schedule = schedule to fill in
+ * Returns:
+ * 	1 on success, 0 if the schedule does not fit in AD5592_PLAN_OPS
+ */
+int planCompile(const AD5592_Plan *plan, AD5592_Schedule *schedule);
+
+/**
+ * Check an analog measurement. As in the original ATP the count must be
+ * closer to the target than the tolerance, so the default of 41 allows
+ * 40 counts either way.
+ * Parameters:
+ * 	target = expected count
+ * 	counts = measured count
+ * 	tolerance = tolerance of the step in counts
+ * Returns:
+ * 	1 if it passes, 0 if not
+ */
+int planAnalogPass(uint16_t target, uint16_t counts, uint16_t tolerance);
+
+/**
+ * Run a schedule on CHANNEL0 and CHANNEL1 and report every check.
+ * Parameters:
+ * 	plan = plan the schedule was compiled from
+ * 	schedule = schedule
+ * 	log = log to record every check in as well as printing it, may be NULL
+ * 	stats = settling record for settle stable, may be NULL
+ * Returns:
+ * 	Number of failed checks
+ */
+int planRun(const AD5592_Plan *plan, const AD5592_Schedule *schedule, AD5592_Log *log,
+	AD5592_SettleStats *stats);
+
+#endif /* SOURCES_AD5592PLAN_H_ */
@@ -3,20 +3,85 @@
  * Target: AD5592 on a Raspberry Pi
  * Function: AD5592 device driver for Raspberry Pi
  * Dependancies: 
- * 		-bcm2835.h v1.20 2015/03/31 04:55:41
+ * 		-AD5592Transport.h v1.0.0
+ * 		-AD5592Timing.h v1.0.0
+ * 		-AD5592Stats.h v1.0.0
  * 		-AD5592RPI.h
  * Author: Tom Olenik
  * Original Date: 11 December 2016
- * Last Revised Date: 17 December 2016
+ * Last Revised Date: 16 October 2026
  * Release Notes:
  * 	* Version 1.0.0: 11 December 2016
  * 		- Initial release derrived from from AD5592.h version 1.0.2 and 
  * 			AD5592SnackATP.c version 1.0.0. 
  *	* Version 1.0.1: 17 December 2016
  		- Several fixes. Version 1.0.0 didn't work. Don't use it.
+ *	* Version 1.1.0: 16 October 2026
+ 		- Added getAnalogInMulti() for sequenced multi-channel reads.
+ 		- Added spiTransfer() for multi-frame transfers.
+ 		- Added AD5592_Device handles with shadow registers. Writes that
+ 			would not change a register are skipped.
+ 		- bcm2835 code moved to AD5592Transport.c. Boards talk through an
+ 			AD5592_Transport. clearBuffer() no longer writes past the
+ 			two byte buffers.
+ 		- a2d() and d2a() use the integer conversions in AD5592Conv.h.
+		- Added setAnalogOutAll(). An LDAC load always goes out.
+		- setAsDAC() and setAsADC() wait the datasheet settling time in
+			microseconds instead of 10ms.
+		- Commands, transfers and pin configuration calls are counted
+			when built with AD5592_STATS.
+		- deviceWrite() no longer uses the spiOut and spiIn buffers so
+			boards on different buses can be used from their own threads.
+		- deviceTransfer(), spiTransfer() and AD5592_Init() return
+			whether they worked. A failed transfer is counted in
+			transferErrors.
+		- Added deviceSend() for frames built with AD5592Cmd.h. Frames to
+			send are const all the way to the transport.
+		- Added deviceRecord() for words that go out whatever the shadow
+			holds. deviceSend() and spiComs() use it so their frames are
+			never counted as skipped.
+		- A failed transfer marks every shadow register unknown, so the
+			next write of each goes out. deviceRegister() still returns
+			the value last written, so changing one pin after a failure
+			keeps the other pins configured. Added deviceKnown() for the
+			checks that skip configuration writes.
+		- A GPIO input read stores its pin mask as the GPIO read
+			configuration, as the chip does.
  **********************************************************************/
 
+#include <string.h>
 #include "AD5592RPI.h"
+#include "AD5592Batch.h"
+#include "AD5592Timing.h"
+#include "AD5592Stats.h"
+
+char spiOut[2]; 			/* SPI output buffer */
+char spiIn[2];	 			/* SPI input buffer  */
+
+uint16_t mV;					/* millivolts */
+uint16_t result;				/* result */
+
+AD5592_Device ad5592Channel[2] = {{.cs = CHANNEL0}, {.cs = CHANNEL1}};	/* Boards on CS0 and CS1 */
+AD5592_Device *currentDevice = &ad5592Channel[0];				/* Board picked by setAD5592Ch() */
+
+static AD5592_Transport defaultBus;		/* Transport set up by AD5592_Init() */
+#ifdef AD5592_NO_BCM2835
+static AD5592_Spidev defaultSpidev;		/* spidev data for defaultBus */
+#endif
+
+/**
+ * Pin mode registers in the order of the AD5592_MODE_ flags.
+ */
+static const AD5592_WORD modeRegister[AD5592_MODE_COUNT] =
+{
+	AD5592_DAC_PIN_SELECT,
+	AD5592_ADC_PIN_SELECT,
+	AD5592_GPIO_WRITE_CONFIG,
+	AD5592_GPIO_READ_CONFIG,
+	AD5592_THREE_STATE_CONFIG,
+	AD5592_PULL_DOWN_SET,
+	AD5592_GPIO_DRAIN_CONFIG
+};
 
 /**
  * Clear the spi buffer.
@@ -26,7 +91,7 @@
 void clearBuffer(char spiBuffer[])
 {
 	int i;
-	for(i=0;i<sizeof(spiBuffer);i++)
+	for(i=0;i<2;i++)	/* AD5592 words are two bytes */
 	{
 		spiBuffer[i] = 0x00;
 	}
@@ -55,38 +120,34 @@ void setAD5592Ch(int ch)
 {
 	switch(ch){
 		case 0:
-			bcm2835_spi_chipSelect(CHANNEL0);
-			bcm2835_spi_setChipSelectPolarity(CHANNEL0, LOW);
+			currentDevice = &ad5592Channel[0];
 			break;
 		case 1:
-			bcm2835_spi_chipSelect(CHANNEL1);
-			bcm2835_spi_setChipSelectPolarity(CHANNEL1, LOW);
+			currentDevice = &ad5592Channel[1];
 			break;
 	}
 }
 
 /**
- * Convert a voltage to an digital value based upon assumptions of
- * 0 - 5V input and 12 bit ADC/DAC.
+ * Convert a voltage to a digital value for the range set in
+ * AD5592Conv.h (0 - 5V by default) and 12 bit ADC/DAC.
  * Parameter: millivolts as 16 bit unsigned integer
  * Returns: digital value as 16 bit unsigned integer
  */
- uint16_t a2d(uint16_t millivolts)
- {
-	 uint16_t count = millivolts * .819f;
-	 return count;
- }
+uint16_t a2d(uint16_t millivolts)
+{
+	return ad5592MvToCount(millivolts);
+}
 
 /**
- * Convert a digital value to voltage based upon assumptions of
- * 0 - 5V input and 12 bit ADC/DAC.
+ * Convert a digital value to voltage for the range set in
+ * AD5592Conv.h (0 - 5V by default) and 12 bit ADC/DAC.
  * Parameter: digital value as 16 bit unsigned integer
  * Returns: millivolts as 16 bit unsigned integer
  */
 uint16_t d2a(uint16_t count)
 {
-	uint16_t millivolts = count / .819f;
-	return millivolts;
+	return ad5592CountToMv(count);
 }
 
 /**
@@ -95,9 +156,9 @@ uint16_t d2a(uint16_t count)
  */
 void setAsDigitalOut(uint8_t pins)
 {
-	digitalOutPins = pins;	/* Log which pins are configured */
-	makeWord(spiOut, AD5592_GPIO_WRITE_CONFIG | pins); 	/* Make the word */
-	bcm2835_spi_transfern(spiOut, sizeof(spiOut));		/* Send it */
+	int sent = deviceWrite(currentDevice, AD5592_GPIO_WRITE_CONFIG | pins);
+
+	AD5592_STATS_RECONFIG(AD5592_STATS_GPIO_OUT, sent);
 }
 
 /**
@@ -106,9 +167,9 @@ void setAsDigitalOut(uint8_t pins)
  */
  void setAsDigitalIn(uint8_t pins)
 {
-	digitalInPins = pins;	/* Log which pins are configured */
-	makeWord(spiOut, AD5592_GPIO_READ_CONFIG | pins); 	/* Make the word */
-	bcm2835_spi_transfern(spiOut, sizeof(spiOut));		/* Send it */
+	int sent = deviceWrite(currentDevice, AD5592_GPIO_READ_CONFIG | pins);
+
+	AD5592_STATS_RECONFIG(AD5592_STATS_GPIO_IN, sent);
 }
 
 /**
@@ -117,10 +178,13 @@ void setAsDigitalOut(uint8_t pins)
  */
 void setAsDAC(uint8_t pins)
 {
-	analogOutPins = pins;	/* Log which pins are configured */
-	makeWord(spiOut, AD5592_DAC_PIN_SELECT | pins); 	/* Make the word */
-	bcm2835_spi_transfern(spiOut, sizeof(spiOut));		/* Send it */
-	bcm2835_delay(SHORT_DELAY);
+	int sent = deviceWrite(currentDevice, AD5592_DAC_PIN_SELECT | pins);
+
+	AD5592_STATS_RECONFIG(AD5592_STATS_DAC, sent);
+	if(sent)
+	{
+		timingWaitUs(AD5592_SETTLE_MODE_US);
+	}
 }
 
 /**
@@ -129,10 +193,13 @@ void setAsDAC(uint8_t pins)
  */
  void setAsADC(uint8_t pins)
 {
-	analogInPins = pins;	/* Log which pins are configured */
-	makeWord(spiOut, AD5592_ADC_PIN_SELECT | pins);		/* Make the word */
-	bcm2835_spi_transfern(spiOut, sizeof(spiOut));		/* Send it */
-	bcm2835_delay(SHORT_DELAY);
+	int sent = deviceWrite(currentDevice, AD5592_ADC_PIN_SELECT | pins);
+
+	AD5592_STATS_RECONFIG(AD5592_STATS_ADC, sent);
+	if(sent)
+	{
+		timingWaitUs(AD5592_SETTLE_MODE_US);
+	}
 }
 
 /**
@@ -142,9 +209,27 @@ void setAsDAC(uint8_t pins)
  */
 void spiComs(AD5592_WORD command)
 {
+	deviceRecord(currentDevice, command);	/* Keep the shadow in step */
 	makeWord(spiOut, command);
 	clearBuffer(spiIn);
-	bcm2835_spi_transfernb(spiOut, spiIn, sizeof(spiOut));
+	deviceTransfer(currentDevice, spiOut, spiIn, 1);
+}
+
+/**
+ * Transfer several 16 bit frames in one call. The buffers hold the
+ * frames back to back, most significant byte first. Chip select is
+ * released between frames because the AD5592 latches each word on the
+ * rising edge of SYNC.
+ * Parameters:
+ * 	txBuf[] = frames to send
+ * 	rxBuf[] = frames received
+ * 	frames = number of 16 bit frames
+ * Returns:
+ * 	1 on success, 0 if the transfer failed
+ */
+int spiTransfer(const char txBuf[], char rxBuf[], int frames)
+{
+	return deviceTransfer(currentDevice, txBuf, rxBuf, frames);
 }
 
 /**
@@ -155,11 +240,13 @@ void spiComs(AD5592_WORD command)
  */
 void setDigitalOut(uint8_t pins, uint8_t states)
 {
-	if(!(pins == digitalOutPins))
+	uint8_t digitalOutPins = deviceRegister(currentDevice, AD5592_GPIO_WRITE_CONFIG);
+
+	if(!deviceKnown(currentDevice, AD5592_GPIO_WRITE_CONFIG) || !(pins == digitalOutPins))
 	{
 		setAsDigitalOut(pins | digitalOutPins);
 	}
-	spiComs(AD5592_GPIO_WRITE_DATA | states);
+	deviceWrite(currentDevice, AD5592_GPIO_WRITE_DATA | states);
 }
 
 /**
@@ -171,7 +258,9 @@ void setDigitalOut(uint8_t pins, uint8_t states)
  */
 uint8_t getDigitalIn(uint8_t pins)
 {
-	if(!(pins == digitalInPins))
+	uint8_t digitalInPins = deviceRegister(currentDevice, AD5592_GPIO_READ_CONFIG);
+
+	if(!deviceKnown(currentDevice, AD5592_GPIO_READ_CONFIG) || !(pins == digitalInPins))
 	{
 		setAsDigitalIn(pins | digitalInPins);
 	}
@@ -189,11 +278,15 @@ uint8_t getDigitalIn(uint8_t pins)
  */
 void setAnalogOut(uint8_t pin, uint16_t milivolts)
 {
-	if(!((analogOutPins >> pin ) & 0x1))
+	uint8_t analogOutPins = deviceRegister(currentDevice, AD5592_DAC_PIN_SELECT);
+
+	if(!deviceKnown(currentDevice, AD5592_DAC_PIN_SELECT) || !((analogOutPins >> pin ) & 0x1))
 	{
 		setAsDAC(analogOutPins | (0x1 << pin));
 	}
-	spiComs(AD5592_DAC_WRITE_MASK | 		/* DAC write command */
+	/* Leave hold mode so the write reaches the pin */
+	deviceWrite(currentDevice, AD5592_CNTRL_REG_READBACK | AD5592_LDAC_IMMEDIATE);
+	deviceWrite(currentDevice, AD5592_DAC_WRITE_MASK |	/* DAC write command */
 	((pin <<12) & AD5592_DAC_ADDRESS_MASK)|	/* Set which pin to write */
 	a2d(milivolts));						/* Load digital value */
 }
@@ -207,7 +300,9 @@ void setAnalogOut(uint8_t pin, uint16_t milivolts)
  */
 uint16_t getAnalogIn(uint8_t pin)
 {
-	if(!((analogInPins >> pin ) & 0x1))
+	uint8_t analogInPins = deviceRegister(currentDevice, AD5592_ADC_PIN_SELECT);
+
+	if(!deviceKnown(currentDevice, AD5592_ADC_PIN_SELECT) || !((analogInPins >> pin ) & 0x1))
 	{
 		setAsADC(analogInPins | (0x1 << pin));
 	}
@@ -221,26 +316,466 @@ uint16_t getAnalogIn(uint8_t pin)
 }
 
 /**
- * Initialize the SPI for using the AD5592. Does not set channel. Do that
- * after calling this function by calling setAD5592Ch().
+ * Get analog input values for several pins with one ADC sequence. The
+ * sequence register is written once and the conversions are clocked
+ * out back to back. Each result word carries its own pin address so
+ * the values are sorted into place by that address.
+ * In repeat mode the sequence is left running on the device and later
+ * calls with the same pins skip the sequence register write.
  * Parameters:
- * 	none
+ * 	Pins to read as bit mask
+ * 	milivolts[] = 8 entry array indexed by pin number. Only the
+ * 		requested pins are written. (assumes 5V reference)
+ * 	repeat = non zero to use the repeat mode of the ADC sequencer
+ * Returns:
+ * 	Number of SPI frames used, 0 if nothing was read
+ */
+int getAnalogInMulti(uint8_t pins, uint16_t milivolts[], uint8_t repeat)
+{
+	uint8_t analogInPins = deviceRegister(currentDevice, AD5592_ADC_PIN_SELECT);
+	AD5592_Batch batch;
+	int first;
+	int i;
+
+	if(pins == 0x00)
+	{
+		return 0;
+	}
+	if(!deviceKnown(currentDevice, AD5592_ADC_PIN_SELECT) || (analogInPins & pins) != pins)
+	{
+		setAsADC(analogInPins | pins);
+	}
+
+	batchInit(&batch, currentDevice);
+	first = batchGetAnalogInMulti(&batch, pins, repeat);
+	if(first < 0 || !batchSend(&batch))
+	{
+		return 0;
+	}
+
+	for(i = first; i < batch.count; i++)
+	{
+		AD5592_WORD word = batchResponse(&batch, i);
+		milivolts[(word & AD5592_ADC_ADDRESS_MASK) >> 12] =
+			d2a(word & AD5592_ADC_VALUE_MASK);
+	}
+
+	return batch.count;
+}
+
+/**
+ * Set several analog outputs so they all change at the same time.
+ * Parameters:
+ * 	Pins to write as bit mask
+ * 	milivolts[] = 8 entry array indexed by pin number. Only the
+ * 		requested pins are used. (assumes 5V reference)
+ */
+void setAnalogOutAll(uint8_t pins, uint16_t milivolts[])
+{
+	uint8_t analogOutPins = deviceRegister(currentDevice, AD5592_DAC_PIN_SELECT);
+	AD5592_Batch batch;
+
+	if(!deviceKnown(currentDevice, AD5592_DAC_PIN_SELECT) || (analogOutPins & pins) != pins)
+	{
+		setAsDAC(analogOutPins | pins);
+	}
+
+	batchInit(&batch, currentDevice);
+	batchSetAnalogOutAll(&batch, pins, milivolts);
+	batchSend(&batch);
+}
+
+/**
+ * Set up a board handle with an unknown register state.
+ * Parameters:
+ * 	dev = board handle
+ * 	bus = SPI bus the board is on
+ * 	cs = chip select the board is on
+ */
+void deviceInit(AD5592_Device *dev, AD5592_Transport *bus, uint8_t cs)
+{
+	memset(dev, 0, sizeof(*dev));
+	dev->cs = cs;
+	dev->bus = bus;
+}
+
+/**
+ * Record a command word in the shadow registers.
+ * Returns:
+ * 	0 if the word would not change the board
+ */
+static int shadowUpdate(AD5592_Device *dev, AD5592_WORD command)
+{
+	int reg = AD5592_REG_INDEX(command);
+	AD5592_WORD value = command & AD5592_REG_VALUE_MASK;
+	uint8_t pin;
+
+	if(command & AD5592_DAC_WRITE_MASK)
+	{
+		pin = (command & AD5592_DAC_ADDRESS_MASK) >> 12;
+		value = command & AD5592_DAC_VALUE_MASK;
+		/* A repeated DAC write can only be dropped when it goes
+		 * straight through to the output */
+		if(((dev->dacKnown >> pin) & 0x1) && dev->dac[pin] == value &&
+			((dev->known >> AD5592_REG_INDEX(AD5592_CNTRL_REG_READBACK)) & 0x1) &&
+			(dev->reg[AD5592_REG_INDEX(AD5592_CNTRL_REG_READBACK)] & AD5592_LDAC_MODE_MASK) == 0)
+		{
+			return 0;
+		}
+		dev->dac[pin] = value;
+		dev->dacKnown |= 0x1 << pin;
+		return 1;
+	}
+
+	switch(reg)
+	{
+		case AD5592_REG_INDEX(AD5592_NOP):
+		case AD5592_REG_INDEX(AD5592_DAC_READBACK):
+		case 14:
+			/* Reads and the reserved address always go out */
+			return 1;
+		case AD5592_REG_INDEX(AD5592_SW_RESET):
+			if(command == AD5592_SW_RESET)
+			{
+				memset(dev->reg, 0, sizeof(dev->reg));
+				memset(dev->dac, 0, sizeof(dev->dac));
+				dev->known = 0xFFFF;
+				dev->dacKnown = 0xFF;
+			}
+			return 1;
+		case AD5592_REG_INDEX(AD5592_ADC_READ):
+			/* Every sequence write starts conversions */
+			dev->reg[reg] = value;
+			dev->known |= 0x1 << reg;
+			return 1;
+		case AD5592_REG_INDEX(AD5592_CNTRL_REG_READBACK):
+			value &= AD5592_LDAC_MODE_MASK;
+			/* A load copies the input registers every time */
+			if((command & AD5592_REG_READBACK_EN) || value == AD5592_LDAC_LOAD)
+			{
+				dev->reg[reg] = value;
+				dev->known |= 0x1 << reg;
+				return 1;
+			}
+			break;
+		case AD5592_REG_INDEX(AD5592_GPIO_READ_CONFIG):
+			/* A read always goes out, and its pin mask becomes the
+			 * read configuration like any other write */
+			if(command & AD5592_GPIO_READ_INPUT_BIT)
+			{
+				dev->reg[reg] = value & AD5592_PIN_SELECT_MASK;
+				dev->known |= 0x1 << reg;
+				return 1;
+			}
+			break;
+	}
+
+	if(((dev->known >> reg) & 0x1) && dev->reg[reg] == value)
+	{
+		return 0;
+	}
+	dev->reg[reg] = value;
+	dev->known |= 0x1 << reg;
+	return 1;
+}
+
+/**
+ * Record a command word in the shadow registers.
+ * Parameters:
+ * 	dev = board handle
+ * 	command = AD5592 word about to be sent
+ * Returns:
+ * 	0 if the word would not change the board and can be skipped
  */
-void AD5592_Init()
+int deviceUpdate(AD5592_Device *dev, AD5592_WORD command)
 {
-	//int msg;
-	/* Initialize the bcm2835 library */
-	bcm2835_init();
+	int sent = shadowUpdate(dev, command);
 
-    /* Initialize the SPI module */
-    bcm2835_spi_begin();
+	if(!sent)
+	{
+		dev->writesSkipped++;
+	}
+	AD5592_STATS_COMMAND(command, sent);
+	return sent;
+}
 
-    /* Set SPI bit order */
-    bcm2835_spi_setBitOrder(BCM2835_SPI_BIT_ORDER_MSBFIRST);      // The default
+/**
+ * Record a command word that is sent whatever the shadow holds, so it
+ * is counted as sent and never as skipped.
+ * Parameters:
+ * 	dev = board handle
+ * 	command = AD5592 word about to be sent
+ */
+void deviceRecord(AD5592_Device *dev, AD5592_WORD command)
+{
+	shadowUpdate(dev, command);
+	AD5592_STATS_COMMAND(command, 1);
+}
 
-    /* Set SPI polarity and phase */
-    bcm2835_spi_setDataMode(BCM2835_SPI_MODE1);                   // Mode 1
+/**
+ * Get the shadow value of a control register.
+ * Parameters:
+ * 	dev = board handle
+ * 	reg = register command, for example AD5592_DAC_PIN_SELECT
+ * Returns:
+ * 	Register data bits last written, 0 before the first write
+ */
+AD5592_WORD deviceRegister(AD5592_Device *dev, AD5592_WORD reg)
+{
+	return dev->reg[AD5592_REG_INDEX(reg)];
+}
 
-    /* Set SPI clock */
-    bcm2835_spi_setClockDivider(BCM2835_SPI_CLOCK_DIVIDER_16); 	  // 16 = 64ns = 15.625MHz
+/**
+ * Check whether the board is known to hold the shadow value of a
+ * control register.
+ * Parameters:
+ * 	dev = board handle
+ * 	reg = register command, for example AD5592_DAC_PIN_SELECT
+ * Returns:
+ * 	1 if it is, 0 before the first write or after a failed transfer
+ */
+int deviceKnown(AD5592_Device *dev, AD5592_WORD reg)
+{
+	return (dev->known >> AD5592_REG_INDEX(reg)) & 0x1;
+}
+
+/**
+ * Send a command word to a board unless the shadow shows it would not
+ * change anything.
+ * Parameters:
+ * 	dev = board handle
+ * 	command = AD5592 word
+ * Returns:
+ * 	1 if the word was sent, 0 if it was skipped
+ */
+int deviceWrite(AD5592_Device *dev, AD5592_WORD command)
+{
+	char txBuf[2];
+	char rxBuf[2];
+
+	if(!deviceUpdate(dev, command))
+	{
+		return 0;
+	}
+	/* Own buffers, so boards on different buses can be written from
+	 * different threads */
+	makeWord(txBuf, command);
+	deviceTransfer(dev, txBuf, rxBuf, 1);
+	return 1;
+}
+
+/**
+ * Software reset a board. The shadow is set to the power on values.
+ * Parameters:
+ * 	dev = board handle
+ */
+void deviceReset(AD5592_Device *dev)
+{
+	deviceWrite(dev, AD5592_SW_RESET);
+}
+
+/**
+ * Order the writes that take the pin mode registers to their targets.
+ * Parameters:
+ * 	dev = board handle
+ * 	target[] = AD5592_MODE_COUNT entry array of pin masks
+ * 	words[] = AD5592_MODE_COUNT entry array for the writes
+ * Returns:
+ * 	Number of words needed
+ */
+static int modeWords(AD5592_Device *dev, const uint8_t target[], AD5592_WORD words[])
+{
+	int count = 0;
+	int pass;
+	int i;
+
+	/* Registers losing pins go first so no pin is in two modes at once */
+	for(pass = 0; pass < 2; pass++)
+	{
+		for(i = 0; i < AD5592_MODE_COUNT; i++)
+		{
+			int index = AD5592_REG_INDEX(modeRegister[i]);
+			int known = (dev->known >> index) & 0x1;
+			uint8_t current = dev->reg[index] & AD5592_PIN_SELECT_MASK;
+			int losing = known && (current & ~target[i]);
+
+			if(known && current == target[i])
+			{
+				continue;
+			}
+			if(losing == (pass == 0))
+			{
+				words[count++] = modeRegister[i] | target[i];
+			}
+		}
+	}
+	return count;
+}
+
+/**
+ * Work out the register writes needed to put pins into a mode.
+ * Parameters:
+ * 	dev = board handle
+ * 	pins = pins as bit mask
+ * 	mode = AD5592_MODE_ flags
+ * 	words[] = AD5592_MODE_COUNT entry array for the writes
+ * Returns:
+ * 	Number of words needed
+ */
+int devicePinModeWords(AD5592_Device *dev, uint8_t pins, uint8_t mode,
+	AD5592_WORD words[])
+{
+	uint8_t target[AD5592_MODE_COUNT];
+	int i;
+
+	for(i = 0; i < AD5592_MODE_COUNT; i++)
+	{
+		target[i] = deviceRegister(dev, modeRegister[i]) & ~pins;
+		if((mode >> i) & 0x1)
+		{
+			target[i] |= pins;
+		}
+	}
+	return modeWords(dev, target, words);
+}
+
+/**
+ * Put pins into a mode with the fewest register writes.
+ * Parameters:
+ * 	dev = board handle
+ * 	pins = pins as bit mask
+ * 	mode = AD5592_MODE_ flags
+ * Returns:
+ * 	Number of words sent
+ */
+int deviceSetPinMode(AD5592_Device *dev, uint8_t pins, uint8_t mode)
+{
+	AD5592_WORD words[AD5592_MODE_COUNT];
+	int count = devicePinModeWords(dev, pins, mode, words);
+	int i;
+
+	for(i = 0; i < count; i++)
+	{
+		deviceWrite(dev, words[i]);
+	}
+	return count;
+}
+
+/**
+ * Put every pin into its own mode with the fewest register writes.
+ * Parameters:
+ * 	dev = board handle
+ * 	modes[] = 8 entry array of AD5592_MODE_ flags indexed by pin number
+ * Returns:
+ * 	Number of words sent
+ */
+int deviceSetPinModes(AD5592_Device *dev, const uint8_t modes[])
+{
+	uint8_t target[AD5592_MODE_COUNT];
+	AD5592_WORD words[AD5592_MODE_COUNT];
+	int count;
+	int pin;
+	int i;
+
+	for(i = 0; i < AD5592_MODE_COUNT; i++)
+	{
+		target[i] = 0x00;
+		for(pin = 0; pin < 8; pin++)
+		{
+			target[i] |= ((modes[pin] >> i) & 0x1) << pin;
+		}
+	}
+	count = modeWords(dev, target, words);
+	for(i = 0; i < count; i++)
+	{
+		deviceWrite(dev, words[i]);
+	}
+	return count;
+}
+
+/**
+ * Transfer frames to a board, selecting its chip select first.
+ * Parameters:
+ * 	dev = board handle
+ * 	txBuf[] = frames to send
+ * 	rxBuf[] = frames received
+ * 	frames = number of 16 bit frames
+ * Returns:
+ * 	1 on success, 0 if the transfer failed
+ */
+int deviceTransfer(AD5592_Device *dev, const char txBuf[], char rxBuf[], int frames)
+{
+	AD5592_STATS_START(start);
+	int ok = 0;
+
+	if(dev->bus != NULL)
+	{
+		ok = transportTransfer(dev->bus, dev->cs, txBuf, rxBuf, frames);
+	}
+	if(!ok)
+	{
+		/* The words in the shadow may never have reached the board */
+		dev->transferErrors++;
+		dev->known = 0;
+		dev->dacKnown = 0;
+	}
+	AD5592_STATS_TRANSFER(frames, start);
+	return ok;
+}
+
+/**
+ * Send frames that are already built, like a constant sequence made
+ * with AD5592Cmd.h, and keep the shadow registers in step with them.
+ * Parameters:
+ * 	dev = board handle
+ * 	frames[] = frames to send, most significant byte first
+ * 	rxBuf[] = frames received
+ * 	count = number of 16 bit frames
+ * Returns:
+ * 	1 on success, 0 if the transfer failed
+ */
+int deviceSend(AD5592_Device *dev, const char frames[], char rxBuf[], int count)
+{
+	int i;
+
+	for(i = 0; i < count; i++)
+	{
+		deviceRecord(dev, ((uint8_t)frames[2 * i] << 8) | (uint8_t)frames[2 * i + 1]);
+	}
+	return deviceTransfer(dev, frames, rxBuf, count);
+}
+
+/**
+ * Initialize the SPI for using the AD5592. Does not set channel. Do that
+ * after calling this function by calling setAD5592Ch(). Uses the bcm2835
+ * transport, or /dev/spidev0.x when built with AD5592_NO_BCM2835.
+ * Parameters:
+ * 	none
+ * Returns:
+ * 	1 on success, 0 if the SPI could not be opened
+ */
+int AD5592_Init()
+{
+#ifndef AD5592_NO_BCM2835
+	if(!bcm2835TransportInit(&defaultBus))
+#else
+	if(!spidevTransportInit(&defaultBus, &defaultSpidev, 0, AD5592_SPI_SPEED_HZ))
+#endif
+	{
+		AD5592_InitTransport(NULL);
+		return 0;
+	}
+	AD5592_InitTransport(&defaultBus);
+	return 1;
+}
+
+/**
+ * Put the CHANNEL0 and CHANNEL1 boards on a transport.
+ * Parameters:
+ * 	bus = transport to use
+ */
+void AD5592_InitTransport(AD5592_Transport *bus)
+{
+	ad5592Channel[0].bus = bus;
+	ad5592Channel[1].bus = bus;
 }
@@ -3,25 +3,57 @@
  * Target: AD5592 on a Raspberry Pi
  * Function: AD5592 device driver for Raspberry Pi
  * Dependancies: 
- * 		-bcm2835.h v1.20 2015/03/31 04:55:41
+ * 		-AD5592Transport.h v1.0.0
+ * 		-AD5592Conv.h v1.0.0
  * Author: Tom Olenik
  * Original Date: 11 December 2016
- * Last Revised Date: 17 December 2016
+ * Last Revised Date: 16 October 2026
  * Release Notes:
  * 	* Version 1.0.0: 11 December 2016
  * 		- Initial release derrived from from AD5592.h version 1.0.2 and 
  * 			AD5592SnackATP.c version 1.0.0. 
  *  * Version 1.0.1: 17 December 2016
  *   - Several fixes. Version 1.0.0 didn't work. Don't use it. 
+ *  * Version 1.1.0: 16 October 2026
+ *   - Added getAnalogInMulti() to read several ADC channels with one
+ *     sequence register write. Added ADC sequence and result masks.
+ *   - Added spiTransfer() for multi-frame transfers. Globals are now
+ *     defined in AD5592RPI.c so the header can be shared.
+ *   - Added AD5592_Device with a shadow of every control register.
+ *     The pin mask globals are replaced by the shadow of the board
+ *     picked with setAD5592Ch() so CS0 and CS1 no longer share them.
+ *   - SPI goes through an AD5592_Transport. bcm2835.h is no longer
+ *     included here. Added AD5592_InitTransport().
+ *   - a2d() and d2a() use integer math from AD5592Conv.h with the
+ *     range picked at compile time.
+ *   - Added setAnalogOutAll() for simultaneous DAC updates through the
+ *     LDAC modes. Single DAC writes put LDAC back to immediate first.
+ *   - Pin mode changes wait microseconds from AD5592Timing.h instead
+ *     of SHORT_DELAY milliseconds.
+ *   - Built with AD5592_STATS the driver keeps the counters in
+ *     AD5592Stats.h.
+ *   - deviceTransfer(), spiTransfer() and AD5592_Init() return
+ *     whether they worked. Failed transfers are counted per board in
+ *     transferErrors.
+ *   - Added deviceSend() to send constant frames built with
+ *     AD5592Cmd.h. Frames to send are const.
+ *   - Added deviceRecord() to update the shadow for a word that is
+ *     sent anyway. It is not counted as skipped.
+ *   - A failed transfer marks the shadow registers unknown. They keep
+ *     the values last written for read-modify-writes, and
+ *     deviceKnown() tells if the board holds them.
+ *   - A GPIO input read updates the shadow GPIO read configuration.
  **********************************************************************/
 
 #ifndef SOURCES_AD5592RPI_H_
 #define SOURCES_AD5592RPI_H_
 
 /**
- * 	Change the #include to use the Serial Peripheral Diver header.
+ * 	The Serial Peripheral Driver is picked in AD5592Transport.h.
  */
-#include <bcm2835.h>
+#include <stdint.h>
+#include "AD5592Transport.h"
+#include "AD5592Conv.h"
 
 /**
  * Define the number of bytes in a standard word for the
@@ -72,26 +104,76 @@
 #define AD5592_DAC_ADDRESS_MASK		0x7000	/* DAC pin address bit mask */
 #define AD5592_DAC_VALUE_MASK		0x0FFF	/* DAC output value bit mask */
 
+/**
+ * ADC sequence register and result definitions.
+ */
+#define AD5592_ADC_SEQ_REP			0x0200	/* Repeat the ADC sequence */
+#define AD5592_ADC_SEQ_TEMP			0x0100	/* Include the temperature sensor in the sequence */
+#define AD5592_ADC_ADDRESS_MASK		0x7000	/* ADC result pin address bit mask */
+#define AD5592_ADC_VALUE_MASK		0x0FFF	/* ADC result value bit mask */
+
 /**
  * Other useful macros
  */
-#define	SHORT_DELAY	10		/* Delay used to let device do it's thing */
-#define LONG_DELAY	50		/* Longer delay to give it more time */
+#define	SHORT_DELAY	10		/* Delay used to let device do it's thing, ms. Unused, see AD5592Timing.h */
+#define LONG_DELAY	50		/* Longer delay to give it more time, ms. Unused, see AD5592Timing.h */
 
-#define CHANNEL0			BCM2835_SPI_CS0
-#define	CHANNEL1			BCM2835_SPI_CS1
+#define CHANNEL0			0		/* BCM2835_SPI_CS0 or /dev/spidev0.0 */
+#define	CHANNEL1			1		/* BCM2835_SPI_CS1 or /dev/spidev0.1 */
 
-char spiOut[2]; 			/* SPI output buffer */
-char spiIn[2];	 			/* SPI input buffer  */
+typedef unsigned short int	AD5592_WORD;
 
-uint16_t mV;					/* millivolts */
-uint16_t result;				/* result */
-uint8_t digitalOutPins = 0x00;	/* Bit mask of pins currently set as digital out */
-uint8_t digitalInPins = 0x00;	/* Bit mask of pins currently set as digital in */
-uint8_t analogOutPins = 0x00;	/* Bit mask of pins currently set as analog out */
-uint8_t analogInPins = 0x00;	/* Bit mask of pins currently set as analog in */
+extern char spiOut[2]; 			/* SPI output buffer */
+extern char spiIn[2];	 		/* SPI input buffer  */
 
-typedef unsigned short int	AD5592_WORD;
+extern uint16_t mV;				/* millivolts */
+extern uint16_t result;			/* result */
+
+/**
+ * Control register shadow definitions.
+ */
+#define AD5592_REG_COUNT			16		/* Number of control register addresses */
+#define AD5592_REG_VALUE_MASK		0x07FF	/* Control register data bit mask */
+#define AD5592_REG_INDEX(command)	(((command) & AD5592_CNTRL_ADDRESS_MASK) >> 11)
+#define AD5592_GPIO_READ_INPUT_BIT	0x0400	/* Set in a GPIO read config word to read the inputs */
+#define AD5592_REG_READBACK_EN		0x0040	/* Control register readback enable */
+#define AD5592_LDAC_MODE_MASK		0x0003	/* LDAC mode bits of the readback register */
+#define AD5592_LDAC_IMMEDIATE		0x0000	/* DAC writes go straight to the outputs */
+#define AD5592_LDAC_HOLD			0x0001	/* DAC writes stay in the input registers */
+#define AD5592_LDAC_LOAD			0x0002	/* Copy every input register to its output */
+
+/**
+ * Pin modes for deviceSetPinMode(). Modes can be combined, for example
+ * AD5592_MODE_DAC | AD5592_MODE_ADC to read back a DAC output.
+ */
+#define AD5592_MODE_DAC				0x01	/* Analog output */
+#define AD5592_MODE_ADC				0x02	/* Analog input */
+#define AD5592_MODE_GPIO_OUT		0x04	/* Digital output */
+#define AD5592_MODE_GPIO_IN			0x08	/* Digital input */
+#define AD5592_MODE_THREE_STATE		0x10	/* Three-state */
+#define AD5592_MODE_PULL_DOWN		0x20	/* 85kOhm pull-down to GND */
+#define AD5592_MODE_OPEN_DRAIN		0x40	/* Open-drain digital output */
+#define AD5592_MODE_COUNT			7		/* Number of pin mode registers */
+
+/**
+ * One AD5592 board. Keeps a shadow copy of every control register so
+ * writes that would not change anything can be skipped. A register is
+ * only trusted once it has been written or the board has been reset.
+ */
+typedef struct
+{
+	uint8_t cs;								/* Chip select the board is on */
+	AD5592_Transport *bus;					/* SPI bus the board is on */
+	AD5592_WORD reg[AD5592_REG_COUNT];		/* Shadow control registers */
+	uint16_t known;							/* Bit mask of valid shadow registers */
+	AD5592_WORD dac[8];						/* Shadow DAC input registers */
+	uint8_t dacKnown;						/* Bit mask of valid DAC shadows */
+	uint32_t writesSkipped;					/* Writes skipped by the shadow */
+	uint32_t transferErrors;				/* Transfers that failed or had no bus */
+} AD5592_Device;
+
+extern AD5592_Device ad5592Channel[2];	/* Boards on CHANNEL0 and CHANNEL1 */
+extern AD5592_Device *currentDevice;	/* Board picked by setAD5592Ch() */
 
 /**
  * Clear the spi buffer.
@@ -163,6 +245,20 @@ void setAsDAC(uint8_t pins);
  */
 void spiComs(AD5592_WORD command);
 
+/**
+ * Transfer several 16 bit frames in one call. The buffers hold the
+ * frames back to back, most significant byte first. Chip select is
+ * released between frames because the AD5592 latches each word on the
+ * rising edge of SYNC.
+ * Parameters:
+ * 	txBuf[] = frames to send
+ * 	rxBuf[] = frames received
+ * 	frames = number of 16 bit frames
+ * Returns:
+ * 	1 on success, 0 if the transfer failed
+ */
+int spiTransfer(const char txBuf[], char rxBuf[], int frames);
+
 /**
  * Set a pin to high or low output.
  * Parameters:
@@ -197,12 +293,185 @@ void setAnalogOut(uint8_t pin, uint16_t milivolts);
  */
 uint16_t getAnalogIn(uint8_t pins);
 
+/**
+ * Get analog input values for several pins with one ADC sequence. The
+ * sequence register is written once and the conversions are clocked
+ * out back to back. Each result word carries its own pin address so
+ * the values are sorted into place by that address.
+ * In repeat mode the sequence is left running on the device and later
+ * calls with the same pins skip the sequence register write.
+ * Parameters:
+ * 	Pins to read as bit mask
+ * 	milivolts[] = 8 entry array indexed by pin number. Only the
+ * 		requested pins are written. (assumes 5V reference)
+ * 	repeat = non zero to use the repeat mode of the ADC sequencer
+ * Returns:
+ * 	Number of SPI frames used, 0 if nothing was read
+ */
+int getAnalogInMulti(uint8_t pins, uint16_t milivolts[], uint8_t repeat);
+
+/**
+ * Set several analog outputs so they all change at the same time. The
+ * new values are held in the DAC input registers with LDAC mode
+ * AD5592_LDAC_HOLD and copied to the outputs together with
+ * AD5592_LDAC_LOAD, all in one transfer. Pins whose output already has
+ * the value are left out. A single changed pin is written directly.
+ * Parameters:
+ * 	Pins to write as bit mask
+ * 	milivolts[] = 8 entry array indexed by pin number. Only the
+ * 		requested pins are used. (assumes 5V reference)
+ */
+void setAnalogOutAll(uint8_t pins, uint16_t milivolts[]);
+
+/**
+ * Set up a board handle with an unknown register state.
+ * Parameters:
+ * 	dev = board handle
+ * 	bus = SPI bus the board is on
+ * 	cs = chip select the board is on
+ */
+void deviceInit(AD5592_Device *dev, AD5592_Transport *bus, uint8_t cs);
+
+/**
+ * Record a command word in the shadow registers.
+ * Parameters:
+ * 	dev = board handle
+ * 	command = AD5592 word about to be sent
+ * Returns:
+ * 	0 if the word would not change the board and can be skipped
+ */
+int deviceUpdate(AD5592_Device *dev, AD5592_WORD command);
+
+/**
+ * Record a command word that is sent whatever the shadow holds, so it
+ * is counted as sent and never as skipped.
+ * Parameters:
+ * 	dev = board handle
+ * 	command = AD5592 word about to be sent
+ */
+void deviceRecord(AD5592_Device *dev, AD5592_WORD command);
+
+/**
+ * Get the shadow value of a control register.
+ * Parameters:
+ * 	dev = board handle
+ * 	reg = register command, for example AD5592_DAC_PIN_SELECT
+ * Returns:
+ * 	Register data bits last written, 0 before the first write
+ */
+AD5592_WORD deviceRegister(AD5592_Device *dev, AD5592_WORD reg);
+
+/**
+ * Check whether the board is known to hold the shadow value of a
+ * control register. Code that skips a configuration write because the
+ * shadow already has it must check this first.
+ * Parameters:
+ * 	dev = board handle
+ * 	reg = register command, for example AD5592_DAC_PIN_SELECT
+ * Returns:
+ * 	1 if it is, 0 before the first write or after a failed transfer
+ */
+int deviceKnown(AD5592_Device *dev, AD5592_WORD reg);
+
+/**
+ * Send a command word to a board unless the shadow shows it would not
+ * change anything.
+ * Parameters:
+ * 	dev = board handle
+ * 	command = AD5592 word
+ * Returns:
+ * 	1 if the word was sent, 0 if it was skipped
+ */
+int deviceWrite(AD5592_Device *dev, AD5592_WORD command);
+
+/**
+ * Software reset a board. The shadow is set to the power on values.
+ * Parameters:
+ * 	dev = board handle
+ */
+void deviceReset(AD5592_Device *dev);
+
+/**
+ * Work out the register writes needed to put pins into a mode. Pins
+ * are removed from every other pin mode register. Each register gets at
+ * most one write, registers losing pins come first and registers that
+ * would not change are left out.
+ * Parameters:
+ * 	dev = board handle
+ * 	pins = pins as bit mask
+ * 	mode = AD5592_MODE_ flags
+ * 	words[] = AD5592_MODE_COUNT entry array for the writes
+ * Returns:
+ * 	Number of words needed
+ */
+int devicePinModeWords(AD5592_Device *dev, uint8_t pins, uint8_t mode,
+	AD5592_WORD words[]);
+
+/**
+ * Put pins into a mode with the fewest register writes.
+ * Parameters:
+ * 	dev = board handle
+ * 	pins = pins as bit mask
+ * 	mode = AD5592_MODE_ flags
+ * Returns:
+ * 	Number of words sent
+ */
+int deviceSetPinMode(AD5592_Device *dev, uint8_t pins, uint8_t mode);
+
+/**
+ * Put every pin into its own mode with the fewest register writes.
+ * Parameters:
+ * 	dev = board handle
+ * 	modes[] = 8 entry array of AD5592_MODE_ flags indexed by pin number
+ * Returns:
+ * 	Number of words sent
+ */
+int deviceSetPinModes(AD5592_Device *dev, const uint8_t modes[]);
+
+/**
+ * Transfer frames to a board, selecting its chip select first.
+ * Parameters:
+ * 	dev = board handle
+ * 	txBuf[] = frames to send
+ * 	rxBuf[] = frames received
+ * 	frames = number of 16 bit frames
+ * Returns:
+ * 	1 on success, 0 if the transfer failed. Failures are also counted
+ * 	in dev->transferErrors and mark every shadow register unknown.
+ */
+int deviceTransfer(AD5592_Device *dev, const char txBuf[], char rxBuf[], int frames);
+
+/**
+ * Send frames that are already built, like a constant sequence made
+ * with AD5592Cmd.h, and keep the shadow registers in step with them.
+ * Parameters:
+ * 	dev = board handle
+ * 	frames[] = frames to send, most significant byte first
+ * 	rxBuf[] = frames received
+ * 	count = number of 16 bit frames
+ * Returns:
+ * 	1 on success, 0 if the transfer failed
+ */
+int deviceSend(AD5592_Device *dev, const char frames[], char rxBuf[], int count);
+
 /**
  * Initialize the SPI for using the AD5592. Does not set channel. Do that
- * after calling this function by calling setAD5592Ch().
+ * after calling this function by calling setAD5592Ch(). Uses the bcm2835
+ * transport, or /dev/spidev0.x when built with AD5592_NO_BCM2835.
  * Parameters:
  * 	none
+ * Returns:
+ * 	1 on success, 0 if the SPI could not be opened. The boards are
+ * 	left without a bus then and every transfer fails.
+ */
+int AD5592_Init();
+
+/**
+ * Put the CHANNEL0 and CHANNEL1 boards on a transport instead of the
+ * one AD5592_Init() sets up.
+ * Parameters:
+ * 	bus = transport to use
  */
-void AD5592_Init();
+void AD5592_InitTransport(AD5592_Transport *bus);
 
 #endif /* SOURCES_AD5592RPI_H_ */
@@ -0,0 +1,410 @@
+/***********************************************************************
+ * File: AD5592Registry.c
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Boards on several SPI buses with a worker thread per bus
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Transport.h v1.0.0
+ * 		-AD5592Registry.h
+ * 		-pthread
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ **********************************************************************/
+
+#include <string.h>
+#include "AD5592Registry.h"
+
+/**
+ * Mark a job done and wake anyone waiting for it. The job is not touched
+ * after done is set, the caller may reuse it straight away.
+ */
+static void registryFinish(AD5592_Registry *registry, AD5592_Job *job)
+{
+	atomic_store(&job->done, 1);
+	atomic_fetch_sub(&registry->outstanding, 1);
+	pthread_mutex_lock(&registry->doneLock);
+	pthread_cond_broadcast(&registry->doneCond);
+	pthread_mutex_unlock(&registry->doneLock);
+}
+
+/**
+ * Take the oldest job off a bus queue.
+ * Returns:
+ * 	Job, or NULL if none is waiting
+ */
+static AD5592_Job *registryPopJob(AD5592_RegistryBus *bus)
+{
+	AD5592_Job *job;
+
+	if(atomic_load(&bus->queued) == 0)
+	{
+		return NULL;
+	}
+	pthread_mutex_lock(&bus->queueLock);
+	job = bus->head;
+	if(job != NULL)
+	{
+		bus->head = job->next;
+		if(bus->head == NULL)
+		{
+			bus->tail = NULL;
+		}
+		atomic_fetch_sub(&bus->queued, 1);
+	}
+	pthread_mutex_unlock(&bus->queueLock);
+	return job;
+}
+
+/**
+ * Put a decode on the owner end of a deque and wake a sleeping worker
+ * to steal it.
+ * Returns:
+ * 	1 if it was queued, 0 if the deque is full
+ */
+static int registryPushDecode(AD5592_Registry *registry, AD5592_RegistryBus *bus, AD5592_Job *job)
+{
+	int i;
+
+	pthread_mutex_lock(&bus->decodeLock);
+	if(bus->bottom >= AD5592_REGISTRY_DECODES)
+	{
+		pthread_mutex_unlock(&bus->decodeLock);
+		return 0;
+	}
+	bus->decode[bus->bottom++] = job;
+	atomic_fetch_add(&registry->decodes, 1);
+	pthread_mutex_unlock(&bus->decodeLock);
+
+	/* A worker counts itself sleeping before it checks for decodes, so
+	 * one of the two always sees the other */
+	if(atomic_load(&registry->sleeping) > 0)
+	{
+		pthread_mutex_lock(&registry->idleLock);
+		for(i = 0; i < registry->buses; i++)
+		{
+			pthread_cond_signal(&registry->bus[i].wake);
+		}
+		pthread_mutex_unlock(&registry->idleLock);
+	}
+	return 1;
+}
+
+/**
+ * Take a decode off a deque, the newest from the owner end or the
+ * oldest from the thief end.
+ * Returns:
+ * 	Job, or NULL if the deque is empty
+ */
+static AD5592_Job *registryPopDecode(AD5592_Registry *registry, AD5592_RegistryBus *bus, int steal)
+{
+	AD5592_Job *job = NULL;
+
+	pthread_mutex_lock(&bus->decodeLock);
+	if(bus->top < bus->bottom)
+	{
+		job = steal ? bus->decode[bus->top++] : bus->decode[--bus->bottom];
+		if(bus->top == bus->bottom)
+		{
+			bus->top = 0;
+			bus->bottom = 0;
+		}
+		atomic_fetch_sub(&registry->decodes, 1);
+	}
+	pthread_mutex_unlock(&bus->decodeLock);
+	return job;
+}
+
+/**
+ * Find a decode to run, from the worker's own deque first.
+ * Returns:
+ * 	Job, or NULL if no deque has one
+ */
+static AD5592_Job *registryFindDecode(AD5592_Registry *registry, int self)
+{
+	AD5592_Job *job;
+	int victim;
+	int i;
+
+	if(atomic_load(&registry->decodes) == 0)
+	{
+		return NULL;
+	}
+	job = registryPopDecode(registry, &registry->bus[self], 0);
+	for(i = 1; job == NULL && i < registry->buses; i++)
+	{
+		victim = (self + i) % registry->buses;
+		job = registryPopDecode(registry, &registry->bus[victim], 1);
+		if(job != NULL)
+		{
+			registry->bus[self].steals++;
+		}
+	}
+	return job;
+}
+
+/**
+ * Worker of one bus. Transfers for the bus come first so it is never
+ * idle while there is work for it, then decodes from any worker.
+ */
+static void *registryThread(void *arg)
+{
+	AD5592_RegistryBus *bus = arg;
+	AD5592_Registry *registry = bus->registry;
+	AD5592_Job *job;
+	int stop;
+
+	while(1)
+	{
+		job = registryPopJob(bus);
+		if(job != NULL)
+		{
+			job->transfer(&registry->board[job->board], job);
+			bus->transfers++;
+			if(job->decode == NULL)
+			{
+				registryFinish(registry, job);
+			}else if(!registryPushDecode(registry, bus, job))
+			{
+				job->decode(job);
+				bus->decodes++;
+				registryFinish(registry, job);
+			}
+			continue;
+		}
+
+		job = registryFindDecode(registry, bus->number);
+		if(job != NULL)
+		{
+			job->decode(job);
+			bus->decodes++;
+			registryFinish(registry, job);
+			continue;
+		}
+
+		pthread_mutex_lock(&registry->idleLock);
+		atomic_fetch_add(&registry->sleeping, 1);
+		while(atomic_load(&registry->running) && atomic_load(&bus->queued) == 0 &&
+			atomic_load(&registry->decodes) == 0)
+		{
+			pthread_cond_wait(&bus->wake, &registry->idleLock);
+		}
+		atomic_fetch_sub(&registry->sleeping, 1);
+		stop = !atomic_load(&registry->running) && atomic_load(&bus->queued) == 0 &&
+			atomic_load(&registry->decodes) == 0;
+		pthread_mutex_unlock(&registry->idleLock);
+		if(stop)
+		{
+			break;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Set up an empty registry.
+ * Parameters:
+ * 	registry = registry to set up
+ */
+void registryInit(AD5592_Registry *registry)
+{
+	memset(registry, 0, sizeof(*registry));
+	atomic_init(&registry->decodes, 0);
+	atomic_init(&registry->outstanding, 0);
+	atomic_init(&registry->sleeping, 0);
+	atomic_init(&registry->running, 0);
+	pthread_mutex_init(&registry->idleLock, NULL);
+	pthread_mutex_init(&registry->doneLock, NULL);
+	pthread_cond_init(&registry->doneCond, NULL);
+}
+
+/**
+ * Add a bus.
+ * Parameters:
+ * 	registry = registry
+ * 	transport = bus, already set up
+ * Returns:
+ * 	Bus number, or -1 if there is no room
+ */
+int registryAddBus(AD5592_Registry *registry, AD5592_Transport *transport)
+{
+	AD5592_RegistryBus *bus;
+
+	if(registry->buses >= AD5592_REGISTRY_BUSES)
+	{
+		return -1;
+	}
+	bus = &registry->bus[registry->buses];
+	memset(bus, 0, sizeof(*bus));
+	bus->registry = registry;
+	bus->number = registry->buses;
+	bus->transport = transport;
+	atomic_init(&bus->queued, 0);
+	pthread_mutex_init(&bus->queueLock, NULL);
+	pthread_mutex_init(&bus->decodeLock, NULL);
+	pthread_cond_init(&bus->wake, NULL);
+	return registry->buses++;
+}
+
+/**
+ * Add a board on a bus.
+ * Parameters:
+ * 	registry = registry
+ * 	bus = bus number from registryAddBus()
+ * 	cs = chip select of the board on that bus
+ * Returns:
+ * 	Board number, or -1 if there is no room, the bus does not exist or
+ * 	another board has the chip select
+ */
+int registryAddBoard(AD5592_Registry *registry, int bus, uint8_t cs)
+{
+	int i;
+
+	if(registry->boards >= AD5592_REGISTRY_BOARDS || bus < 0 || bus >= registry->buses ||
+		cs >= AD5592_TRANSPORT_MAX_CS)
+	{
+		return -1;
+	}
+	for(i = 0; i < registry->boards; i++)
+	{
+		if(registry->boardBus[i] == bus && registry->board[i].cs == cs)
+		{
+			return -1;
+		}
+	}
+	deviceInit(&registry->board[registry->boards], registry->bus[bus].transport, cs);
+	registry->boardBus[registry->boards] = bus;
+	return registry->boards++;
+}
+
+/**
+ * Get a board.
+ * Parameters:
+ * 	registry = registry
+ * 	board = board number
+ * Returns:
+ * 	Board
+ */
+AD5592_Device *registryBoard(AD5592_Registry *registry, int board)
+{
+	return &registry->board[board];
+}
+
+/**
+ * Start a worker for every bus.
+ * Parameters:
+ * 	registry = registry
+ * Returns:
+ * 	1 on success, 0 if a worker could not be started
+ */
+int registryStart(AD5592_Registry *registry)
+{
+	int i;
+
+	atomic_store(&registry->running, 1);
+	for(i = 0; i < registry->buses; i++)
+	{
+		if(pthread_create(&registry->bus[i].thread, NULL, registryThread, &registry->bus[i]) != 0)
+		{
+			registry->started = i;
+			registryStop(registry);
+			return 0;
+		}
+	}
+	registry->started = registry->buses;
+	return 1;
+}
+
+/**
+ * Finish every job submitted so far and stop the workers.
+ * Parameters:
+ * 	registry = registry
+ */
+void registryStop(AD5592_Registry *registry)
+{
+	int i;
+
+	if(registry->started == registry->buses)
+	{
+		registryDrain(registry);
+	}
+	pthread_mutex_lock(&registry->idleLock);
+	atomic_store(&registry->running, 0);
+	for(i = 0; i < registry->buses; i++)
+	{
+		pthread_cond_signal(&registry->bus[i].wake);
+	}
+	pthread_mutex_unlock(&registry->idleLock);
+	for(i = 0; i < registry->started; i++)
+	{
+		pthread_join(registry->bus[i].thread, NULL);
+	}
+	registry->started = 0;
+}
+
+/**
+ * Submit a job for a board.
+ * Parameters:
+ * 	registry = registry
+ * 	board = board number
+ * 	job = job with transfer set, and decode and arg if used
+ */
+void registrySubmit(AD5592_Registry *registry, int board, AD5592_Job *job)
+{
+	AD5592_RegistryBus *bus = &registry->bus[registry->boardBus[board]];
+
+	job->board = board;
+	job->next = NULL;
+	atomic_store(&job->done, 0);
+	atomic_fetch_add(&registry->outstanding, 1);
+
+	pthread_mutex_lock(&bus->queueLock);
+	if(bus->tail == NULL)
+	{
+		bus->head = job;
+	}else
+	{
+		bus->tail->next = job;
+	}
+	bus->tail = job;
+	atomic_fetch_add(&bus->queued, 1);
+	pthread_mutex_unlock(&bus->queueLock);
+
+	pthread_mutex_lock(&registry->idleLock);
+	pthread_cond_signal(&bus->wake);
+	pthread_mutex_unlock(&registry->idleLock);
+}
+
+/**
+ * Wait for a job to be done.
+ * Parameters:
+ * 	registry = registry it was submitted to
+ * 	job = job
+ */
+void registryWait(AD5592_Registry *registry, AD5592_Job *job)
+{
+	pthread_mutex_lock(&registry->doneLock);
+	while(!atomic_load(&job->done))
+	{
+		pthread_cond_wait(&registry->doneCond, &registry->doneLock);
+	}
+	pthread_mutex_unlock(&registry->doneLock);
+}
+
+/**
+ * Wait for every job submitted so far to be done.
+ * Parameters:
+ * 	registry = registry
+ */
+void registryDrain(AD5592_Registry *registry)
+{
+	pthread_mutex_lock(&registry->doneLock);
+	while(atomic_load(&registry->outstanding) > 0)
+	{
+		pthread_cond_wait(&registry->doneCond, &registry->doneLock);
+	}
+	pthread_mutex_unlock(&registry->doneLock);
+}
@@ -0,0 +1,206 @@
+/*********************************************************************
+ * File: AD5592Registry.h
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Boards on several SPI buses with a worker thread per bus
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Transport.h v1.0.0
+ * 		-pthread
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ *
+ * A registry holds up to AD5592_REGISTRY_BUSES transports and up to
+ * AD5592_REGISTRY_BOARDS boards on any chip selects of them. Each bus
+ * has one worker thread, the only user of the bus and its boards while
+ * the registry runs, so boards on different buses work in parallel and
+ * boards on one bus take turns.
+ *
+ * A job has two stages:
+ * 	1. transfer runs on the worker of the board's bus and does the SPI
+ * 		work with the AD5592_Device it is given. Jobs of one bus run in
+ * 		the order they were submitted.
+ * 	2. decode, if set, is CPU work on what was received, like
+ * 		decodeAdcFrames() or filterFrames(). It goes on the deque of the
+ * 		worker that did the transfer and may run on any worker. A
+ * 		worker with no transfers waiting takes the newest decode from
+ * 		its own deque, then steals the oldest from the others, so a
+ * 		bus with heavy decoding does not hold back its own transfers.
+ * A job is done once both stages have run.
+ *
+ * Jobs are owned by the caller and must stay put until they are done.
+ *
+ * The CHANNEL0 and CHANNEL1 functions keep using ad5592Channel[] and are
+ * not affected. A board may not be in a registry and used through them
+ * at the same time.
+ **********************************************************************/
+
+#ifndef SOURCES_AD5592REGISTRY_H_
+#define SOURCES_AD5592REGISTRY_H_
+
+#include <stdatomic.h>
+#include <pthread.h>
+#include "AD5592RPI.h"
+#include "AD5592Transport.h"
+
+#define AD5592_REGISTRY_BUSES		8		/* Most buses, one worker each */
+#define AD5592_REGISTRY_BOARDS		32		/* Most boards over all buses */
+#define AD5592_REGISTRY_DECODES		64		/* Decodes a worker holds before running them itself */
+
+typedef struct AD5592_Job AD5592_Job;
+typedef struct AD5592_Registry AD5592_Registry;
+
+/**
+ * One job for a board.
+ */
+struct AD5592_Job
+{
+	/**
+	 * SPI work. Runs on the worker of the board's bus.
+	 * Parameters:
+	 * 	dev = board
+	 * 	job = this job
+	 */
+	void (*transfer)(AD5592_Device *dev, AD5592_Job *job);
+
+	/**
+	 * CPU work after the transfer, may be NULL. Runs on any worker and
+	 * must not use the bus.
+	 * Parameters:
+	 * 	job = this job
+	 */
+	void (*decode)(AD5592_Job *job);
+
+	void *arg;						/* For the stages */
+	int board;						/* Board number, set by registrySubmit() */
+	AD5592_Job *next;				/* Bus queue link */
+	atomic_int done;				/* Set when both stages have run */
+};
+
+/**
+ * One bus and its worker.
+ */
+typedef struct
+{
+	AD5592_Registry *registry;					/* Registry the bus is in */
+	int number;									/* Bus number */
+	AD5592_Transport *transport;				/* Bus */
+	AD5592_Job *head;							/* Oldest job waiting for the bus */
+	AD5592_Job *tail;							/* Newest job waiting for the bus */
+	atomic_int queued;							/* Jobs waiting for the bus */
+	pthread_mutex_t queueLock;					/* Held to change the queue */
+	AD5592_Job *decode[AD5592_REGISTRY_DECODES];	/* Deque of decodes */
+	int bottom;									/* Next free deque slot, owner end */
+	int top;									/* Oldest deque slot, thief end */
+	pthread_mutex_t decodeLock;					/* Held to change the deque */
+	pthread_cond_t wake;						/* Signalled when there is work for the worker */
+	pthread_t thread;							/* Worker */
+	uint32_t transfers;							/* Transfer stages run */
+	uint32_t decodes;							/* Decode stages run */
+	uint32_t steals;							/* Decodes taken from other workers */
+} AD5592_RegistryBus;
+
+/**
+ * A registry.
+ */
+struct AD5592_Registry
+{
+	AD5592_RegistryBus bus[AD5592_REGISTRY_BUSES];	/* Buses by number */
+	int buses;										/* Buses in use */
+	AD5592_Device board[AD5592_REGISTRY_BOARDS];	/* Boards by number */
+	uint8_t boardBus[AD5592_REGISTRY_BOARDS];		/* Bus number of each board */
+	int boards;										/* Boards in use */
+	atomic_int decodes;								/* Decodes waiting on all deques */
+	atomic_int outstanding;							/* Jobs submitted and not done */
+	atomic_int sleeping;							/* Workers waiting for work */
+	atomic_int running;								/* Cleared to stop the workers */
+	int started;									/* Workers started */
+	pthread_mutex_t idleLock;						/* Held by workers going to sleep */
+	pthread_mutex_t doneLock;						/* Held by threads waiting for jobs */
+	pthread_cond_t doneCond;						/* Broadcast when a job is done */
+};
+
+/**
+ * Set up an empty registry.
+ * Parameters:
+ * 	registry = registry to set up
+ */
+void registryInit(AD5592_Registry *registry);
+
+/**
+ * Add a bus. Call before registryStart().
+ * Parameters:
+ * 	registry = registry
+ * 	transport = bus, already set up
+ * Returns:
+ * 	Bus number, or -1 if there is no room
+ */
+int registryAddBus(AD5592_Registry *registry, AD5592_Transport *transport);
+
+/**
+ * Add a board on a bus. Call before registryStart().
+ * Parameters:
+ * 	registry = registry
+ * 	bus = bus number from registryAddBus()
+ * 	cs = chip select of the board on that bus
+ * Returns:
+ * 	Board number, or -1 if there is no room, the bus does not exist or
+ * 	another board has the chip select
+ */
+int registryAddBoard(AD5592_Registry *registry, int bus, uint8_t cs);
+
+/**
+ * Get a board. Only use it outside a job while the registry is stopped.
+ * Parameters:
+ * 	registry = registry
+ * 	board = board number
+ * Returns:
+ * 	Board
+ */
+AD5592_Device *registryBoard(AD5592_Registry *registry, int board);
+
+/**
+ * Start a worker for every bus.
+ * Parameters:
+ * 	registry = registry
+ * Returns:
+ * 	1 on success, 0 if a worker could not be started. None run then.
+ */
+int registryStart(AD5592_Registry *registry);
+
+/**
+ * Finish every job submitted so far and stop the workers.
+ * Parameters:
+ * 	registry = registry
+ */
+void registryStop(AD5592_Registry *registry);
+
+/**
+ * Submit a job for a board. Safe to call from any thread, including
+ * from the stages of another job.
+ * Parameters:
+ * 	registry = registry
+ * 	board = board number
+ * 	job = job with transfer set, and decode and arg if used
+ */
+void registrySubmit(AD5592_Registry *registry, int board, AD5592_Job *job);
+
+/**
+ * Wait for a job to be done.
+ * Parameters:
+ * 	registry = registry it was submitted to
+ * 	job = job
+ */
+void registryWait(AD5592_Registry *registry, AD5592_Job *job);
+
+/**
+ * Wait for every job submitted so far to be done.
+ * Parameters:
+ * 	registry = registry
+ */
+void registryDrain(AD5592_Registry *registry);
+
+#endif /* SOURCES_AD5592REGISTRY_H_ */
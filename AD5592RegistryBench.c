@@ -0,0 +1,298 @@
+/**
+ * File: AD5592RegistryBench.c
+ * Target: Raspberry Pi or any Linux host
+ * Function: Throughput of an AD5592_Registry on one, two and four buses
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Registry.h v1.0.0
+ * 		-AD5592Decode.h v1.0.0
+ * 		-AD5592Sim.h v1.2.0
+ * 		-AD5592Clock.h v1.0.0
+ * 		-pthread
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version: 1.0.0:
+ * 		-Usage: AD5592RegistryBench [-b buses] [-n jobs] [-f us per frame]
+ * 			[-d decode passes]
+ *
+ * 		-Runs the same workload on a registry of 1, 2, 4 ... buses, up
+ * 		to -b (4 by default). Every bus is a simulator with two boards,
+ * 		on CS0 and CS1, behind a transport that sleeps -f us a frame
+ * 		(16 by default) like a real SPI bus at about 1 MHz.
+ *
+ * 		-Each board gets -n jobs (16 by default). A job puts the board
+ * 		in ADC mode and reads BENCH_FRAMES frames of a repeating scan of
+ * 		all 8 pins, then decodes them -d times (400 by default) so the
+ * 		decode stage is heavy enough to be stolen between workers.
+ *
+ * 		-Prints one line per bus count:
+ * 			buses jobs seconds jobs_per_sec transfers decodes steals bad
+ * 		bad counts jobs whose samples are not the voltages applied to
+ * 		the simulated pins. Exits with 1 if any job is bad.
+ *
+ * 		-Builds on a Linux host with:
+ * 			gcc -O2 -DAD5592_NO_BCM2835 -o AD5592RegistryBench \
+ * 				AD5592RegistryBench.c AD5592Registry.c AD5592Decode.c \
+ * 				AD5592RPI.c AD5592Batch.c AD5592Timing.c \
+ * 				AD5592Transport.c AD5592Sim.c -lpthread
+ * 		Add -fsanitize=thread to check the registry for data races.
+ *
+ **********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "AD5592RPI.h"
+#include "AD5592Registry.h"
+#include "AD5592Decode.h"
+#include "AD5592Sim.h"
+#include "AD5592Clock.h"
+
+#define BENCH_BUSES			4		/* Most buses */
+#define BENCH_BOARDS		2		/* Boards on each bus */
+#define BENCH_JOBS			64		/* Most jobs per board */
+#define BENCH_FRAMES		512		/* Frames read per job */
+
+/**
+ * Data of one job.
+ */
+typedef struct
+{
+	char rxBuf[2 * BENCH_FRAMES];			/* Frames read */
+	uint16_t samples[8][BENCH_FRAMES];		/* Decoded samples by pin */
+	int stored;								/* Samples stored by the last decode */
+} BenchWork;
+
+AD5592_Sim sim[BENCH_BUSES];				/* One simulator per bus */
+AD5592_Transport simBus[BENCH_BUSES];		/* Simulator transports */
+AD5592_Transport slowBus[BENCH_BUSES];		/* Slowed down transports the registry uses */
+AD5592_Registry registry;
+AD5592_Job job[BENCH_BUSES][BENCH_BOARDS][BENCH_JOBS];
+BenchWork work[BENCH_BUSES][BENCH_BOARDS][BENCH_JOBS];
+char nops[2 * BENCH_FRAMES];				/* NOP frames to clock the results out */
+long frameNs = 16000;						/* Time a frame takes on the bus */
+int decodePasses = 400;						/* Decodes per job */
+
+/**
+ * Voltage applied to a pin of a simulated board.
+ */
+static uint16_t benchMilivolts(int bus, int board, int pin)
+{
+	return board ? 2000 + pin : 1000 + pin * 100 + bus;
+}
+
+/**
+ * Transfer on the simulator, then sleep for the time the frames would
+ * take on a real bus.
+ */
+static int slowTransfer(AD5592_Transport *bus, uint8_t cs, const char txBuf[],
+	char rxBuf[], int frames)
+{
+	AD5592_Transport *inner = bus->context;
+	struct timespec wait = {0, frames * frameNs};
+	int ok = transportTransfer(inner, cs, txBuf, rxBuf, frames);
+
+	while(wait.tv_nsec >= 1000000000)
+	{
+		wait.tv_sec++;
+		wait.tv_nsec -= 1000000000;
+	}
+	nanosleep(&wait, NULL);
+	return ok;
+}
+
+/**
+ * Transfer stage. Reads BENCH_FRAMES frames of a repeating scan.
+ */
+static void benchTransfer(AD5592_Device *dev, AD5592_Job *job)
+{
+	BenchWork *bench = job->arg;
+	char rxBuf[2];
+
+	deviceSetPinMode(dev, AD5592_PIN_SELECT_MASK, AD5592_MODE_ADC);
+	deviceWrite(dev, AD5592_ADC_READ | AD5592_ADC_SEQ_REP | AD5592_PIN_SELECT_MASK);
+	deviceTransfer(dev, nops, rxBuf, 1);	/* First result comes out two frames after */
+	deviceTransfer(dev, nops, bench->rxBuf, BENCH_FRAMES);
+	deviceWrite(dev, AD5592_ADC_READ);		/* Stop the sequence */
+}
+
+/**
+ * Decode stage.
+ */
+static void benchDecode(AD5592_Job *job)
+{
+	BenchWork *bench = job->arg;
+	uint16_t *channel[8];
+	int count[8];
+	int pass;
+	int pin;
+
+	for(pass = 0; pass < decodePasses; pass++)
+	{
+		for(pin = 0; pin < 8; pin++)
+		{
+			channel[pin] = bench->samples[pin];
+			count[pin] = 0;
+		}
+		bench->stored = decodeAdcFrames(bench->rxBuf, BENCH_FRAMES, channel, count, BENCH_FRAMES);
+	}
+}
+
+/**
+ * Run the workload on a number of buses.
+ * Returns:
+ * 	Jobs with wrong samples
+ */
+static int benchRun(int buses, int jobs)
+{
+	int board[BENCH_BUSES][BENCH_BOARDS];
+	uint32_t transfers = 0;
+	uint32_t decodes = 0;
+	uint32_t steals = 0;
+	uint64_t start;
+	double seconds;
+	BenchWork *bench;
+	AD5592_Job *next;
+	int number;
+	int bad = 0;
+	int wrong;
+	int i;
+	int b;
+	int k;
+	int pin;
+	int expect;
+
+	registryInit(&registry);
+	for(i = 0; i < buses; i++)
+	{
+		number = registryAddBus(&registry, &slowBus[i]);
+		for(b = 0; b < BENCH_BOARDS; b++)
+		{
+			board[i][b] = registryAddBoard(&registry, number, b);
+		}
+	}
+	if(!registryStart(&registry))
+	{
+		printf("Could not start the workers\n");
+		return jobs * buses * BENCH_BOARDS;
+	}
+
+	/* Jobs go round the boards so every bus has work from the start */
+	start = clockNowNs();
+	for(k = 0; k < jobs; k++)
+	{
+		for(i = 0; i < buses; i++)
+		{
+			for(b = 0; b < BENCH_BOARDS; b++)
+			{
+				next = &job[i][b][k];
+				memset(next, 0, sizeof(*next));
+				memset(&work[i][b][k], 0, sizeof(work[i][b][k]));
+				next->transfer = benchTransfer;
+				next->decode = benchDecode;
+				next->arg = &work[i][b][k];
+				registrySubmit(&registry, board[i][b], next);
+			}
+		}
+	}
+	registryDrain(&registry);
+	seconds = (clockNowNs() - start) / 1e9;
+	for(i = 0; i < buses; i++)
+	{
+		transfers += registry.bus[i].transfers;
+		decodes += registry.bus[i].decodes;
+		steals += registry.bus[i].steals;
+	}
+	registryStop(&registry);
+
+	for(i = 0; i < buses; i++)
+	{
+		for(b = 0; b < BENCH_BOARDS; b++)
+		{
+			for(k = 0; k < jobs; k++)
+			{
+				bench = &work[i][b][k];
+				wrong = bench->stored != BENCH_FRAMES;
+				for(pin = 0; pin < 8; pin++)
+				{
+					expect = benchMilivolts(i, b, pin);
+					if(abs((int)bench->samples[pin][BENCH_FRAMES / 8 - 1] - expect) > 2)
+					{
+						wrong = 1;
+					}
+				}
+				bad += wrong;
+			}
+		}
+	}
+	printf("%d %d %.3f %.0f %u %u %u %d\n", buses, buses * BENCH_BOARDS * jobs, seconds,
+		buses * BENCH_BOARDS * jobs / seconds, transfers, decodes, steals, bad);
+	return bad;
+}
+
+int main(int argc, char **argv)
+{
+	int maxBuses = BENCH_BUSES;
+	int jobs = 16;
+	int bad = 0;
+	int option;
+	int buses;
+	int i;
+	int b;
+	int pin;
+
+	while((option = getopt(argc, argv, "b:n:f:d:")) != -1)
+	{
+		switch(option)
+		{
+			case 'b':
+				maxBuses = atoi(optarg);
+				break;
+			case 'n':
+				jobs = atoi(optarg);
+				break;
+			case 'f':
+				frameNs = atol(optarg) * 1000;
+				break;
+			case 'd':
+				decodePasses = atoi(optarg);
+				break;
+			default:
+				maxBuses = 0;
+				break;
+		}
+	}
+	if(maxBuses < 1 || maxBuses > BENCH_BUSES || jobs < 1 || jobs > BENCH_JOBS ||
+		frameNs < 0 || decodePasses < 1)
+	{
+		printf("Usage: %s [-b buses, 1 to %d] [-n jobs, 1 to %d] [-f us per frame]"
+			" [-d decode passes]\n", argv[0], BENCH_BUSES, BENCH_JOBS);
+		return 1;
+	}
+
+	for(i = 0; i < BENCH_BUSES; i++)
+	{
+		simInit(&sim[i], 0);
+		for(b = 0; b < BENCH_BOARDS; b++)
+		{
+			for(pin = 0; pin < 8; pin++)
+			{
+				simSetInput(&sim[i], b, pin, benchMilivolts(i, b, pin));
+			}
+		}
+		simTransportInit(&simBus[i], &sim[i]);
+		memset(&slowBus[i], 0, sizeof(slowBus[i]));
+		slowBus[i].transfer = slowTransfer;
+		slowBus[i].context = &simBus[i];
+	}
+
+	printf("buses jobs seconds jobs_per_sec transfers decodes steals bad\n");
+	for(buses = 1; buses <= maxBuses; buses *= 2)
+	{
+		bad += benchRun(buses, jobs);
+	}
+	return bad ? 1 : 0;
+}
@@ -0,0 +1,396 @@
+/**
+ * File: AD5592Replay.c
+ * Target: Raspberry Pi or any Linux host
+ * Function: Replays AD5592 SPI traces and works out what other batching
+ * 		would save
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Transport.h v1.0.0
+ * 		-AD5592Sim.h v1.0.1
+ * 		-AD5592Trace.h v1.0.0
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version: 1.0.0:
+ * 		-Usage: AD5592Replay [-t sim|loopback|spidev|bcm2835|none]
+ * 			[-a counts] [-v] trace
+ * 		Sends every frame of the trace through the transport, sim by
+ * 		default with the two boards cross wired like the ATP jig, and
+ * 		compares what comes back with what the trace received. ADC
+ * 		results match when they are for the same pin and within -a
+ * 		counts, 41 (1% of full scale) by default. Every other frame
+ * 		must match exactly. The first 20 differences are printed, all of
+ * 		them with -v. -t none only does the analysis below.
+ *
+ * 		-Prints the frames and transfers each strategy in the
+ * 		strategies table would have saved on the traced workload. A new
+ * 		strategy is a function that looks at each transfer in order and
+ * 		adds to its savings, and a line in the table.
+ *
+ * 		-Exits with 1 if any frame differs.
+ *
+ * 		-Builds on a Linux host with:
+ * 			gcc -O2 -DAD5592_NO_BCM2835 -o AD5592Replay AD5592Replay.c \
+ * 				AD5592Trace.c AD5592RPI.c AD5592Transport.c AD5592Sim.c \
+ * 				AD5592Timing.c AD5592Batch.c
+ *
+ **********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "AD5592RPI.h"
+#include "AD5592Sim.h"
+#include "AD5592Trace.h"
+
+#define DEFAULT_TOLERANCE	41		/* ADC counts, 1% of full scale */
+#define SHOWN_DIFFERENCES	20		/* Differences printed without -v */
+
+/**
+ * What a batching strategy would have saved.
+ */
+typedef struct
+{
+	uint64_t frames;							/* Frames not sent */
+	uint64_t transfers;							/* Transfers not made */
+	AD5592_Device dev[AD5592_TRANSPORT_MAX_CS];	/* Shadow of each board */
+	const AD5592_TraceRecord *last[AD5592_TRANSPORT_MAX_CS];	/* Last transfer to each board */
+	const AD5592_TraceRecord *previous;			/* Last transfer to any board */
+} Savings;
+
+/**
+ * A batching strategy. Called with every transfer of the trace in order.
+ */
+typedef struct
+{
+	const char *name;
+	const char *description;
+	void (*transfer)(Savings *savings, const AD5592_TraceRecord *record);
+} Strategy;
+
+/**
+ * Get a frame of a buffer.
+ */
+static AD5592_WORD frameWord(const uint8_t *frames, int i)
+{
+	return (frames[2 * i] << 8) | frames[2 * i + 1];
+}
+
+/**
+ * Check if a word asks for data in the next frame.
+ */
+static int isReadback(AD5592_WORD word)
+{
+	if(word & AD5592_DAC_WRITE_MASK)
+	{
+		return 0;
+	}
+	switch(word & AD5592_CNTRL_ADDRESS_MASK)
+	{
+		case AD5592_DAC_READBACK:
+			return (word & AD5592_DAC_READBACK_EN) == AD5592_DAC_READBACK_EN;
+		case AD5592_CNTRL_REG_READBACK:
+			return (word & AD5592_REG_READBACK_EN) != 0;
+		case AD5592_GPIO_READ_CONFIG:
+			return (word & AD5592_GPIO_READ_INPUT_BIT) != 0;
+	}
+	return 0;
+}
+
+/**
+ * Check if a transfer only writes, so nothing the host does next can
+ * depend on what it received.
+ */
+static int writesOnly(const AD5592_TraceRecord *record)
+{
+	const uint8_t *tx = traceTx(record);
+	AD5592_WORD word;
+	int i;
+
+	for(i = 0; i < record->frames; i++)
+	{
+		word = frameWord(tx, i);
+		if(word == AD5592_NOP || isReadback(word) ||
+			(word & (AD5592_DAC_WRITE_MASK | AD5592_CNTRL_ADDRESS_MASK)) == AD5592_ADC_READ)
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+ * shadow: drop writes the driver shadow registers say change nothing.
+ */
+static void saveShadow(Savings *savings, const AD5592_TraceRecord *record)
+{
+	const uint8_t *tx = traceTx(record);
+	AD5592_Device *dev;
+	int i;
+
+	if(record->cs >= AD5592_TRANSPORT_MAX_CS)
+	{
+		return;
+	}
+	dev = &savings->dev[record->cs];
+	for(i = 0; i < record->frames; i++)
+	{
+		if(!deviceUpdate(dev, frameWord(tx, i)))
+		{
+			savings->frames++;
+		}
+	}
+}
+
+/**
+ * pipeline: a transfer that ends with a NOP only to clock out a result
+ * could leave it to the first command of the next transfer to the same
+ * board, as AD5592_Pipe does.
+ */
+static void savePipeline(Savings *savings, const AD5592_TraceRecord *record)
+{
+	const AD5592_TraceRecord *last;
+
+	if(record->cs >= AD5592_TRANSPORT_MAX_CS || record->frames == 0)
+	{
+		return;
+	}
+	last = savings->last[record->cs];
+	if(last && last->frames > 1 &&
+		frameWord(traceTx(last), last->frames - 1) == AD5592_NOP &&
+		frameWord(traceTx(record), 0) != AD5592_NOP)
+	{
+		savings->frames++;
+	}
+	savings->last[record->cs] = record;
+}
+
+/**
+ * merge: a transfer that follows one to the same board that only wrote
+ * could have been queued in the same AD5592_Batch.
+ */
+static void saveMerge(Savings *savings, const AD5592_TraceRecord *record)
+{
+	const AD5592_TraceRecord *previous = savings->previous;
+
+	if(previous && previous->cs == record->cs && writesOnly(previous))
+	{
+		savings->transfers++;
+	}
+	savings->previous = record;
+}
+
+static const Strategy strategies[] =
+{
+	{ "shadow", "writes that change nothing", saveShadow },
+	{ "pipeline", "trailing NOPs the next command can replace", savePipeline },
+	{ "merge", "write only transfers joined to the next", saveMerge },
+};
+
+#define STRATEGY_COUNT	(int)(sizeof(strategies) / sizeof(strategies[0]))
+
+/**
+ * Compare a replayed frame with the recorded one.
+ * Parameters:
+ * 	recorded = frame in the trace
+ * 	replayed = frame received now
+ * 	readback = 1 if the frame before asked for register data
+ * 	tolerance = ADC counts allowed between results
+ * Returns:
+ * 	1 if they match
+ */
+static int framesMatch(AD5592_WORD recorded, AD5592_WORD replayed, int readback, int tolerance)
+{
+	int difference;
+
+	if(recorded == replayed)
+	{
+		return 1;
+	}
+	if(readback || (recorded & AD5592_DAC_WRITE_MASK) ||
+		(recorded & AD5592_ADC_ADDRESS_MASK) != (replayed & AD5592_ADC_ADDRESS_MASK) ||
+		(replayed & AD5592_DAC_WRITE_MASK))
+	{
+		return 0;
+	}
+	difference = (recorded & AD5592_ADC_VALUE_MASK) - (replayed & AD5592_ADC_VALUE_MASK);
+	return abs(difference) <= tolerance;
+}
+
+int main(int argc, char **argv)
+{
+	static AD5592_TraceView view;
+	static AD5592_Transport bus;
+	static AD5592_Sim sim;
+	static Savings savings[STRATEGY_COUNT];
+	const AD5592_TraceRecord *record;
+	const char *transport = "sim";
+	const char *usage = "Usage: AD5592Replay [-t sim|loopback|spidev|bcm2835|none]"
+		" [-a counts] [-v] trace\n";
+	AD5592_WORD previous[AD5592_TRANSPORT_MAX_CS] = {AD5592_NOP, AD5592_NOP};
+	AD5592_WORD recorded;
+	AD5592_WORD replayed;
+	char *txBuf = NULL;
+	char *rxBuf = NULL;
+	int tolerance = DEFAULT_TOLERANCE;
+	int verbose = 0;
+	int replay = 1;
+	uint64_t transfers = 0;
+	uint64_t frames = 0;
+	uint64_t busNs = 0;
+	uint64_t differences = 0;
+	uint64_t failed = 0;
+	double seconds = 0;
+	time_t start;
+	int option;
+	int i;
+	int s;
+
+	while((option = getopt(argc, argv, "t:a:v")) != -1)
+	{
+		switch(option)
+		{
+			case 't': transport = optarg; break;
+			case 'a': tolerance = atoi(optarg); break;
+			case 'v': verbose = 1; break;
+			default:
+				printf("%s", usage);
+				return 1;
+		}
+	}
+	if(optind >= argc)
+	{
+		printf("%s", usage);
+		return 1;
+	}
+	if(!traceMap(&view, argv[optind]))
+	{
+		printf("%s is not an AD5592 trace this host can read\n", argv[optind]);
+		return 1;
+	}
+
+	/* Set up the transport */
+	if(strcmp(transport, "sim") == 0)
+	{
+		simInit(&sim, 1);
+		simTransportInit(&bus, &sim);
+	}else if(strcmp(transport, "loopback") == 0)
+	{
+		loopbackTransportInit(&bus);
+	}else if(strcmp(transport, "spidev") == 0)
+	{
+		static AD5592_Spidev spidev;
+
+		if(!spidevTransportInit(&bus, &spidev, 0, AD5592_SPI_SPEED_HZ))
+		{
+			printf("Could not open /dev/spidev0.0\n");
+			return 1;
+		}
+	}else if(strcmp(transport, "bcm2835") == 0)
+	{
+#ifndef AD5592_NO_BCM2835
+		if(!bcm2835TransportInit(&bus))
+		{
+			printf("bcm2835 init failed. Are you running as root??\n");
+			return 1;
+		}
+#else
+		printf("Built without bcm2835\n");
+		return 1;
+#endif
+	}else if(strcmp(transport, "none") == 0)
+	{
+		replay = 0;
+	}else
+	{
+		printf("Unknown transport %s\n", transport);
+		return 1;
+	}
+	for(s = 0; s < STRATEGY_COUNT; s++)
+	{
+		for(i = 0; i < AD5592_TRANSPORT_MAX_CS; i++)
+		{
+			deviceInit(&savings[s].dev[i], NULL, i);
+		}
+	}
+
+	start = view.header->startSec;
+	printf("%.*s, recorded %s", AD5592_TRACE_TITLE, view.header->title, ctime(&start));
+	if(replay)
+	{
+		txBuf = malloc(2 * AD5592_TRACE_MAX_FRAMES);
+		rxBuf = malloc(2 * AD5592_TRACE_MAX_FRAMES);
+		if(txBuf == NULL || rxBuf == NULL)
+		{
+			printf("Out of memory\n");
+			return 1;
+		}
+	}
+
+	while((record = traceNext(&view)) != NULL)
+	{
+		for(s = 0; s < STRATEGY_COUNT; s++)
+		{
+			strategies[s].transfer(&savings[s], record);
+		}
+		transfers++;
+		frames += record->frames;
+		busNs += record->spanNs;
+		seconds = (record->timeNs + record->spanNs) / 1e9;
+		if(!replay || record->cs >= AD5592_TRANSPORT_MAX_CS)
+		{
+			continue;
+		}
+
+		memcpy(txBuf, traceTx(record), 2 * record->frames);
+		if(!transportTransfer(&bus, record->cs, txBuf, rxBuf, record->frames))
+		{
+			failed++;
+		}
+		for(i = 0; i < record->frames; i++)
+		{
+			recorded = frameWord(traceRx(record), i);
+			replayed = frameWord((const uint8_t *)rxBuf, i);
+			if(!framesMatch(recorded, replayed, isReadback(previous[record->cs]), tolerance))
+			{
+				if(verbose || differences < SHOWN_DIFFERENCES)
+				{
+					printf("%12.6f CS%d transfer %llu frame %d sent %04x recorded %04x replayed %04x\n",
+						record->timeNs / 1e9, record->cs, (unsigned long long)transfers - 1, i,
+						frameWord(traceTx(record), i), recorded, replayed);
+				}
+				differences++;
+			}
+			previous[record->cs] = frameWord(traceTx(record), i);
+		}
+	}
+	if(view.pos < view.size)
+	{
+		printf("%s: last record cut short\n", argv[optind]);
+	}
+
+	printf("\n%llu transfers, %llu frames in %.3f s, %.3f s on the bus\n",
+		(unsigned long long)transfers, (unsigned long long)frames, seconds, busNs / 1e9);
+	if(replay)
+	{
+		printf("Replayed on %s: %llu of %llu frames differ, %llu transfers failed\n", transport,
+			(unsigned long long)differences, (unsigned long long)frames,
+			(unsigned long long)failed);
+	}
+
+	printf("\n%-10s %12s %12s  %s\n", "strategy", "frames", "transfers", "saves");
+	for(s = 0; s < STRATEGY_COUNT; s++)
+	{
+		printf("%-10s %12llu %12llu  %s\n", strategies[s].name,
+			(unsigned long long)savings[s].frames, (unsigned long long)savings[s].transfers,
+			strategies[s].description);
+	}
+
+	transportClose(&bus);
+	traceUnmap(&view);
+	free(txBuf);
+	free(rxBuf);
+	return differences != 0;
+}
@@ -0,0 +1,641 @@
+/***********************************************************************
+ * File: AD5592Runner.c
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Runs a test plan on several units under test at once
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Batch.h v1.1.0
+ * 		-AD5592Plan.h v1.2.1
+ * 		-AD5592Timing.h v1.0.0
+ * 		-AD5592Log.h v1.0.0
+ * 		-AD5592Runner.h
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- Analog checks use planAnalogPass() so a UUT passes exactly
+ * 			when AD5592SnackATP would pass it.
+ **********************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "AD5592Batch.h"
+#include "AD5592Runner.h"
+
+#define LINE_LENGTH		256		/* Longest jig file line */
+#define ALL_WAVES		-1		/* Every UUT takes part */
+
+/**
+ * Parse a number token.
+ * Returns:
+ * 	1 on success, 0 if the token is missing or not a number
+ */
+static int runnerNumber(const char *token, long *value)
+{
+	char *end;
+
+	if(token == NULL)
+	{
+		return 0;
+	}
+	*value = strtol(token, &end, 0);
+	return *end == '\0';
+}
+
+/**
+ * Parse a bus and chip select and check no other board has them.
+ * Returns:
+ * 	1 on success, 0 on an error
+ */
+static int runnerPlace(AD5592_Runner *runner, int reference, uint8_t *bus, uint8_t *cs)
+{
+	long busNumber;
+	long csNumber;
+	int i;
+
+	if(!runnerNumber(strtok(NULL, " \t\r\n"), &busNumber) ||
+		!runnerNumber(strtok(NULL, " \t\r\n"), &csNumber) ||
+		busNumber < 0 || busNumber >= AD5592_RUNNER_BUSES ||
+		csNumber < 0 || csNumber >= AD5592_TRANSPORT_MAX_CS)
+	{
+		return 0;
+	}
+	if(!reference && runner->referenceBus == busNumber && runner->referenceCs == csNumber)
+	{
+		return 0;
+	}
+	for(i = 0; i < runner->uuts; i++)
+	{
+		if(runner->uut[i].bus == busNumber && runner->uut[i].cs == csNumber)
+		{
+			return 0;
+		}
+	}
+	*bus = busNumber;
+	*cs = csNumber;
+	return 1;
+}
+
+/**
+ * Put each UUT in the first wave it shares no pins with.
+ */
+static void runnerWaves(AD5592_Runner *runner)
+{
+	uint8_t used[AD5592_RUNNER_UUTS] = {0};
+	AD5592_RunnerUut *uut;
+	int i;
+	int wave;
+
+	runner->waves = 0;
+	runner->pins = 0x00;
+	for(i = 0; i < runner->uuts; i++)
+	{
+		uut = &runner->uut[i];
+		for(wave = 0; used[wave] & uut->pins; wave++);
+		used[wave] |= uut->pins;
+		uut->wave = wave;
+		runner->pins |= uut->pins;
+		if(wave + 1 > runner->waves)
+		{
+			runner->waves = wave + 1;
+		}
+	}
+}
+
+/**
+ * Read a jig file.
+ * Parameters:
+ * 	runner = runner to fill in
+ * 	file = open jig file
+ * Returns:
+ * 	1 on success, 0 on an error with runner->errorLine set
+ */
+int runnerLoad(AD5592_Runner *runner, FILE *file)
+{
+	char line[LINE_LENGTH];
+	AD5592_RunnerUut *uut;
+	int haveReference = 0;
+	int number = 0;
+	int ok;
+	char *keyword;
+	char *name;
+	char *comment;
+	long value;
+
+	memset(runner, 0, sizeof(*runner));
+	while(fgets(line, sizeof(line), file) != NULL)
+	{
+		number++;
+		comment = strchr(line, '#');
+		if(comment)
+		{
+			*comment = '\0';
+		}
+		keyword = strtok(line, " \t\r\n");
+		if(keyword == NULL)
+		{
+			continue;
+		}
+
+		if(strcmp(keyword, "reference") == 0)
+		{
+			/* The reference comes first so the UUTs can be checked against it */
+			ok = !haveReference && runner->uuts == 0 &&
+				runnerPlace(runner, 1, &runner->referenceBus, &runner->referenceCs);
+			haveReference = ok;
+		}else if(strcmp(keyword, "uut") == 0 && haveReference && runner->uuts < AD5592_RUNNER_UUTS)
+		{
+			uut = &runner->uut[runner->uuts];
+			name = strtok(NULL, " \t\r\n");
+			ok = name != NULL && runnerPlace(runner, 0, &uut->bus, &uut->cs) &&
+				runnerNumber(strtok(NULL, " \t\r\n"), &value) && value > 0 && value <= 0xFF;
+			if(ok)
+			{
+				strncpy(uut->name, name, AD5592_LOG_NAME - 1);
+				uut->name[AD5592_LOG_NAME - 1] = '\0';
+				uut->pins = value;
+				runner->uuts++;
+			}
+		}else
+		{
+			ok = 0;
+		}
+
+		if(!ok)
+		{
+			runner->errorLine = number;
+			return 0;
+		}
+	}
+	if(runner->uuts == 0)
+	{
+		runner->errorLine = number;
+		return 0;
+	}
+	runnerWaves(runner);
+	return 1;
+}
+
+/**
+ * Put the boards on their buses.
+ * Parameters:
+ * 	runner = runner
+ * 	bus[] = transport of each bus number, NULL for buses not on the jig
+ * Returns:
+ * 	1 on success, 0 if a board is on a bus with no transport
+ */
+int runnerAttach(AD5592_Runner *runner, AD5592_Transport *bus[])
+{
+	AD5592_RunnerUut *uut;
+	int i;
+
+	if(bus[runner->referenceBus] == NULL)
+	{
+		return 0;
+	}
+	deviceInit(&runner->reference, bus[runner->referenceBus], runner->referenceCs);
+	for(i = 0; i < runner->uuts; i++)
+	{
+		uut = &runner->uut[i];
+		if(bus[uut->bus] == NULL)
+		{
+			return 0;
+		}
+		deviceInit(&uut->dev, bus[uut->bus], uut->cs);
+	}
+	return 1;
+}
+
+/**
+ * Wait until the pins have settled.
+ */
+static void runnerWaitReady(AD5592_Runner *runner)
+{
+	uint64_t now = clockNowNs();
+
+	if(runner->readyNs > now)
+	{
+		timingWaitUs((runner->readyNs - now + 999) / 1000);
+		runner->settleNs += runner->readyNs - now;
+	}
+}
+
+/**
+ * Change the mode of pins of a board and note when.
+ */
+static void runnerMode(AD5592_Runner *runner, AD5592_Device *dev, uint8_t pins, uint8_t mode,
+	uint32_t settleUs)
+{
+	uint64_t ready;
+
+	if(pins && deviceSetPinMode(dev, pins, mode) > 0)
+	{
+		runner->changedNs = clockNowNs();
+		ready = runner->changedNs + settleUs * 1000ull;
+		if(ready > runner->readyNs)
+		{
+			runner->readyNs = ready;
+		}
+	}
+}
+
+/**
+ * Drive pins of a board with the values of a drive operation as one
+ * transfer.
+ */
+static void runnerDrive(AD5592_Runner *runner, AD5592_Device *dev, const AD5592_PlanOp *op,
+	uint8_t pins)
+{
+	AD5592_Batch batch;
+	uint16_t milivolts[8];
+	uint8_t states = 0x00;
+	int pin;
+
+	if(pins == 0)
+	{
+		return;
+	}
+	batchInit(&batch, dev);
+	if(op->kind == AD5592_PLAN_ANALOG)
+	{
+		for(pin = 0; pin < 8; pin++)
+		{
+			milivolts[pin] = op->value[pin];
+		}
+		batchSetAnalogOutAll(&batch, pins, milivolts);
+	}else
+	{
+		for(pin = 0; pin < 8; pin++)
+		{
+			states |= ((pins >> pin) & 0x1) ? op->value[pin] << pin : 0;
+		}
+		batchWrite(&batch, AD5592_GPIO_WRITE_DATA | states);
+	}
+	batchSend(&batch);
+	runner->changedNs = clockNowNs();
+}
+
+/**
+ * Measure pins of a board.
+ * Parameters:
+ * 	values[] = 8 entry array for counts or pin states by pin
+ */
+static void runnerMeasure(const AD5592_Plan *plan, AD5592_Device *dev, const AD5592_PlanOp *op,
+	uint8_t pins, uint16_t values[], AD5592_SettleStats *stats)
+{
+	AD5592_Batch batch;
+	uint8_t states;
+	int first;
+	int pin;
+
+	batchInit(&batch, dev);
+	if(op->kind == AD5592_PLAN_DIGITAL)
+	{
+		first = batchGetDigitalIn(&batch, pins);
+		if(first < 0 || !batchSend(&batch))
+		{
+			for(pin = 0; pin < 8; pin++)
+			{
+				values[pin] = AD5592_BATCH_NO_RESULT;
+			}
+			return;
+		}
+		states = batchDigitalResult(&batch, first);
+		for(pin = 0; pin < 8; pin++)
+		{
+			values[pin] = (states >> pin) & 0x1;
+		}
+	}else if(plan->stableCounts)
+	{
+		timingSettleAdc(dev, pins, values, plan->stableCounts, plan->stableTimeoutUs, stats);
+	}else
+	{
+		batchScanAdc(dev, pins, values);
+	}
+}
+
+/**
+ * Check and report the pins of one UUT in a measurement.
+ */
+static void runnerCheck(AD5592_Runner *runner, const AD5592_Plan *plan, const AD5592_PlanOp *op,
+	int index, uint8_t pins, const uint16_t values[], AD5592_Log *log)
+{
+	AD5592_RunnerUut *uut = &runner->uut[index];
+	const AD5592_PlanStep *step;
+	uint8_t reported = 0x00;
+	uint8_t mask;
+	uint8_t expected;
+	uint8_t states;
+	uint8_t pass;
+	int missing;
+	int pin;
+	int i;
+
+	for(pin = 0; pin < 8; pin++)
+	{
+		if(!((pins >> pin) & 0x1) || ((reported >> pin) & 0x1))
+		{
+			continue;
+		}
+		step = &plan->step[op->step[pin]];
+		if(op->kind == AD5592_PLAN_ANALOG)
+		{
+			pass = planAnalogPass(op->value[pin], values[pin], step->tolerance);
+			printf("\n%s %s test on IO%d target = %d...Result = %d...%s", uut->name, step->name,
+				pin, op->value[pin], values[pin], pass ? "PASS" : "FAIL");
+			if(log)
+			{
+				logResult(log, index, AD5592_LOG_ANALOG, pin, step->name, op->value[pin],
+					values[pin], pass);
+			}
+		}else
+		{
+			/* Digital results are reported per step */
+			mask = pins & step->pins;
+			expected = 0x00;
+			states = 0x00;
+			missing = 0;
+			for(i = 0; i < 8; i++)
+			{
+				if((mask >> i) & 0x1)
+				{
+					expected |= op->value[i] << i;
+					states |= (values[i] & 0x1) << i;
+					missing |= values[i] == AD5592_BATCH_NO_RESULT;
+				}
+			}
+			reported |= mask;
+			pass = states == expected && !missing;
+			printf("\n%s %s test: %s ... Target = %x Value = %x", uut->name, step->name,
+				pass ? "PASS" : "FAIL", expected, states);
+			if(log)
+			{
+				logResult(log, index, AD5592_LOG_DIGITAL, mask, step->name, expected, states, pass);
+			}
+		}
+		uut->checks++;
+		uut->failed += !pass;
+	}
+}
+
+/**
+ * Find the end of the group of operations that starts at an operation:
+ * its mode changes, then its rounds.
+ * Parameters:
+ * 	driver = set to the board of the first drive, -1 if there is none
+ * 	drivePins = set to every pin driven in the group
+ * Returns:
+ * 	Index of the first operation after the group
+ */
+static int runnerGroup(const AD5592_Schedule *schedule, int start, int *driver, uint8_t *drivePins)
+{
+	const AD5592_PlanOp *op;
+	int i = start;
+
+	*driver = -1;
+	*drivePins = 0x00;
+	while(i < schedule->ops && (schedule->op[i].op == AD5592_PLAN_OP_MODE ||
+		schedule->op[i].op == AD5592_PLAN_OP_SETTLE))
+	{
+		i++;
+	}
+	for(; i < schedule->ops && schedule->op[i].op != AD5592_PLAN_OP_MODE; i++)
+	{
+		op = &schedule->op[i];
+		if(op->op == AD5592_PLAN_OP_DRIVE)
+		{
+			if(*driver < 0)
+			{
+				*driver = op->board;
+			}
+			*drivePins |= op->pins;
+		}
+	}
+	return i;
+}
+
+/**
+ * Run a group of operations on the reference and the UUTs of a wave.
+ * Parameters:
+ * 	wave = wave, or ALL_WAVES for every UUT
+ * 	drivePins = pins the UUTs drive in the group, for a wave
+ */
+static void runnerRunGroup(AD5592_Runner *runner, const AD5592_Plan *plan,
+	const AD5592_Schedule *schedule, int start, int end, int wave, uint8_t drivePins,
+	AD5592_Log *log, AD5592_SettleStats *stats)
+{
+	const AD5592_PlanOp *op;
+	AD5592_RunnerUut *uut;
+	AD5592_Device *dev;
+	uint16_t values[8];
+	uint8_t mask = 0x00;
+	uint8_t mode = 0;
+	int taken = 0;
+	int i;
+	int u;
+
+	for(u = 0; u < runner->uuts; u++)
+	{
+		if(wave == ALL_WAVES || runner->uut[u].wave == wave)
+		{
+			mask |= runner->uut[u].pins;
+		}
+	}
+
+	for(i = start; i < end; i++)
+	{
+		op = &schedule->op[i];
+		switch(op->op)
+		{
+			case AD5592_PLAN_OP_MODE:
+				if(op->board == CHANNEL0)
+				{
+					runnerMode(runner, &runner->reference, op->pins & runner->pins, op->mode, 0);
+					break;
+				}
+				for(u = 0; u < runner->uuts; u++)
+				{
+					uut = &runner->uut[u];
+					if(wave == ALL_WAVES || uut->wave == wave)
+					{
+						runnerMode(runner, &uut->dev, op->pins & uut->pins, op->mode, 0);
+					}
+				}
+				break;
+			case AD5592_PLAN_OP_SETTLE:
+				if(runner->changedNs + op->us * 1000ull > runner->readyNs)
+				{
+					runner->readyNs = runner->changedNs + op->us * 1000ull;
+				}
+				break;
+			case AD5592_PLAN_OP_DRIVE:
+				if(wave != ALL_WAVES && !taken)
+				{
+					/* An earlier wave may have left these pins in three-state.
+					 * The reference has let go of them by now. */
+					mode = op->kind == AD5592_PLAN_ANALOG ? AD5592_MODE_DAC : AD5592_MODE_GPIO_OUT;
+					for(u = 0; u < runner->uuts; u++)
+					{
+						uut = &runner->uut[u];
+						if(uut->wave == wave)
+						{
+							runnerMode(runner, &uut->dev, drivePins & uut->pins, mode,
+								plan->settleModeUs);
+						}
+					}
+					taken = 1;
+				}
+				runnerWaitReady(runner);
+				if(op->board == CHANNEL0)
+				{
+					runnerDrive(runner, &runner->reference, op, op->pins & mask);
+					break;
+				}
+				/* Each UUT settles while the next is written */
+				for(u = 0; u < runner->uuts; u++)
+				{
+					uut = &runner->uut[u];
+					if(wave == ALL_WAVES || uut->wave == wave)
+					{
+						runnerDrive(runner, &uut->dev, op, op->pins & uut->pins);
+					}
+				}
+				break;
+			case AD5592_PLAN_OP_MEASURE:
+				runnerWaitReady(runner);
+				runner->rounds++;
+				if(op->board == CHANNEL0)
+				{
+					/* One scan of the reference covers every UUT of the wave */
+					if(op->pins & mask)
+					{
+						runnerMeasure(plan, &runner->reference, op, op->pins & mask, values, stats);
+					}
+					for(u = 0; u < runner->uuts; u++)
+					{
+						uut = &runner->uut[u];
+						if(wave == ALL_WAVES || uut->wave == wave)
+						{
+							runnerCheck(runner, plan, op, u, op->pins & uut->pins, values, log);
+						}
+					}
+					break;
+				}
+				for(u = 0; u < runner->uuts; u++)
+				{
+					uut = &runner->uut[u];
+					dev = &uut->dev;
+					if((wave == ALL_WAVES || uut->wave == wave) && (op->pins & uut->pins))
+					{
+						runnerMeasure(plan, dev, op, op->pins & uut->pins, values, stats);
+						runnerCheck(runner, plan, op, u, op->pins & uut->pins, values, log);
+					}
+				}
+				break;
+		}
+	}
+
+	/* Let go of the pins before the next wave takes them */
+	if(wave != ALL_WAVES && runner->waves > 1)
+	{
+		for(u = 0; u < runner->uuts; u++)
+		{
+			uut = &runner->uut[u];
+			if(uut->wave == wave)
+			{
+				runnerMode(runner, &uut->dev, drivePins & uut->pins, AD5592_MODE_THREE_STATE,
+					plan->settleModeUs);
+			}
+		}
+	}
+}
+
+/**
+ * Reset every board on the jig.
+ */
+static void runnerReset(AD5592_Runner *runner)
+{
+	int u;
+
+	deviceReset(&runner->reference);
+	for(u = 0; u < runner->uuts; u++)
+	{
+		deviceReset(&runner->uut[u].dev);
+	}
+	timingWaitUs(AD5592_SETTLE_RESET_US);
+}
+
+/**
+ * Reset every board, run a schedule on every UUT and reset them again.
+ * Parameters:
+ * 	runner = runner
+ * 	plan = plan the schedule was compiled from
+ * 	schedule = schedule
+ * 	log = log to record every check in as well as printing it, may be NULL
+ * 	stats = settling record for settle stable, may be NULL
+ * Returns:
+ * 	Number of UUTs with a failed check
+ */
+int runnerRun(AD5592_Runner *runner, const AD5592_Plan *plan, const AD5592_Schedule *schedule,
+	AD5592_Log *log, AD5592_SettleStats *stats)
+{
+	AD5592_RunnerUut *uut;
+	char line[128];
+	uint8_t drivePins;
+	int failed = 0;
+	int driver;
+	int start;
+	int end;
+	int wave;
+	int u;
+
+	for(u = 0; u < runner->uuts; u++)
+	{
+		uut = &runner->uut[u];
+		uut->checks = 0;
+		uut->failed = 0;
+		if(log)
+		{
+			snprintf(line, sizeof(line), "UUT %d: %s on bus %d CS%d, pins 0x%02X, wave %d\n", u,
+				uut->name, uut->bus, uut->cs, uut->pins, uut->wave);
+			logText(log, line);
+		}
+	}
+	runner->changedNs = 0;
+	runner->readyNs = 0;
+	runner->rounds = 0;
+	runner->settleNs = 0;
+
+	runnerReset(runner);
+	for(start = 0; start < schedule->ops; start = end)
+	{
+		end = runnerGroup(schedule, start, &driver, &drivePins);
+		if(driver == CHANNEL1)
+		{
+			for(wave = 0; wave < runner->waves; wave++)
+			{
+				runnerRunGroup(runner, plan, schedule, start, end, wave, drivePins, log, stats);
+			}
+		}else
+		{
+			runnerRunGroup(runner, plan, schedule, start, end, ALL_WAVES, 0x00, log, stats);
+		}
+	}
+	runnerReset(runner);
+
+	for(u = 0; u < runner->uuts; u++)
+	{
+		uut = &runner->uut[u];
+		failed += uut->failed > 0;
+		if(log)
+		{
+			snprintf(line, sizeof(line), "UUT %d: %s %s, %d of %d checks failed\n", u, uut->name,
+				uut->failed ? "FAIL" : "PASS", uut->failed, uut->checks);
+			logText(log, line);
+		}
+	}
+	return failed;
+}
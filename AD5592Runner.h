@@ -0,0 +1,132 @@
+/*********************************************************************
+ * File: AD5592Runner.h
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Runs a test plan on several units under test at once
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Batch.h v1.1.0
+ * 		-AD5592Plan.h v1.2.1
+ * 		-AD5592Timing.h v1.0.0
+ * 		-AD5592Log.h v1.0.0
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- Analog checks use planAnalogPass() so a UUT passes exactly
+ * 			when AD5592SnackATP would pass it.
+ *
+ * A jig has one reference board and up to AD5592_RUNNER_UUTS units
+ * under test, each on a bus and chip select of its own. Pin n of every
+ * UUT is wired to pin n of the reference for the pins listed for it, so
+ * the reference is shared by every UUT on a pin.
+ *
+ * Jig file format, one statement per line, # starts a comment:
+ * 	reference <bus> <cs>
+ * 		The reference board. The plan calls it "test".
+ * 	uut <name> <bus> <cs> <pins>
+ * 		A unit under test, called "uut" in the plan. pins is the bit
+ * 		mask of its pins wired to the reference, for example 0xFF.
+ * A bus is the X of /dev/spidevX.Y and cs is the Y.
+ *
+ * The plan is compiled once as for AD5592SnackATP and runnerRun() runs
+ * its schedule on every UUT together:
+ * 	- Where the reference drives, it drives every UUT on the pin at
+ * 		once and every UUT is measured in the same round.
+ * 	- Where the UUTs drive, UUTs that share no pins take the round
+ * 		together. The reference measures them all with one scan. UUTs
+ * 		that share pins are put in waves and take turns, with the
+ * 		pins of the wave before put in three-state first so two boards
+ * 		never drive a pin.
+ * 	- Settling runs from the last board that changed. The boards
+ * 		written before it settle while it is written, so a round costs
+ * 		one settle however many UUTs take part.
+ *
+ * Results go to one log for the whole batch. Each result record has
+ * the UUT number in board, and text records name every UUT and give
+ * its verdict.
+ **********************************************************************/
+
+#ifndef SOURCES_AD5592RUNNER_H_
+#define SOURCES_AD5592RUNNER_H_
+
+#include <stdio.h>
+#include "AD5592RPI.h"
+#include "AD5592Plan.h"
+#include "AD5592Timing.h"
+#include "AD5592Log.h"
+
+#define AD5592_RUNNER_UUTS		8		/* Most units under test on a jig */
+#define AD5592_RUNNER_BUSES		8		/* Bus numbers 0 to 7 */
+
+/**
+ * One unit under test.
+ */
+typedef struct
+{
+	char name[AD5592_LOG_NAME];		/* Name used in the report */
+	uint8_t bus;					/* Bus number */
+	uint8_t cs;						/* Chip select */
+	uint8_t pins;					/* Pins wired to the reference */
+	uint8_t wave;					/* Turn when UUTs drive shared pins */
+	AD5592_Device dev;				/* Board */
+	int checks;						/* Checks run */
+	int failed;						/* Checks failed */
+} AD5592_RunnerUut;
+
+/**
+ * A jig and the state of a batch.
+ */
+typedef struct
+{
+	uint8_t referenceBus;						/* Bus of the reference */
+	uint8_t referenceCs;						/* Chip select of the reference */
+	AD5592_Device reference;					/* Reference board */
+	int uuts;									/* Units under test */
+	AD5592_RunnerUut uut[AD5592_RUNNER_UUTS];	/* Units under test in file order */
+	uint8_t pins;								/* Pins wired to any UUT */
+	int waves;									/* Turns when UUTs drive */
+	int errorLine;								/* Line of the first error, 0 if none */
+	uint64_t changedNs;							/* Last pin change on any board */
+	uint64_t readyNs;							/* When the pins have settled */
+	int rounds;									/* Drive and measure rounds run */
+	uint64_t settleNs;							/* Time spent waiting to settle */
+} AD5592_Runner;
+
+/**
+ * Read a jig file.
+ * Parameters:
+ * 	runner = runner to fill in
+ * 	file = open jig file
+ * Returns:
+ * 	1 on success, 0 on an error with runner->errorLine set
+ */
+int runnerLoad(AD5592_Runner *runner, FILE *file);
+
+/**
+ * Put the boards on their buses.
+ * Parameters:
+ * 	runner = runner
+ * 	bus[] = transport of each bus number, NULL for buses not on the jig
+ * Returns:
+ * 	1 on success, 0 if a board is on a bus with no transport
+ */
+int runnerAttach(AD5592_Runner *runner, AD5592_Transport *bus[]);
+
+/**
+ * Reset every board, run a schedule on every UUT and reset them again.
+ * Parameters:
+ * 	runner = runner
+ * 	plan = plan the schedule was compiled from
+ * 	schedule = schedule
+ * 	log = log to record every check in as well as printing it, may be NULL
+ * 	stats = settling record for settle stable, may be NULL
+ * Returns:
+ * 	Number of UUTs with a failed check
+ */
+int runnerRun(AD5592_Runner *runner, const AD5592_Plan *plan, const AD5592_Schedule *schedule,
+	AD5592_Log *log, AD5592_SettleStats *stats);
+
+#endif /* SOURCES_AD5592RUNNER_H_ */
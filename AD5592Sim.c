@@ -0,0 +1,451 @@
+/***********************************************************************
+ * File: AD5592Sim.c
+ * Target: Any Linux host
+ * Function: Software model of the AD5592 behind an AD5592_Transport
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Sim.h
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- Conversions sample before the command in the same frame takes
+ * 			effect, so a DAC write sharing a frame with a conversion is
+ * 			not seen by it.
+ * 	* Version 1.1.0: 16 October 2026
+ * 		- Boards are wired through nets set with simWire().
+ * 	* Version 1.2.0: 16 October 2026
+ * 		- Each bus has a transport of its own. The transport context is
+ * 			the AD5592_SimPort of the bus.
+ * 		- Reading a net that two boards drive counts in contention.
+ * 	* Version 1.2.1: 16 October 2026
+ * 		- A GPIO input read sets the read configuration to its pins.
+ **********************************************************************/
+
+#include <string.h>
+#include "AD5592Sim.h"
+
+/**
+ * Put a board in its reset state. Applied voltages and counters are
+ * kept.
+ */
+static void simReset(AD5592_SimBoard *board)
+{
+	memset(board->reg, 0, sizeof(board->reg));
+	memset(board->dacInput, 0, sizeof(board->dacInput));
+	memset(board->dacOutput, 0, sizeof(board->dacOutput));
+	board->out = AD5592_NOP;
+	board->seqRunning = 0;
+	board->seqPos = 0;
+}
+
+/**
+ * Voltage a board drives onto one of its pins.
+ * Returns:
+ * 	millivolts or -1 if the pin is not driven
+ */
+static int simDrive(AD5592_SimBoard *board, uint8_t pin)
+{
+	uint8_t bit = 0x1 << pin;
+	uint32_t fullScale = AD5592_SIM_VREF_MV;
+
+	if(board->reg[AD5592_REG_INDEX(AD5592_THREE_STATE_CONFIG)] & bit)
+	{
+		return -1;
+	}
+	if(board->reg[AD5592_REG_INDEX(AD5592_DAC_PIN_SELECT)] & bit)
+	{
+		if(board->reg[AD5592_REG_INDEX(AD5592_POWER_DWN_REF_CNTRL)] & bit)
+		{
+			return -1;
+		}
+		if(board->reg[AD5592_REG_INDEX(AD5592_GP_CNTRL)] & AD5592_GP_DAC_RANGE)
+		{
+			fullScale *= 2;
+		}
+		return (board->dacOutput[pin] * fullScale + 2048) >> 12;
+	}
+	if(board->reg[AD5592_REG_INDEX(AD5592_GPIO_WRITE_CONFIG)] & bit)
+	{
+		if(!(board->reg[AD5592_REG_INDEX(AD5592_GPIO_WRITE_DATA)] & bit))
+		{
+			return 0;
+		}
+		if(board->reg[AD5592_REG_INDEX(AD5592_GPIO_DRAIN_CONFIG)] & bit)
+		{
+			return -1;
+		}
+		return AD5592_SIM_VDD_MV;
+	}
+	return -1;
+}
+
+/**
+ * Get the voltage on a pin.
+ * Parameters:
+ * 	sim = simulator
+ * 	cs = board number
+ * 	pin = pin number (0 to 7)
+ * Returns:
+ * 	millivolts
+ */
+uint16_t simPinVoltage(AD5592_Sim *sim, uint8_t cs, uint8_t pin)
+{
+	AD5592_SimBoard *board = &sim->board[cs];
+	uint8_t bit = 0x1 << pin;
+	int mv = simDrive(board, pin);
+	int pulled = board->reg[AD5592_REG_INDEX(AD5592_PULL_DOWN_SET)] & bit;
+	int drive;
+	int i;
+
+	if(sim->wired[cs] & bit)
+	{
+		for(i = 0; i < AD5592_SIM_BOARDS; i++)
+		{
+			if(i == cs || !(sim->wired[i] & bit))
+			{
+				continue;
+			}
+			drive = simDrive(&sim->board[i], pin);
+			if(drive >= 0)
+			{
+				if(mv >= 0)
+				{
+					sim->contention++;	/* Two boards drive the net */
+				}else
+				{
+					mv = drive;
+				}
+			}
+			pulled |= sim->board[i].reg[AD5592_REG_INDEX(AD5592_PULL_DOWN_SET)] & bit;
+		}
+	}
+	if(mv >= 0)
+	{
+		return mv;
+	}
+	if(pulled)
+	{
+		return 0;
+	}
+	return board->external[pin];
+}
+
+/**
+ * Run the next conversion of the ADC sequence.
+ * Returns:
+ * 	Result word, or AD5592_NOP if the sequence has finished
+ */
+static AD5592_WORD simConvert(AD5592_Sim *sim, uint8_t cs)
+{
+	AD5592_SimBoard *board = &sim->board[cs];
+	AD5592_WORD sequence = board->reg[AD5592_REG_INDEX(AD5592_ADC_READ)];
+	uint16_t entries = (sequence & AD5592_PIN_SELECT_MASK) |
+		((sequence & AD5592_ADC_SEQ_TEMP) ? 0x100 : 0x000);
+	uint32_t fullScale = AD5592_SIM_VREF_MV;
+	int32_t count;
+	int i;
+
+	for(i = board->seqPos; i < 9 && !((entries >> i) & 0x1); i++);
+	if(i == 9 && (sequence & AD5592_ADC_SEQ_REP))
+	{
+		for(i = 0; i < 9 && !((entries >> i) & 0x1); i++);
+	}
+	if(i == 9)
+	{
+		board->seqRunning = 0;
+		return AD5592_NOP;
+	}
+	board->seqPos = i + 1;
+
+	if(i == 8)
+	{
+		return AD5592_SIM_TEMP_ADDRESS | AD5592_SIM_TEMP_COUNT;
+	}
+	if(board->reg[AD5592_REG_INDEX(AD5592_GP_CNTRL)] & AD5592_GP_ADC_RANGE)
+	{
+		fullScale *= 2;
+	}
+	count = (simPinVoltage(sim, cs, i) * 4096 + fullScale / 2) / fullScale;
+	if(sim->noise)
+	{
+		sim->seed = sim->seed * 1103515245 + 12345;
+		count += (int32_t)((sim->seed >> 16) % (2 * sim->noise + 1)) - sim->noise;
+	}
+	if(count < 0)
+	{
+		count = 0;
+	}
+	if(count > AD5592_ADC_VALUE_MASK)
+	{
+		count = AD5592_ADC_VALUE_MASK;
+	}
+	return ((i << 12) & AD5592_ADC_ADDRESS_MASK) | count;
+}
+
+/**
+ * Check for a command that puts read data in the next frame.
+ * Returns:
+ * 	non zero for GPIO input reads and readback commands
+ */
+static int simIsRead(AD5592_WORD command)
+{
+	if(command & AD5592_DAC_WRITE_MASK)
+	{
+		return 0;
+	}
+	switch(AD5592_REG_INDEX(command))
+	{
+		case AD5592_REG_INDEX(AD5592_DAC_READBACK):
+			return (command & AD5592_DAC_READBACK_EN) == AD5592_DAC_READBACK_EN;
+		case AD5592_REG_INDEX(AD5592_CNTRL_REG_READBACK):
+			return (command & AD5592_REG_READBACK_EN) != 0;
+		case AD5592_REG_INDEX(AD5592_GPIO_READ_CONFIG):
+			return (command & AD5592_GPIO_READ_INPUT_BIT) != 0;
+	}
+	return 0;
+}
+
+/**
+ * Run one frame on a board. A conversion samples at the start of the
+ * frame, before the command in the same frame takes effect.
+ * Returns:
+ * 	Word clocked out during the frame
+ */
+static AD5592_WORD simFrame(AD5592_Sim *sim, uint8_t cs, AD5592_WORD command)
+{
+	AD5592_SimBoard *board = &sim->board[cs];
+	AD5592_WORD rx = board->out;
+	AD5592_WORD next = AD5592_NOP;
+	int reg = AD5592_REG_INDEX(command);
+	uint8_t pin;
+	uint8_t levels = 0x00;
+
+	board->count.frames++;
+	board->count.bytes += 2;
+
+	if(board->seqRunning && !simIsRead(command) && command != AD5592_SW_RESET &&
+		((command & AD5592_DAC_WRITE_MASK) || reg != AD5592_REG_INDEX(AD5592_ADC_READ)))
+	{
+		next = simConvert(sim, cs);
+	}
+
+	if(command & AD5592_DAC_WRITE_MASK)
+	{
+		board->count.dacWrites++;
+		pin = (command & AD5592_DAC_ADDRESS_MASK) >> 12;
+		board->dacInput[pin] = command & AD5592_DAC_VALUE_MASK;
+		if((board->reg[AD5592_REG_INDEX(AD5592_CNTRL_REG_READBACK)] & AD5592_LDAC_MODE_MASK) != 0x1)
+		{
+			board->dacOutput[pin] = board->dacInput[pin];
+		}
+	}else
+	{
+		board->count.commands[reg]++;
+		switch(reg)
+		{
+			case AD5592_REG_INDEX(AD5592_NOP):
+				break;
+			case AD5592_REG_INDEX(AD5592_DAC_READBACK):
+				if((command & AD5592_DAC_READBACK_EN) == AD5592_DAC_READBACK_EN)
+				{
+					pin = command & 0x7;
+					next = AD5592_DAC_WRITE_MASK | (pin << 12) | board->dacInput[pin];
+				}
+				break;
+			case AD5592_REG_INDEX(AD5592_ADC_READ):
+				/* Conversions start with the next frame */
+				board->reg[reg] = command & AD5592_REG_VALUE_MASK;
+				board->seqRunning = (command & 0x01FF) != 0;
+				board->seqPos = 0;
+				board->out = AD5592_NOP;
+				return rx;
+			case AD5592_REG_INDEX(AD5592_CNTRL_REG_READBACK):
+				board->reg[reg] = command & AD5592_LDAC_MODE_MASK;
+				if((command & AD5592_LDAC_MODE_MASK) == 0x2)
+				{
+					memcpy(board->dacOutput, board->dacInput, sizeof(board->dacOutput));
+				}
+				if(command & AD5592_REG_READBACK_EN)
+				{
+					next = board->reg[(command >> 2) & 0xF];
+				}
+				break;
+			case AD5592_REG_INDEX(AD5592_GPIO_READ_CONFIG):
+				/* The pins of a read become the read configuration too */
+				board->reg[reg] = command & AD5592_PIN_SELECT_MASK;
+				if(command & AD5592_GPIO_READ_INPUT_BIT)
+				{
+					for(pin = 0; pin < 8; pin++)
+					{
+						if(simPinVoltage(sim, cs, pin) >= AD5592_SIM_VDD_MV / 2)
+						{
+							levels |= 0x1 << pin;
+						}
+					}
+					next = levels & board->reg[reg];
+				}
+				break;
+			case AD5592_REG_INDEX(AD5592_SW_RESET):
+				if(command == AD5592_SW_RESET)
+				{
+					simReset(board);
+				}
+				return rx;
+			default:
+				board->reg[reg] = command & AD5592_REG_VALUE_MASK;
+				break;
+		}
+	}
+
+	board->out = next;
+	return rx;
+}
+
+/**
+ * Simulator transfer.
+ */
+static int simTransfer(AD5592_Transport *bus, uint8_t cs, const char txBuf[],
+	char rxBuf[], int frames)
+{
+	AD5592_SimPort *port = bus->context;
+	AD5592_Sim *sim = port->sim;
+	AD5592_WORD word;
+	int i;
+
+	if(cs >= AD5592_TRANSPORT_MAX_CS)
+	{
+		return 0;
+	}
+	cs += port->first;
+	sim->board[cs].count.transfers++;
+	for(i = 0; i < frames; i++)
+	{
+		word = ((uint8_t)txBuf[2 * i] << 8) | (uint8_t)txBuf[2 * i + 1];
+		word = simFrame(sim, cs, word);
+		rxBuf[2 * i] = (word & 0xFF00) >> 8;
+		rxBuf[2 * i + 1] = word & 0xFF;
+	}
+	return 1;
+}
+
+/**
+ * Set up a simulated bus with every board in its reset state.
+ * Parameters:
+ * 	sim = simulator
+ * 	crossWired = non zero to wire pin n of board 0 to pin n of board 1
+ */
+void simInit(AD5592_Sim *sim, uint8_t crossWired)
+{
+	int i;
+
+	memset(sim, 0, sizeof(*sim));
+	for(i = 0; i < AD5592_SIM_BOARDS; i++)
+	{
+		simReset(&sim->board[i]);
+	}
+	for(i = 0; i < AD5592_SIM_BUSES; i++)
+	{
+		sim->port[i].sim = sim;
+		sim->port[i].first = AD5592_SIM_BOARD(i, 0);
+	}
+	if(crossWired)
+	{
+		sim->wired[0] = 0xFF;
+		sim->wired[1] = 0xFF;
+	}
+	sim->seed = 1;
+}
+
+/**
+ * Join pins of a board to the nets.
+ * Parameters:
+ * 	sim = simulator
+ * 	cs = board number
+ * 	pins = pins to join as bit mask, 0 to take the board off the nets
+ */
+void simWire(AD5592_Sim *sim, uint8_t cs, uint8_t pins)
+{
+	sim->wired[cs] = pins;
+}
+
+/**
+ * Set up a transport that talks to bus 0 of the simulator.
+ * Parameters:
+ * 	bus = transport to set up
+ * 	sim = simulator
+ */
+void simTransportInit(AD5592_Transport *bus, AD5592_Sim *sim)
+{
+	simBusTransportInit(bus, sim, 0);
+}
+
+/**
+ * Set up a transport that talks to one bus of the simulator.
+ * Parameters:
+ * 	bus = transport to set up
+ * 	sim = simulator
+ * 	number = bus, 0 to AD5592_SIM_BUSES - 1
+ */
+void simBusTransportInit(AD5592_Transport *bus, AD5592_Sim *sim, uint8_t number)
+{
+	memset(bus, 0, sizeof(*bus));
+	bus->transfer = simTransfer;
+	bus->context = &sim->port[number];
+}
+
+/**
+ * Apply a voltage to a pin.
+ * Parameters:
+ * 	sim = simulator
+ * 	cs = board number
+ * 	pin = pin number (0 to 7)
+ * 	millivolts = voltage
+ */
+void simSetInput(AD5592_Sim *sim, uint8_t cs, uint8_t pin, uint16_t millivolts)
+{
+	sim->board[cs].external[pin] = millivolts;
+}
+
+/**
+ * Zero the transaction counters of every board.
+ * Parameters:
+ * 	sim = simulator
+ */
+void simClearCounters(AD5592_Sim *sim)
+{
+	int i;
+
+	for(i = 0; i < AD5592_SIM_BOARDS; i++)
+	{
+		memset(&sim->board[i].count, 0, sizeof(sim->board[i].count));
+	}
+}
+
+/**
+ * Add up the transaction counters of every board.
+ * Parameters:
+ * 	sim = simulator
+ * 	total = counters to fill in
+ */
+void simTotalCounters(AD5592_Sim *sim, AD5592_SimCounters *total)
+{
+	int i;
+	int j;
+
+	memset(total, 0, sizeof(*total));
+	for(i = 0; i < AD5592_SIM_BOARDS; i++)
+	{
+		total->transfers += sim->board[i].count.transfers;
+		total->frames += sim->board[i].count.frames;
+		total->bytes += sim->board[i].count.bytes;
+		total->dacWrites += sim->board[i].count.dacWrites;
+		for(j = 0; j < AD5592_REG_COUNT; j++)
+		{
+			total->commands[j] += sim->board[i].count.commands[j];
+		}
+	}
+}
@@ -0,0 +1,193 @@
+/*********************************************************************
+ * File: AD5592Sim.h
+ * Target: Any Linux host
+ * Function: Software model of the AD5592 behind an AD5592_Transport
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Transport.h v1.0.0
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release. Models the command set in AD5592.h for up to
+ * 			two boards, optionally cross wired pin to pin like the ATP
+ * 			jig.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- Conversions sample at the start of a frame.
+ * 	* Version 1.1.0: 16 October 2026
+ * 		- Up to AD5592_TRANSPORT_MAX_CS boards. simWire() joins pins of
+ * 			any boards to shared nets, like a multi UUT jig.
+ * 	* Version 1.2.0: 16 October 2026
+ * 		- AD5592_SIM_BUSES buses of boards on the same nets.
+ * 			simBusTransportInit() gives the transport of each bus, so
+ * 			the jig of AD5592LineATP can be simulated.
+ * 		- contention counts reads of a net driven by two boards.
+ *
+ * Model of the bus timing:
+ * 	- The word clocked out during a frame was prepared by the frame
+ * 		before it.
+ * 	- A conversion samples at the start of its frame, before the
+ * 		command in that frame takes effect.
+ * 	- The frame that writes the ADC sequence register converts nothing.
+ * 		Every later frame converts the next channel of the sequence and
+ * 		the result goes out during the frame after. With the repeat bit
+ * 		set the sequence starts over after the last channel.
+ * 	- GPIO input reads, DAC readback and control register readback put
+ * 		their data in the next frame. The sequencer skips a conversion in
+ * 		a frame that carries one of these commands.
+ **********************************************************************/
+
+#ifndef SOURCES_AD5592SIM_H_
+#define SOURCES_AD5592SIM_H_
+
+#include "AD5592RPI.h"
+
+#define AD5592_SIM_BUSES		2		/* Simulated buses */
+#define AD5592_SIM_BOARDS		(AD5592_SIM_BUSES * AD5592_TRANSPORT_MAX_CS)	/* Boards on all buses */
+
+/**
+ * Board number of a chip select on a bus. Bus 0 has boards 0 to
+ * AD5592_TRANSPORT_MAX_CS - 1, bus 1 the next ones and so on.
+ */
+#define AD5592_SIM_BOARD(bus, cs)	((bus) * AD5592_TRANSPORT_MAX_CS + (cs))
+#define AD5592_SIM_VREF_MV		5000	/* Reference on the Snack board */
+#define AD5592_SIM_VDD_MV		5000	/* Supply, sets the GPIO levels */
+#define AD5592_SIM_TEMP_COUNT	0x0330	/* Temperature sensor reading */
+#define AD5592_SIM_TEMP_ADDRESS	0x8000	/* Address bits of a temperature result */
+
+/**
+ * GP control register bits the model uses.
+ */
+#define AD5592_GP_ADC_RANGE		0x0020	/* ADC range is 2 x Vref */
+#define AD5592_GP_DAC_RANGE		0x0010	/* DAC range is 2 x Vref */
+
+/**
+ * Readback enable bits of a DAC readback word.
+ */
+#define AD5592_DAC_READBACK_EN	0x0018
+
+/**
+ * Transaction counters for one simulated board.
+ */
+typedef struct
+{
+	uint32_t transfers;						/* Transport calls for this board */
+	uint32_t frames;						/* 16 bit frames */
+	uint32_t bytes;							/* Bytes each way */
+	uint32_t commands[AD5592_REG_COUNT];	/* Control words by register address */
+	uint32_t dacWrites;						/* DAC data writes */
+} AD5592_SimCounters;
+
+/**
+ * One simulated AD5592.
+ */
+typedef struct
+{
+	AD5592_WORD reg[AD5592_REG_COUNT];	/* Control registers */
+	AD5592_WORD dacInput[8];			/* DAC input registers */
+	AD5592_WORD dacOutput[8];			/* DAC registers driving the pins */
+	AD5592_WORD out;					/* Word for the next frame */
+	uint8_t seqRunning;					/* ADC sequence converting */
+	uint8_t seqPos;						/* Next entry of the sequence */
+	uint16_t external[8];				/* Voltage applied to unwired pins, mV */
+	AD5592_SimCounters count;			/* Transaction counters */
+} AD5592_SimBoard;
+
+typedef struct AD5592_Sim AD5592_Sim;
+
+/**
+ * Transport context of one simulated bus.
+ */
+typedef struct
+{
+	AD5592_Sim *sim;		/* Simulator the bus belongs to */
+	uint8_t first;			/* Board number of chip select 0 */
+} AD5592_SimPort;
+
+/**
+ * Simulated buses. The nets join boards on any of them.
+ */
+struct AD5592_Sim
+{
+	AD5592_SimBoard board[AD5592_SIM_BOARDS];	/* Boards by board number */
+	AD5592_SimPort port[AD5592_SIM_BUSES];		/* Transport context by bus */
+	uint8_t wired[AD5592_SIM_BOARDS];	/* Pins of each board on the nets, pin n on net n */
+	uint16_t noise;			/* Peak ADC noise in counts, 0 for none */
+	uint32_t seed;			/* Noise generator state */
+	uint32_t contention;	/* Reads of a net that two boards drive */
+};
+
+/**
+ * Set up a simulated bus with every board in its reset state.
+ * Parameters:
+ * 	sim = simulator
+ * 	crossWired = non zero to wire pin n of board 0 to pin n of board 1
+ */
+void simInit(AD5592_Sim *sim, uint8_t crossWired);
+
+/**
+ * Join pins of a board to the nets. Pin n of every board joined to net
+ * n is wired together, so a pin reads what any of them drives.
+ * Parameters:
+ * 	sim = simulator
+ * 	cs = board number
+ * 	pins = pins to join as bit mask, 0 to take the board off the nets
+ */
+void simWire(AD5592_Sim *sim, uint8_t cs, uint8_t pins);
+
+/**
+ * Set up a transport that talks to bus 0 of the simulator.
+ * Parameters:
+ * 	bus = transport to set up
+ * 	sim = simulator
+ */
+void simTransportInit(AD5592_Transport *bus, AD5592_Sim *sim);
+
+/**
+ * Set up a transport that talks to one bus of the simulator. Chip
+ * select cs reaches board AD5592_SIM_BOARD(number, cs).
+ * Parameters:
+ * 	bus = transport to set up
+ * 	sim = simulator
+ * 	number = bus, 0 to AD5592_SIM_BUSES - 1
+ */
+void simBusTransportInit(AD5592_Transport *bus, AD5592_Sim *sim, uint8_t number);
+
+/**
+ * Apply a voltage to a pin. Used when nothing else drives the pin.
+ * Parameters:
+ * 	sim = simulator
+ * 	cs = board number
+ * 	pin = pin number (0 to 7)
+ * 	millivolts = voltage
+ */
+void simSetInput(AD5592_Sim *sim, uint8_t cs, uint8_t pin, uint16_t millivolts);
+
+/**
+ * Get the voltage on a pin.
+ * Parameters:
+ * 	sim = simulator
+ * 	cs = board number
+ * 	pin = pin number (0 to 7)
+ * Returns:
+ * 	millivolts
+ */
+uint16_t simPinVoltage(AD5592_Sim *sim, uint8_t cs, uint8_t pin);
+
+/**
+ * Zero the transaction counters of every board.
+ * Parameters:
+ * 	sim = simulator
+ */
+void simClearCounters(AD5592_Sim *sim);
+
+/**
+ * Add up the transaction counters of every board.
+ * Parameters:
+ * 	sim = simulator
+ * 	total = counters to fill in
+ */
+void simTotalCounters(AD5592_Sim *sim, AD5592_SimCounters *total);
+
+#endif /* SOURCES_AD5592SIM_H_ */
@@ -3,11 +3,16 @@
  * Target: Raspberry Pi
  * Function: Acceptance Test Procedure for AD5592 Snack board
  * Dependancies: 
- * 		-bcm2835.h v1.20 2015/03/31 04:55:41
- * 		-AD5592.h v1.0.2 25 November 2016
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Batch.h v1.1.0
+ * 		-AD5592Plan.h v1.2.0
+ * 		-AD5592Timing.h v1.0.0
+ * 		-AD5592Log.h v1.0.0
+ * 		-AD5592Trace.h v1.0.0
+ * 		-AD5592Sim.h v1.2.0
  * Author: Tom Olenik
  * Original Date: 03 December 2016
- * Last Revised Date: 03 December 2016
+ * Last Revised Date: 16 October 2026
  * Release Notes:
  * 	* Version: 1.0.0:
  * 		-This test requires two AD5592 Snack boards to be connected. The
@@ -33,444 +38,285 @@
  * 			- 2.5V
  * 			- 4.5V
  * 		
+ * 	* Version: 1.0.1:
+ * 		-a2d() and d2a() use the integer conversions in AD5592Conv.h
+ * 		instead of float math. Counts are rounded to nearest.
+ * 
+ * 	* Version: 1.1.0:
+ * 		-Runs on the AD5592RPI driver instead of its own SPI code.
+ * 
+ * 		-No resets between steps. Pins are moved between modes with
+ * 		the register writes worked out from the board shadows, and the
+ * 		board that stops driving a pin is always switched first.
+ * 
+ * 		-Each analog level drives all 8 DAC pins of one board together
+ * 		with an LDAC load and reads all 8 ADC pins of the other board
+ * 		with one sequence scan. The millisecond delays are replaced by
+ * 		the settling times below.
+ * 
+ * 	* Version: 1.2.0:
+ * 		-The tests are read from a plan file, AD5592Snack.plan unless
+ * 		another file is named on the command line. The plan is compiled
+ * 		into a schedule that orders the steps for the fewest pin mode
+ * 		changes and shares drive and measure rounds between steps on
+ * 		different pins. See AD5592Plan.h for the file format.
+ * 
+ * 		-Exits with 1 if any check fails.
+ * 
+ * 	* Version: 1.2.1:
+ * 		-Waits use timingWaitUs() and the datasheet minimums in
+ * 		AD5592Timing.h. With settle stable in the plan the settling
+ * 		times are measured and reported.
+ * 
+ * 	* Version: 1.3.0:
+ * 		-The test log is a binary AD5592_Log named
+ * 		ATP-<UTC date>-<UTC time>.ad5592log. Checks are recorded as
+ * 		result records and the report lines as text. Convert it with
+ * 		AD5592LogDump. The terminal output is unchanged.
+ * 
+ * 	* Version: 1.4.0:
+ * 		-Usage: AD5592SnackATP [-p trace] [plan]
+ * 
+ * 		-Every frame on the bus is recorded to
+ * 		ATP-<UTC date>-<UTC time>.ad5592trace next to the test log.
+ * 		Check it against the simulator with AD5592Replay.
+ * 
+ * 		-With -p the boards are not used. The driver is answered from
+ * 		the trace of an earlier run so a failure can be repeated at a
+ * 		desk. Frames the run sends that differ from the trace are
+ * 		counted and reported.
+ * 
+ * 	* Version: 1.4.1:
+ * 		-SPI transfers that fail are counted and reported, and fail the
+ * 		test, instead of being read as 0V.
+ * 
+ * 	* Version: 1.5.0:
+ * 		-Usage: AD5592SnackATP [-t spi|sim] [-p trace] [plan]
+ * 
+ * 		-With -t sim the boards are two cross wired boards in
+ * 		AD5592Sim, so the plan can be checked without the jig. The
+ * 		bus trace is still recorded. The test also fails if a net was
+ * 		read while both boards drove it.
+ * 
  **********************************************************************/
 #include <time.h>
-#include <bcm2835.h>
 #include <stdio.h>
-#include "AD5592.h"
-
-#define	SHORT_DELAY	10		/* Delay used to let device do it's thing */
-#define LONG_DELAY	50		/* Longer delay to give it more time */
-#define	TOLERANCE	41		/* The digital +- tolerance for analog IO test */
-#define TEST_DEVICE   BCM2835_SPI_CS0
-#define	UNIT_UNDER_TEST BCM2835_SPI_CS1
-
-char spiOut[2]; 			/* SPI output buffer */
-char spiIn[2];	 			/* SPI input buffer  */
-
-FILE *filePointer;			/* pointer to file object */
-uint16_t mV;				/* millivolts */
-uint16_t result;			/* result result */
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+#include "AD5592RPI.h"
+#include "AD5592Batch.h"
+#include "AD5592Plan.h"
+#include "AD5592Timing.h"
+#include "AD5592Log.h"
+#include "AD5592Trace.h"
+#include "AD5592Sim.h"
 
-/**
- * Clear the spi buffer.
- * Parameters:
- * 	spiBuffer[] = spi buffer
- */
-void clearBuffer(char spiBuffer[])
-{
-	int i;
-	for(i=0;i<sizeof(spiBuffer);i++)
-	{
-		spiBuffer[i] = 0x00;
-	}
-}
+#define TEST_DEVICE		CHANNEL0
+#define	UNIT_UNDER_TEST	CHANNEL1
 
-/**
- * Parse the 16 bit word of the AD5592 into two 8 bit chunks that
- * works with the bcm2835 library.
- * Parameters:
- * 	eightBits[] = spi buffer
- * 	sixteenBits = AD5592 spi word
- */
-void makeWord(char eightBits[], AD5592_WORD sixteenBits)
-{
-	clearBuffer(eightBits);
-	eightBits[0] = (sixteenBits & 0xFF00) >> 8;
-	eightBits[1] = sixteenBits & 0xFF;
-	//printf("\n Command Word = %x %x", eightBits[0],eightBits[1]);
-}
+#define DEFAULT_PLAN	"AD5592Snack.plan"
 
-/**
- * Set the CS0 line for test device
- * Parameters:
- * 	none
- */
-void testDevice()
-{
-	bcm2835_spi_chipSelect(TEST_DEVICE);        
-    bcm2835_spi_setChipSelectPolarity(TEST_DEVICE, LOW);   
-}
+AD5592_Log testLog;			/* Acceptance test data log */
 
 /**
- * Set the CS1 line for unit under test
+ * Print a line and record it in the test log.
  * Parameters:
- * 	none
+ * 	format = printf format and its arguments
  */
-void uut()
+void report(const char *format, ...)
 {
-	bcm2835_spi_chipSelect(UNIT_UNDER_TEST);        
-    bcm2835_spi_setChipSelectPolarity(UNIT_UNDER_TEST, LOW);   
-}
-
-/**
- * Convert a voltage to an digital value based upon assumptions of
- * 0 - 5V input and 12 bit ADC/DAC.
- * Parameter: millivolts as 16 bit unsigned integer
- * Returns: digital value as 16 bit unsigned integer
- */
- uint16_t a2d(uint16_t millivolts)
- {
-	 uint16_t count = millivolts * .819f;
-	 return count;
- }
- 
- /**
- * Convert a digital value to voltage based upon assumptions of
- * 0 - 5V input and 12 bit ADC/DAC.
- * Parameter: digital value as 16 bit unsigned integer
- * Returns: millivolts as 16 bit unsigned integer
- */
-uint16_t d2a(uint16_t count)
-{
-	uint16_t millivolts = count / .819f;
-	return millivolts;
-}
-/**
- * Set pins to digital outputs.
- * Parameter: Pins as bit mask
- */
-void setAsDigitalOut(AD5592_WORD pins)
-{
-	makeWord(spiOut, AD5592_GPIO_WRITE_CONFIG | pins);
-	bcm2835_spi_transfern(spiOut, sizeof(spiOut));
-}
-
-/**
- * Set pins to a digital inputs.
- * Parameter: Pins as bit mask
- */
- void setAsDigitalIn(AD5592_WORD pins)
-{
-	makeWord(spiOut, AD5592_GPIO_READ_CONFIG | pins);
-	bcm2835_spi_transfern(spiOut, sizeof(spiOut));
-}
-
-/**
- * Set pins to analog outputs.
- * Parameter: Pins as bit mask
- */
-void setAsDAC(AD5592_WORD pins)
-{
-	makeWord(spiOut, AD5592_DAC_PIN_SELECT | pins);
-	bcm2835_spi_transfern(spiOut, sizeof(spiOut));
-}
+	char line[256];
+	va_list args;
 
-/**
- * Set pins to a analog inputs.
- * Parameter: Pins as bit mask
- */
- void setAsADC(AD5592_WORD pins)
-{
-	makeWord(spiOut, AD5592_ADC_PIN_SELECT | pins);
-	bcm2835_spi_transfern(spiOut, sizeof(spiOut));
+	va_start(args, format);
+	vsnprintf(line, sizeof(line), format, args);
+	va_end(args);
+	printf("%s", line);
+	logText(&testLog, line);
 }
 
-/**
- * SPI communications
- * Parameter:
- * 	Command to send.
- */
-void spiComs(AD5592_WORD command)
+int main(int argc, char **argv)
 {
-	makeWord(spiOut, command);
-	clearBuffer(spiIn);
-	bcm2835_spi_transfernb(spiOut, spiIn, sizeof(spiOut));
-}
+	static AD5592_Transport bus;
+	static AD5592_Transport traceBus;
+	static AD5592_Trace trace;
+	static AD5592_TracePlayback playback;
+	static AD5592_Sim sim;
+	static AD5592_Plan plan;
+	static AD5592_Schedule schedule;
+	const char *planName = DEFAULT_PLAN;
+	const char *playbackName = NULL;
+	const char *transportName = "spi";
+	FILE *planFile;
+	static AD5592_SettleStats settleStats;
+	int failed;
+	uint32_t transferErrors;
+	int option;
 
-/**
- * Test digital function
- */
-void digitalIOTest()
-{
-	printf("\n\nStarting digital io test\n\n");
-	fprintf(filePointer, "\n\nStarting digital io test\n\n");
-	
-	/* Set test device to digital input */
-	testDevice();   
-	setAsDigitalIn(AD5592_PIN_SELECT_MASK);
-	
-	/* Set unit under test to digital output */
-	uut();  
-    setAsDigitalOut(AD5592_PIN_SELECT_MASK);
-    
-    /* Write digital output high to all pins of unit under test */
-	spiComs(AD5592_GPIO_WRITE_DATA | AD5592_PIN_SELECT_MASK);
-	
-	/* Read digital values on test device */
-	testDevice(); 	
-	spiComs(AD5592_GPIO_READ_INPUT | AD5592_PIN_SELECT_MASK);
-	spiComs(AD5592_NOP);
-	
-	/* Check if values are correct */
-	result = spiIn[1];
-	if(result == 0x00FF)
+	while((option = getopt(argc, argv, "t:p:")) != -1)
 	{
-		printf("\nDigital output high test: PASS ... Value = %x", result);
-		fprintf(filePointer, "\nDigital output high test: PASS ... Value = %x", result);
-	}else{
-		printf("\nDigital output high test: FAIL ... Value = %x", result);
-		fprintf(filePointer, "\nDigital output high test: FAIL ... Value = %x", result);
+		if(option == 'p')
+		{
+			playbackName = optarg;
+		}else if(option == 't' && (strcmp(optarg, "spi") == 0 || strcmp(optarg, "sim") == 0))
+		{
+			transportName = optarg;
+		}else
+		{
+			printf("Usage: %s [-t spi|sim] [-p trace] [plan]\n", argv[0]);
+			return 1;
+		}
 	}
-	
-	/* Set unit under test to output low values */
-	uut();
-	
-	//printf("/n The SPI command should be: %x", AD5592_GPIO_WRITE_DATA);
-	spiComs(AD5592_GPIO_WRITE_DATA); 	
-	
-	/* Read digital values on test device */
-	testDevice(); 
-	spiComs(AD5592_GPIO_READ_INPUT | AD5592_PIN_SELECT_MASK);
-	spiComs(AD5592_NOP);
-	
-	/* Check if values are correct */
-	result = spiIn[1];
-	if(result == 0x000)
+	if(optind < argc)
 	{
-		printf("\nDigital output low test: PASS ... Value = %x", result);
-		fprintf(filePointer, "\nDigital output low test: PASS ... Value = %x", result);
-	}else{
-		printf("\nDigital output low test: FAIL ... Value = %x", result);
-		fprintf(filePointer, "\nDigital output low test: FAIL ... Value = %x", result);
+		planName = argv[optind];
 	}
-	
-	/* Switch unit under test to input */
-	uut(); 
-	 
-	spiComs(AD5592_SW_RESET);
-	delay(SHORT_DELAY);
-	
-    setAsDigitalIn(AD5592_PIN_SELECT_MASK);
-    
-    /* Switch test device to output and all pins high */
-    testDevice();
-     
-    spiComs(AD5592_SW_RESET);
-    delay(SHORT_DELAY);
-       
-	setAsDigitalOut(AD5592_PIN_SELECT_MASK);
-	spiComs(AD5592_GPIO_WRITE_DATA | AD5592_PIN_SELECT_MASK);
-		
-	/* Read digital inputs of unit under test */
-	uut(); 
-	spiComs(AD5592_GPIO_READ_INPUT | AD5592_PIN_SELECT_MASK);
-	spiComs(AD5592_NOP);
-    
-  	/* Check if values are correct */
-	result = spiIn[1];
-	if(result == 0xFF)
+
+	/* Read and compile the test plan before touching the boards */
+	planFile = fopen(planName, "r");
+	if(planFile == NULL)
 	{
-		printf("\nDigital input high test: PASS ... Value = %x", result);
-		fprintf(filePointer, "\nDigital input high test: PASS ... Value = %x", result);
-	}else{
-		printf("\nDigital input high test: FAIL ... Value = %x", result);
-		fprintf(filePointer, "\nDigital input high test: FAIL ... Value = %x", result);
+		printf("Could not open test plan %s\n", planName);
+		return 1;
 	}
-	
-    /* Set test device output on all pins low */
-    testDevice();
-    spiComs(AD5592_GPIO_WRITE_DATA);	
-	
-	/* Read digital inputs of unit under test */
-	uut();
-	spiComs(AD5592_GPIO_READ_INPUT | AD5592_PIN_SELECT_MASK);
-    spiComs(AD5592_NOP);
-    
-  	/* Check if values are correct */
-	result = spiIn[1];
-	if(result == 0x00)
+	if(!planLoad(&plan, planFile))
 	{
-		printf("\nDigital input low test: PASS ... Value = %x", result);
-		fprintf(filePointer, "\nDigital input low test: PASS ... Value = %x", result);
-	}else{
-		printf("\nDigital input low test: FAIL ... Value = %x", result);
-		fprintf(filePointer, "\nDigital input low test: FAIL ... Value = %x", result);
+		printf("Test plan %s: error on line %d\n", planName, plan.errorLine);
+		fclose(planFile);
+		return 1;
+	}
+	fclose(planFile);
+	if(!planCompile(&plan, &schedule))
+	{
+		printf("Test plan %s does not fit in %d operations\n", planName, AD5592_PLAN_OPS);
+		return 1;
 	}
-	
-		printf("\n\nDigital io test complete\n\n");
-	fprintf(filePointer, "\n\nDigital io test complete\n\n");	  
-}
 
-/**
- * Test analog function
- */
-void analogIOTest()
-{
-	printf("\n\nStarting analog io test\n\n");
-	fprintf(filePointer, "\n\nStarting analog io test\n\n");	
-		
-	uint16_t lowVoltage = 500;		/* 500 millivolts = 0.5 V */
-	uint16_t midVoltage	 = 2500;	/* 2500 millivolts = 2.5 V */
-	uint16_t highVoltage = 4500;	/* 4500 millivolts = 4.5 V */
-	
-	/* Convert voltage values to digital values */
-	uint16_t lowCount = a2d(lowVoltage);
-	uint16_t midCount = a2d(midVoltage);
-	uint16_t highCount = a2d(highVoltage);
-	
-	uint16_t targetVal[] = {lowCount,midCount,highCount};
-	
-	int i;
-	int j;
-	
-/* Test analog out */
-	
-	for(j = 0; j < 3;j++)
+	if(playbackName)
+	{
+		/* Answer from the trace of an earlier run */
+		if(!traceMap(&playback.view, playbackName))
+		{
+			printf("%s is not an AD5592 trace this host can read\n", playbackName);
+			return 1;
+		}
+		tracePlaybackInit(&bus, &playback);
+	}else if(strcmp(transportName, "sim") == 0)
+	{
+		/* Two boards wired pin to pin like the jig */
+		simInit(&sim, 1);
+		simTransportInit(&bus, &sim);
+	}else
 	{
-		delay(LONG_DELAY);
-		for(i = 0; i<8 ; i++)
+#ifdef AD5592_NO_BCM2835
+		static AD5592_Spidev spidev;
+
+		if(!spidevTransportInit(&bus, &spidev, 0, AD5592_SPI_SPEED_HZ))
+		{
+			printf("Could not open /dev/spidev0.0\n");
+			return 1;
+		}
+#else
+		/* Initialize the bcm2835 library and SPI module */
+		if(!bcm2835TransportInit(&bus))
 		{
-			uut(); /* start out addressing unit under test */
-			spiComs(AD5592_SW_RESET);
-			delay(SHORT_DELAY);
-			spiComs(AD5592_DAC_PIN_SELECT | (0x1<<i));
-			spiComs(AD5592_DAC_WRITE_MASK | 			/* DAC write command */
-				((i <<12) & AD5592_DAC_ADDRESS_MASK)|	/* Set which pin to write */
-				targetVal[j]);							/* Load digital value */
-						
-			/* Check the value */
-			testDevice();
-			spiComs(AD5592_SW_RESET);
-			delay(SHORT_DELAY);
-			spiComs(AD5592_ADC_PIN_SELECT | (0x1<<i));
-			delay(SHORT_DELAY);
-			spiComs(AD5592_ADC_READ | (0x1 << i));
-			spiComs(AD5592_NOP);
-			spiComs(AD5592_NOP);
-			
-			/* Get result */
-			result = ((spiIn[0] << 8) & 0x0F00) | (spiIn[1] & 0xFF);
-			
-			/* Report and record result */
-			printf("\nDAC test on IO%d target = %d", i, targetVal[j]);
-			fprintf(filePointer, "\nDAC test IO%d target = %d", i, targetVal[j]);
-			printf("...Result = %d", result);
-			fprintf(filePointer, "...Result = %d", result);
-			
-			/* Test, report, and record pass/fail */
-			if((targetVal[j] + TOLERANCE) > result && (targetVal[j] - TOLERANCE) < result)
-			{
-				/* PASS */
-				printf("...PASS");
-				fprintf(filePointer, "...PASS");
-			}else
-			{
-				/* FAIL */
-				printf("...FAIL");
-				fprintf(filePointer, "...FAIL");
-			}
+			printf("bcm2835 init failed. Are you running as root??\n");
+			return 1;
 		}
+#endif
 	}
-	
-/* Test analog in */
+    
+	/* Get a time stamp */
+	time_t timeStamp;
+	struct timespec start;
+	struct timespec finish;
+	char logName[64];
+	char traceName[64];
+	time(&timeStamp);
+	clock_gettime(CLOCK_MONOTONIC, &start);
 
-	bcm2835_delay(LONG_DELAY);
+	/* Create a file for the acceptance test data log */
+	strftime(logName, sizeof(logName), "ATP-%Y%m%d-%H%M%S.ad5592log", gmtime(&timeStamp));
+	if(!logOpen(&testLog, logName, "AD5592 Snack ATP"))
+	{
+		printf("Could not create %s\n", logName);
+		return 1;
+	}
 
-	for(j = 0; j < 3; j++)
+	/* Record the bus traffic of a run on the boards */
+	if(playbackName)
+	{
+		AD5592_InitTransport(&bus);
+	}else
 	{
-		delay(LONG_DELAY);
-		for(i = 0; i<8 ; i++)
+		strftime(traceName, sizeof(traceName), "ATP-%Y%m%d-%H%M%S.ad5592trace", gmtime(&timeStamp));
+		if(!traceOpen(&trace, traceName, "AD5592 Snack ATP"))
 		{
-			
-			testDevice(); /* Start out addressing test device */
-			spiComs(AD5592_SW_RESET);
-			delay(SHORT_DELAY);
-			spiComs(AD5592_DAC_PIN_SELECT | (0x1<<i));
-			spiComs(AD5592_DAC_WRITE_MASK | 			/* DAC write command */
-				((i <<12) & AD5592_DAC_ADDRESS_MASK)|	/* Set which pin to write */
-				targetVal[j]);							/* Load digital value */
-			
-			/* Check the value */
-			uut();
-			spiComs(AD5592_SW_RESET);
-			delay(SHORT_DELAY);
-			spiComs(AD5592_ADC_PIN_SELECT | (0x1<<i));
-			delay(SHORT_DELAY);
-			spiComs(AD5592_ADC_READ | (0x1 << i));
-			spiComs(AD5592_NOP);
-			spiComs(AD5592_NOP);
-			
-			/* Get result */
-			result = ((spiIn[0] << 8) & 0x0F00) | (spiIn[1] & 0xFF);
-			
-			/* Report and record result */
-			printf("\nADC test on IO%d target = %d", i, targetVal[j]);
-			fprintf(filePointer, "\nADC test IO%d target = %d", i, targetVal[j]);
-			printf("...Result = %d", result);
-			fprintf(filePointer, "...Result = %d", result);
-			
-			/* Test, report, and record pass/fail */
-			if((targetVal[j] + TOLERANCE) > result && (targetVal[j] - TOLERANCE) < result)
-			{
-				/* PASS */
-				printf("...PASS");
-				fprintf(filePointer, "...PASS");
-			}else
-			{
-				/* FAIL */
-				printf("...FAIL");
-				fprintf(filePointer, "...FAIL");
-			}
-			
+			printf("Could not create %s\n", traceName);
+			return 1;
 		}
-	}	
-
-	printf("\n\nAnalog io test complete\n\n");
-	fprintf(filePointer, "\n\nAnalog io test complete\n\n");
-}
-
-int main(int argc, char **argv)
-{
-	/* Initialize the bcm2835 library */
-	if (!bcm2835_init())
-    {
-      printf("bcm2835_init failed. Are you running as root??\n");
-      return 1;
-    }
-    
-    /* Initialize the SPI module */
-    if (!bcm2835_spi_begin())
-    {
-      printf("bcm2835_spi_begin failedg. Are you running as root??\n");
-      return 1;
-    }
-    /* Set SPI bit order */
-    bcm2835_spi_setBitOrder(BCM2835_SPI_BIT_ORDER_MSBFIRST);      // The default
-    
-    /* Set SPI polarity and phase */
-    bcm2835_spi_setDataMode(BCM2835_SPI_MODE1);                   // Mode 1
-    
-    /* Set SPI clock */
-    bcm2835_spi_setClockDivider(BCM2835_SPI_CLOCK_DIVIDER_16); 	  // 16 = 64ns = 15.625MHz
-    
-    /* Get a time stamp */
-    time_t timeStamp;
-	time(&timeStamp);
-    filePointer = fopen(ctime(&timeStamp),"w");	/* Create a file for the acceptance test data log */
+		traceTransportInit(&traceBus, &trace, &bus);
+		AD5592_InitTransport(&traceBus);
+	}
 	
 	/* Report and record start of test time */
-	printf("Test start time: %s \n", ctime(&timeStamp));
-    fprintf(filePointer, "Test start time: %s \n", ctime(&timeStamp));
+	report("Test start time: %s \n", ctime(&timeStamp));
+
+	/* Both boards start from their power on state */
+	deviceReset(&ad5592Channel[UNIT_UNDER_TEST]);
+	deviceReset(&ad5592Channel[TEST_DEVICE]);
+	timingWaitUs(AD5592_SETTLE_RESET_US);
     
 	/* Perform tests */
-	digitalIOTest();
-	analogIOTest();
+	report("Test plan: %s, %d steps, %d rounds, %d mode changes\n", planName,
+		plan.steps, schedule.rounds, schedule.modeChanges);
+	failed = planRun(&plan, &schedule, &testLog, &settleStats);
 	
-	uut();
-	spiComs(AD5592_SW_RESET);
-	testDevice();
-	spiComs(AD5592_SW_RESET);
+	deviceReset(&ad5592Channel[UNIT_UNDER_TEST]);
+	deviceReset(&ad5592Channel[TEST_DEVICE]);
     
-    /* Get new time stamp */
-    time(&timeStamp);
+	/* Get new time stamp */
+	time(&timeStamp);
+	clock_gettime(CLOCK_MONOTONIC, &finish);
     
-    /* Report and record test finish time */
-    printf("\n\nTest finish time: %s", ctime(&timeStamp));
-    fprintf(filePointer, "\n\nTest finish time: %s", ctime(&timeStamp));
+	/* Report and record test finish time */
+	if(settleStats.count)
+	{
+		report("\n\nSettling: %u waits, mean %u us, max %u us, %u timeouts", settleStats.count,
+			(unsigned)(settleStats.totalUs / settleStats.count), settleStats.maxUs, settleStats.timeouts);
+	}
+	report("\n\nFailed checks: %d", failed);
+	transferErrors = ad5592Channel[UNIT_UNDER_TEST].transferErrors +
+		ad5592Channel[TEST_DEVICE].transferErrors;
+	if(transferErrors)
+	{
+		report("\n\nFailed SPI transfers: %u", transferErrors);
+	}
+	if(sim.contention)
+	{
+		report("\n\nSimulated nets read while driven twice: %u", sim.contention);
+	}
+	report("\n\nTest finish time: %s", ctime(&timeStamp));
+	report("Test duration: %ld ms\n", (long)((finish.tv_sec - start.tv_sec) * 1000 +
+		(finish.tv_nsec - start.tv_nsec) / 1000000));
     
-    /* Close the test log file */
-    fclose(filePointer);
-	return 0;
+	/* Close the test log file */
+	logClose(&testLog);
+	printf("Test log: %s\n", logName);
+	if(playbackName)
+	{
+		printf("Played back %s: %u frames, %u differ from the trace, %u past its end\n",
+			playbackName, playback.frames, playback.mismatches, playback.overruns);
+		traceUnmap(&playback.view);
+	}else
+	{
+		if(!traceClose(&trace))
+		{
+			printf("Bus trace %s is incomplete\n", traceName);
+		}
+		printf("Bus trace: %s\n", traceName);
+	}
+	transportClose(&bus);
+	return failed || transferErrors || sim.contention ? 1 : 0;
 }
-
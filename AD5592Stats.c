@@ -0,0 +1,234 @@
+/***********************************************************************
+ * File: AD5592Stats.c
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Driver instrumentation counters and latency histograms
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Stats.h
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- statsNowNs() is replaced by clockNowNs() from AD5592Clock.h.
+ **********************************************************************/
+
+#include <string.h>
+#include "AD5592Stats.h"
+
+static AD5592_StatsSlot statsSlot[AD5592_STATS_SLOTS];	/* One per thread */
+static atomic_int statsThreads;							/* Threads given a slot */
+static _Thread_local AD5592_StatsSlot *statsMine;		/* Slot of this thread */
+
+/**
+ * Register names by address, then DAC writes.
+ */
+static const char *const statsCommandName[AD5592_STATS_COMMANDS] =
+{
+	"NOP", "DAC_READBACK", "ADC_READ", "GP_CNTRL",
+	"ADC_PIN_SELECT", "DAC_PIN_SELECT", "PULL_DOWN_SET", "CNTRL_REG_READBACK",
+	"GPIO_WRITE_CONFIG", "GPIO_WRITE_DATA", "GPIO_READ_CONFIG", "POWER_DWN_REF_CNTRL",
+	"GPIO_DRAIN_CONFIG", "THREE_STATE_CONFIG", "reserved", "SW_RESET",
+	"DAC write"
+};
+
+/**
+ * Pin configuration function names.
+ */
+static const char *const statsReconfigName[AD5592_STATS_RECONFIGS] =
+{
+	"setAsDAC", "setAsADC", "setAsDigitalIn", "setAsDigitalOut"
+};
+
+/**
+ * Get the slot of this thread.
+ */
+static AD5592_StatsSlot *statsGetSlot(void)
+{
+	if(statsMine == NULL)
+	{
+		statsMine = &statsSlot[atomic_fetch_add_explicit(&statsThreads, 1, memory_order_relaxed) %
+			AD5592_STATS_SLOTS];
+	}
+	return statsMine;
+}
+
+/**
+ * Add to a counter of this thread's slot.
+ */
+static inline void statsAdd(atomic_uint_fast64_t *counter, uint64_t value)
+{
+	atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + value,
+		memory_order_relaxed);
+}
+
+/**
+ * Count a command.
+ * Parameters:
+ * 	command = AD5592 word
+ * 	sent = 1 if it goes to the board, 0 if the shadow skipped it
+ */
+void statsCommand(AD5592_WORD command, int sent)
+{
+	AD5592_StatsSlot *slot = statsGetSlot();
+	int index = command & AD5592_DAC_WRITE_MASK ? AD5592_REG_COUNT : AD5592_REG_INDEX(command);
+
+	statsAdd(sent ? &slot->sent[index] : &slot->skipped[index], 1);
+}
+
+/**
+ * Count a transfer.
+ * Parameters:
+ * 	frames = number of 16 bit frames
+ * 	startNs = clockNowNs() before the transfer
+ */
+void statsTransfer(int frames, uint64_t startNs)
+{
+	AD5592_StatsSlot *slot = statsGetSlot();
+	uint64_t ns = clockNowNs() - startNs;
+	int bucket = ns ? 63 - __builtin_clzll(ns) : 0;
+
+	if(bucket >= AD5592_STATS_BUCKETS)
+	{
+		bucket = AD5592_STATS_BUCKETS - 1;
+	}
+	statsAdd(&slot->transfers, 1);
+	statsAdd(&slot->frames, frames);
+	statsAdd(&slot->bytes, 2 * frames);
+	statsAdd(&slot->transferNs, ns);
+	statsAdd(&slot->latency[bucket], 1);
+}
+
+/**
+ * Count a pin configuration call.
+ * Parameters:
+ * 	kind = AD5592_STATS_DAC, _ADC, _GPIO_IN or _GPIO_OUT
+ * 	sent = 1 if it wrote to the board
+ */
+void statsReconfig(int kind, int sent)
+{
+	AD5592_StatsSlot *slot = statsGetSlot();
+
+	statsAdd(&slot->reconfigCalls[kind], 1);
+	statsAdd(&slot->reconfigWrites[kind], sent != 0);
+}
+
+/**
+ * Add one array of counters into another.
+ */
+static void statsSum(atomic_uint_fast64_t total[], atomic_uint_fast64_t counter[], int count)
+{
+	int i;
+
+	for(i = 0; i < count; i++)
+	{
+		statsAdd(&total[i], atomic_load_explicit(&counter[i], memory_order_relaxed));
+	}
+}
+
+/**
+ * Add up every slot.
+ * Parameters:
+ * 	total = slot to fill with the totals
+ */
+void statsTotal(AD5592_StatsSlot *total)
+{
+	AD5592_StatsSlot *slot;
+	int i;
+
+	memset(total, 0, sizeof(*total));
+	for(i = 0; i < AD5592_STATS_SLOTS; i++)
+	{
+		slot = &statsSlot[i];
+		statsSum(total->sent, slot->sent, AD5592_STATS_COMMANDS);
+		statsSum(total->skipped, slot->skipped, AD5592_STATS_COMMANDS);
+		statsSum(&total->transfers, &slot->transfers, 1);
+		statsSum(&total->frames, &slot->frames, 1);
+		statsSum(&total->bytes, &slot->bytes, 1);
+		statsSum(&total->transferNs, &slot->transferNs, 1);
+		statsSum(total->latency, slot->latency, AD5592_STATS_BUCKETS);
+		statsSum(total->reconfigCalls, slot->reconfigCalls, AD5592_STATS_RECONFIGS);
+		statsSum(total->reconfigWrites, slot->reconfigWrites, AD5592_STATS_RECONFIGS);
+	}
+}
+
+/**
+ * Zero every slot. Counts made while it runs may be lost.
+ */
+void statsReset(void)
+{
+	memset(statsSlot, 0, sizeof(statsSlot));
+}
+
+/**
+ * Print the totals.
+ * Parameters:
+ * 	out = stream to print to
+ */
+void statsDump(FILE *out)
+{
+	AD5592_StatsSlot total;
+	uint64_t transfers;
+	uint64_t count;
+	int i;
+
+	statsTotal(&total);
+	transfers = total.transfers;
+#ifndef AD5592_STATS
+	fprintf(out, "AD5592 statistics are compiled out, build with -DAD5592_STATS\n");
+#endif
+	fprintf(out, "transfers %llu frames %llu bytes %llu mean %llu ns\n",
+		(unsigned long long)transfers, (unsigned long long)total.frames,
+		(unsigned long long)total.bytes,
+		(unsigned long long)(transfers ? total.transferNs / transfers : 0));
+
+	fprintf(out, "%-20s %12s %12s\n", "command", "sent", "skipped");
+	for(i = 0; i < AD5592_STATS_COMMANDS; i++)
+	{
+		if(total.sent[i] || total.skipped[i])
+		{
+			fprintf(out, "%-20s %12llu %12llu\n", statsCommandName[i],
+				(unsigned long long)total.sent[i], (unsigned long long)total.skipped[i]);
+		}
+	}
+
+	fprintf(out, "%-20s %12s %12s\n", "configuration", "calls", "writes");
+	for(i = 0; i < AD5592_STATS_RECONFIGS; i++)
+	{
+		fprintf(out, "%-20s %12llu %12llu\n", statsReconfigName[i],
+			(unsigned long long)total.reconfigCalls[i],
+			(unsigned long long)total.reconfigWrites[i]);
+	}
+
+	fprintf(out, "%-20s %12s\n", "transfer ns", "count");
+	for(i = 0; i < AD5592_STATS_BUCKETS; i++)
+	{
+		count = total.latency[i];
+		if(count)
+		{
+			fprintf(out, "%9llu-%-10llu %12llu\n", i ? 1ULL << i : 0ULL,
+				(2ULL << i) - 1, (unsigned long long)count);
+		}
+	}
+}
+
+/**
+ * Write the totals to a file.
+ * Parameters:
+ * 	path = file name
+ * Returns:
+ * 	1 on success, 0 if the file could not be written
+ */
+int statsDumpFile(const char *path)
+{
+	FILE *out = fopen(path, "w");
+
+	if(out == NULL)
+	{
+		return 0;
+	}
+	statsDump(out);
+	return fclose(out) == 0;
+}
@@ -0,0 +1,131 @@
+/*********************************************************************
+ * File: AD5592Stats.h
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Driver instrumentation counters and latency histograms
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- statsNowNs() is replaced by clockNowNs() from AD5592Clock.h.
+ *
+ * Build with -DAD5592_STATS to count, in the driver:
+ * 	- every command by register, sent or skipped by the shadow,
+ * 	- every transfer, its frames, bytes and time in a log2 histogram,
+ * 	- calls to setAsDAC(), setAsADC(), setAsDigitalIn() and
+ * 		setAsDigitalOut() and how many of them wrote to the board.
+ * Without it the AD5592_STATS_ macros are empty and the driver is
+ * unchanged.
+ *
+ * Each thread counts in its own cache line aligned slot so threads do
+ * not share lines. Counters are updated with relaxed loads and stores,
+ * not read-modify-write. More than AD5592_STATS_SLOTS threads share
+ * slots and may lose a few counts.
+ **********************************************************************/
+
+#ifndef SOURCES_AD5592STATS_H_
+#define SOURCES_AD5592STATS_H_
+
+#include <stdio.h>
+#include <stdatomic.h>
+#include "AD5592RPI.h"
+#include "AD5592Clock.h"
+
+#define AD5592_STATS_SLOTS		16		/* Per thread slots */
+#define AD5592_STATS_BUCKETS	32		/* Latency buckets, bucket n holds 2^n to 2^(n+1) - 1 ns */
+#define AD5592_STATS_COMMANDS	(AD5592_REG_COUNT + 1)	/* Registers then DAC writes */
+
+/**
+ * Pin configuration functions.
+ */
+#define AD5592_STATS_DAC		0	/* setAsDAC() */
+#define AD5592_STATS_ADC		1	/* setAsADC() */
+#define AD5592_STATS_GPIO_IN	2	/* setAsDigitalIn() */
+#define AD5592_STATS_GPIO_OUT	3	/* setAsDigitalOut() */
+#define AD5592_STATS_RECONFIGS	4
+
+/**
+ * Counters of one thread.
+ */
+typedef struct
+{
+	_Alignas(64) atomic_uint_fast64_t sent[AD5592_STATS_COMMANDS];	/* Commands sent by register */
+	atomic_uint_fast64_t skipped[AD5592_STATS_COMMANDS];			/* Commands the shadow skipped */
+	atomic_uint_fast64_t transfers;									/* Transfers */
+	atomic_uint_fast64_t frames;									/* 16 bit frames */
+	atomic_uint_fast64_t bytes;										/* Bytes each way */
+	atomic_uint_fast64_t transferNs;								/* Time in transfers */
+	atomic_uint_fast64_t latency[AD5592_STATS_BUCKETS];				/* Transfer times */
+	atomic_uint_fast64_t reconfigCalls[AD5592_STATS_RECONFIGS];		/* Pin configuration calls */
+	atomic_uint_fast64_t reconfigWrites[AD5592_STATS_RECONFIGS];	/* Calls that wrote */
+} AD5592_StatsSlot;
+
+#ifdef AD5592_STATS
+#define AD5592_STATS_COMMAND(command, sent)		statsCommand((command), (sent))
+#define AD5592_STATS_RECONFIG(kind, sent)		statsReconfig((kind), (sent))
+#define AD5592_STATS_START(start)				uint64_t start = clockNowNs()
+#define AD5592_STATS_TRANSFER(frames, start)	statsTransfer((frames), (start))
+#else
+#define AD5592_STATS_COMMAND(command, sent)		((void)0)
+#define AD5592_STATS_RECONFIG(kind, sent)		((void)(sent))
+#define AD5592_STATS_START(start)
+#define AD5592_STATS_TRANSFER(frames, start)	((void)0)
+#endif
+
+/**
+ * Count a command.
+ * Parameters:
+ * 	command = AD5592 word
+ * 	sent = 1 if it goes to the board, 0 if the shadow skipped it
+ */
+void statsCommand(AD5592_WORD command, int sent);
+
+/**
+ * Count a transfer.
+ * Parameters:
+ * 	frames = number of 16 bit frames
+ * 	startNs = clockNowNs() before the transfer
+ */
+void statsTransfer(int frames, uint64_t startNs);
+
+/**
+ * Count a pin configuration call.
+ * Parameters:
+ * 	kind = AD5592_STATS_DAC, _ADC, _GPIO_IN or _GPIO_OUT
+ * 	sent = 1 if it wrote to the board
+ */
+void statsReconfig(int kind, int sent);
+
+/**
+ * Add up every slot.
+ * Parameters:
+ * 	total = slot to fill with the totals
+ */
+void statsTotal(AD5592_StatsSlot *total);
+
+/**
+ * Zero every slot. Counts made while it runs may be lost.
+ */
+void statsReset(void);
+
+/**
+ * Print the totals.
+ * Parameters:
+ * 	out = stream to print to
+ */
+void statsDump(FILE *out);
+
+/**
+ * Write the totals to a file.
+ * Parameters:
+ * 	path = file name
+ * Returns:
+ * 	1 on success, 0 if the file could not be written
+ */
+int statsDumpFile(const char *path);
+
+#endif /* SOURCES_AD5592STATS_H_ */
@@ -0,0 +1,198 @@
+/***********************************************************************
+ * File: AD5592Stream.c
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Continuous ADC acquisition into a lock free ring buffer
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Stream.h
+ * 		-pthread
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- A block whose transfer failed is published with ok cleared
+ * 			and counted in failed, and the sequence is started again.
+ * 		- streamStart() only takes the ADC pins as set when the shadow
+ * 			is known.
+ **********************************************************************/
+
+#include "AD5592Stream.h"
+#include "AD5592Clock.h"
+
+static char nopFrames[2 * AD5592_STREAM_BLOCK_FRAMES];	/* AD5592_NOP frames to clock results out */
+
+/**
+ * Start the ADC sequence. The frame after the sequence write carries no
+ * result so it is dropped, after that every frame carries one.
+ * Returns:
+ * 	1 on success, 0 if a transfer failed
+ */
+static int streamSequence(AD5592_Stream *stream)
+{
+	char discard[2];
+	uint32_t before = stream->dev->transferErrors;
+
+	/* deviceWrite() does not say if its transfer failed */
+	deviceWrite(stream->dev, AD5592_ADC_READ | AD5592_ADC_SEQ_REP | stream->pins);
+	return deviceTransfer(stream->dev, nopFrames, discard, 1) &&
+		stream->dev->transferErrors == before;
+}
+
+/**
+ * Acquisition thread.
+ */
+static void *streamThread(void *arg)
+{
+	AD5592_Stream *stream = arg;
+	AD5592_StreamBlock *slot;
+	uint64_t block = 0;
+	int started = streamSequence(stream);
+
+	while(atomic_load_explicit(&stream->running, memory_order_relaxed))
+	{
+		/* After a failure the sequencer state is unknown */
+		if(!started)
+		{
+			started = streamSequence(stream);
+		}
+		slot = &stream->slot[block & (AD5592_STREAM_SLOTS - 1)];
+		atomic_store_explicit(&slot->seq, 2 * block + 1, memory_order_relaxed);
+		atomic_thread_fence(memory_order_release);
+
+		slot->block = block;
+		slot->frames = AD5592_STREAM_BLOCK_FRAMES;
+		slot->startNs = clockNowNs();
+		slot->ok = started &&
+			deviceTransfer(stream->dev, nopFrames, slot->rxBuf, AD5592_STREAM_BLOCK_FRAMES);
+		slot->endNs = clockNowNs();
+		if(!slot->ok)
+		{
+			atomic_fetch_add_explicit(&stream->failed, 1, memory_order_relaxed);
+			started = 0;
+		}
+
+		atomic_store_explicit(&slot->seq, 2 * block + 2, memory_order_release);
+		atomic_store_explicit(&stream->published, block + 1, memory_order_release);
+		block++;
+	}
+
+	/* Stop the sequencer */
+	deviceWrite(stream->dev, AD5592_ADC_READ);
+	return NULL;
+}
+
+/**
+ * Configure the pins as ADC inputs and start the acquisition thread.
+ * Parameters:
+ * 	stream = stream to start
+ * 	dev = board to sample
+ * 	pins = pins to sample as bit mask
+ * Returns:
+ * 	1 on success, 0 if the thread could not be started
+ */
+int streamStart(AD5592_Stream *stream, AD5592_Device *dev, uint8_t pins)
+{
+	uint8_t analogInPins = deviceRegister(dev, AD5592_ADC_PIN_SELECT);
+	int i;
+
+	stream->dev = dev;
+	stream->pins = pins;
+	for(i = 0; i < AD5592_STREAM_SLOTS; i++)
+	{
+		atomic_init(&stream->slot[i].seq, 0);
+	}
+	atomic_init(&stream->published, 0);
+	atomic_init(&stream->failed, 0);
+	atomic_init(&stream->running, 1);
+
+	if(!deviceKnown(dev, AD5592_ADC_PIN_SELECT) || (analogInPins & pins) != pins)
+	{
+		deviceWrite(dev, AD5592_ADC_PIN_SELECT | analogInPins | pins);
+	}
+	return pthread_create(&stream->thread, NULL, streamThread, stream) == 0;
+}
+
+/**
+ * Stop the acquisition thread and the ADC sequencer.
+ * Parameters:
+ * 	stream = stream to stop
+ */
+void streamStop(AD5592_Stream *stream)
+{
+	atomic_store_explicit(&stream->running, 0, memory_order_relaxed);
+	pthread_join(stream->thread, NULL);
+}
+
+/**
+ * Start a reader at the next block to be published.
+ * Parameters:
+ * 	stream = stream
+ * 	reader = reader to set up
+ */
+void streamReaderInit(AD5592_Stream *stream, AD5592_StreamReader *reader)
+{
+	reader->next = atomic_load_explicit(&stream->published, memory_order_acquire);
+	reader->lost = 0;
+}
+
+/**
+ * Get the next block for a reader without copying it.
+ * Parameters:
+ * 	stream = stream
+ * 	reader = reader
+ * Returns:
+ * 	Block, or NULL if the reader has every published block
+ */
+const AD5592_StreamBlock *streamPeek(AD5592_Stream *stream, AD5592_StreamReader *reader)
+{
+	AD5592_StreamBlock *slot;
+	uint64_t published;
+
+	for(;;)
+	{
+		published = atomic_load_explicit(&stream->published, memory_order_acquire);
+		if(reader->next >= published)
+		{
+			return NULL;
+		}
+		/* The slot after the newest block may be being written */
+		if(published - reader->next > AD5592_STREAM_SLOTS - 1)
+		{
+			reader->lost += published - (AD5592_STREAM_SLOTS - 1) - reader->next;
+			reader->next = published - (AD5592_STREAM_SLOTS - 1);
+		}
+		slot = &stream->slot[reader->next & (AD5592_STREAM_SLOTS - 1)];
+		if(atomic_load_explicit(&slot->seq, memory_order_acquire) == 2 * reader->next + 2)
+		{
+			return slot;
+		}
+		/* Overwritten since published was read */
+		reader->lost++;
+		reader->next++;
+	}
+}
+
+/**
+ * Finish with the block from streamPeek() and move to the next one.
+ * Parameters:
+ * 	stream = stream
+ * 	reader = reader
+ * Returns:
+ * 	1 if the block was intact while it was used, 0 if it was overwritten
+ */
+int streamRelease(AD5592_Stream *stream, AD5592_StreamReader *reader)
+{
+	AD5592_StreamBlock *slot = &stream->slot[reader->next & (AD5592_STREAM_SLOTS - 1)];
+	uint64_t block = reader->next++;
+
+	atomic_thread_fence(memory_order_acquire);
+	if(atomic_load_explicit(&slot->seq, memory_order_relaxed) != 2 * block + 2)
+	{
+		reader->lost++;
+		return 0;
+	}
+	return 1;
+}
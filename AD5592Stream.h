@@ -0,0 +1,138 @@
+/*********************************************************************
+ * File: AD5592Stream.h
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Continuous ADC acquisition into a lock free ring buffer
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-pthread
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- Blocks have an ok flag, cleared when their transfer failed.
+ *
+ * An acquisition thread leaves the ADC sequencer running in repeat mode
+ * and clocks out blocks of conversion results. Each block is received
+ * straight into a slot of a preallocated ring and stamped with the
+ * time of its transfer. Every frame of a block is a conversion result,
+ * in sequence order, unless the block's ok flag is clear. Then the
+ * transfer failed, rxBuf holds no results and the block must be
+ * skipped. The block is still published so block numbers and times
+ * stay continuous, and the sequence is started again for the next one.
+ *
+ * There is one producer and any number of readers. Every reader sees
+ * every block. Readers use the block in place, with no copies and no
+ * locks. Each slot has a sequence number that is odd while the slot is
+ * written and 2 x (block number + 1) once it is published.
+ * streamRelease() checks that the number did not change while the block
+ * was in use. A reader that falls more than AD5592_STREAM_SLOTS blocks
+ * behind loses blocks and is moved up to the oldest one still held.
+ *
+ * The acquisition thread owns the board from streamStart() to
+ * streamStop(). Nothing else may use the board or its chip select in
+ * that time.
+ **********************************************************************/
+
+#ifndef SOURCES_AD5592STREAM_H_
+#define SOURCES_AD5592STREAM_H_
+
+#include <stdatomic.h>
+#include <pthread.h>
+#include "AD5592RPI.h"
+
+#define AD5592_STREAM_BLOCK_FRAMES	64		/* Conversion results per block */
+#define AD5592_STREAM_SLOTS			64		/* Blocks in the ring, a power of 2 */
+
+_Static_assert((AD5592_STREAM_SLOTS & (AD5592_STREAM_SLOTS - 1)) == 0,
+	"AD5592_STREAM_SLOTS must be a power of 2");
+
+/**
+ * One block of conversion results.
+ */
+typedef struct
+{
+	atomic_uint_fast64_t seq;					/* Odd while written, 2 x (block + 1) when published */
+	uint64_t block;								/* Block number */
+	uint64_t startNs;							/* CLOCK_MONOTONIC at the start of the transfer */
+	uint64_t endNs;								/* CLOCK_MONOTONIC at the end of the transfer */
+	int frames;									/* Frames in the block */
+	int ok;										/* 0 if the transfer failed and rxBuf holds no results */
+	char rxBuf[2 * AD5592_STREAM_BLOCK_FRAMES];	/* Results, MSB first */
+} AD5592_StreamBlock;
+
+/**
+ * A stream.
+ */
+typedef struct
+{
+	AD5592_Device *dev;							/* Board being sampled */
+	uint8_t pins;								/* Pins in the sequence */
+	AD5592_StreamBlock slot[AD5592_STREAM_SLOTS];	/* Ring */
+	atomic_uint_fast64_t published;				/* Blocks published */
+	atomic_uint_fast64_t failed;				/* Blocks published with ok clear */
+	atomic_int running;							/* Cleared to stop the thread */
+	pthread_t thread;							/* Acquisition thread */
+} AD5592_Stream;
+
+/**
+ * Read position of one reader.
+ */
+typedef struct
+{
+	uint64_t next;			/* Next block to read */
+	uint64_t lost;			/* Blocks overwritten before they were read */
+} AD5592_StreamReader;
+
+/**
+ * Configure the pins as ADC inputs and start the acquisition thread.
+ * Parameters:
+ * 	stream = stream to start
+ * 	dev = board to sample
+ * 	pins = pins to sample as bit mask
+ * Returns:
+ * 	1 on success, 0 if the thread could not be started
+ */
+int streamStart(AD5592_Stream *stream, AD5592_Device *dev, uint8_t pins);
+
+/**
+ * Stop the acquisition thread and the ADC sequencer. Blocks already
+ * published stay readable.
+ * Parameters:
+ * 	stream = stream to stop
+ */
+void streamStop(AD5592_Stream *stream);
+
+/**
+ * Start a reader at the next block to be published.
+ * Parameters:
+ * 	stream = stream
+ * 	reader = reader to set up
+ */
+void streamReaderInit(AD5592_Stream *stream, AD5592_StreamReader *reader);
+
+/**
+ * Get the next block for a reader without copying it. Call
+ * streamRelease() when done with it.
+ * Parameters:
+ * 	stream = stream
+ * 	reader = reader
+ * Returns:
+ * 	Block, or NULL if the reader has every published block
+ */
+const AD5592_StreamBlock *streamPeek(AD5592_Stream *stream, AD5592_StreamReader *reader);
+
+/**
+ * Finish with the block from streamPeek() and move to the next one.
+ * Parameters:
+ * 	stream = stream
+ * 	reader = reader
+ * Returns:
+ * 	1 if the block was intact while it was used, 0 if the producer
+ * 	overwrote it and what was read must be dropped
+ */
+int streamRelease(AD5592_Stream *stream, AD5592_StreamReader *reader);
+
+#endif /* SOURCES_AD5592STREAM_H_ */
@@ -0,0 +1,316 @@
+/**
+ * File: AD5592StreamBench.c
+ * Target: Raspberry Pi or any Linux host
+ * Function: Throughput and failure handling of an AD5592_Stream
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Stream.h v1.0.1
+ * 		-AD5592Decode.h v1.0.0
+ * 		-AD5592Sim.h v1.2.1
+ * 		-AD5592Clock.h v1.0.0
+ * 		-pthread
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version: 1.0.0:
+ * 		-Usage: AD5592StreamBench [-r readers] [-m ms] [-f us per frame]
+ * 			[-e fail every nth transfer] [-s us per block]
+ *
+ * 		-Streams pins 0 to 3 of a simulated board for -m ms (1000 by
+ * 		default) to -r reader threads (2 by default). The simulator sits
+ * 		behind a transport that sleeps -f us a frame (16 by default)
+ * 		like a real SPI bus at about 1 MHz. With -e every nth transfer
+ * 		fails without reaching the board. Readers spend -s us on each
+ * 		block (0 by default), more than the time a block takes on the
+ * 		bus makes them fall behind and lose blocks.
+ *
+ * 		-Prints one line for the stream:
+ * 			blocks failed injected seconds blocks_per_sec samples_per_sec
+ * 		and one line per reader:
+ * 			reader blocks failed lost torn bad
+ * 		failed counts blocks published with their ok flag clear and
+ * 		injected the transfers made to fail. lost counts blocks the
+ * 		reader missed and torn the part of them overwritten while the
+ * 		reader used them, so blocks + lost is every block. bad counts
+ * 		blocks with their ok flag set whose samples are not the voltages
+ * 		applied to the simulated pins. Exits with 1 if any block is bad
+ * 		or, with no -e, if any block failed.
+ *
+ * 		-Builds on a Linux host with:
+ * 			gcc -O2 -DAD5592_NO_BCM2835 -o AD5592StreamBench \
+ * 				AD5592StreamBench.c AD5592Stream.c AD5592Decode.c \
+ * 				AD5592RPI.c AD5592Batch.c AD5592Timing.c \
+ * 				AD5592Transport.c AD5592Sim.c -lpthread
+ * 		-fsanitize=thread reports races on the slots whatever the
+ * 		options. Nothing orders a reader's use of a slot before the
+ * 		acquisition thread writes it again, by design, and torn reads
+ * 		are caught by the sequence number instead, in the torn column.
+ *
+ **********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "AD5592RPI.h"
+#include "AD5592Stream.h"
+#include "AD5592Decode.h"
+#include "AD5592Sim.h"
+#include "AD5592Clock.h"
+
+#define BENCH_READERS		8		/* Most readers */
+#define BENCH_PINS			0x0F	/* Pins streamed */
+
+/**
+ * Counts of one reader.
+ */
+typedef struct
+{
+	pthread_t thread;
+	AD5592_StreamReader reader;
+	uint64_t blocks;		/* Blocks read */
+	uint64_t failed;		/* Blocks with their ok flag clear */
+	uint64_t torn;			/* Blocks overwritten while in use */
+	uint64_t bad;			/* Blocks with wrong samples */
+} BenchReader;
+
+AD5592_Sim sim;
+AD5592_Transport simBus;			/* Simulator transport */
+AD5592_Transport slowBus;			/* Slowed down transport the stream uses */
+AD5592_Device dev;
+AD5592_Stream stream;
+BenchReader readers[BENCH_READERS];
+atomic_int done;					/* Set once the stream has stopped */
+long frameNs = 16000;				/* Time a frame takes on the bus */
+long blockNs = 0;					/* Time a reader spends on a block */
+uint32_t failEvery = 0;				/* Every nth transfer fails, 0 for none */
+uint32_t transfers = 0;				/* Transfers since failures were armed */
+uint32_t injected = 0;				/* Transfers made to fail */
+int armed = 0;						/* Set once the board is set up */
+
+/**
+ * Voltage applied to a pin of the simulated board.
+ */
+static uint16_t benchMilivolts(int pin)
+{
+	return 1000 + pin * 100;
+}
+
+/**
+ * Sleep for a number of nanoseconds.
+ */
+static void benchSleep(long ns)
+{
+	struct timespec wait = {ns / 1000000000, ns % 1000000000};
+
+	nanosleep(&wait, NULL);
+}
+
+/**
+ * Transfer on the simulator, then sleep for the time the frames would
+ * take on a real bus. Every failEvery-th transfer fails instead. Only
+ * the acquisition thread transfers once the stream has started.
+ */
+static int slowTransfer(AD5592_Transport *bus, uint8_t cs, const char txBuf[],
+	char rxBuf[], int frames)
+{
+	AD5592_Transport *inner = bus->context;
+	int ok;
+
+	if(armed && failEvery && ++transfers % failEvery == 0)
+	{
+		injected++;
+		return 0;
+	}
+	ok = transportTransfer(inner, cs, txBuf, rxBuf, frames);
+	benchSleep(frames * frameNs);
+	return ok;
+}
+
+/**
+ * Check the samples of a block.
+ * Returns:
+ * 	1 if every frame is a result for a streamed pin at its voltage
+ */
+static int benchCheck(const AD5592_StreamBlock *block)
+{
+	uint16_t samples[8][AD5592_STREAM_BLOCK_FRAMES];
+	uint16_t *channel[8];
+	int count[8];
+	int stored;
+	int pin;
+	int i;
+
+	for(pin = 0; pin < 8; pin++)
+	{
+		channel[pin] = samples[pin];
+		count[pin] = 0;
+	}
+	stored = decodeAdcFrames(block->rxBuf, block->frames, channel, count,
+		AD5592_STREAM_BLOCK_FRAMES);
+	if(stored != block->frames)
+	{
+		return 0;
+	}
+	for(pin = 0; pin < 8; pin++)
+	{
+		if(count[pin] && !(BENCH_PINS & (1 << pin)))
+		{
+			return 0;
+		}
+		for(i = 0; i < count[pin]; i++)
+		{
+			if(abs((int)samples[pin][i] - benchMilivolts(pin)) > 2)
+			{
+				return 0;
+			}
+		}
+	}
+	return 1;
+}
+
+/**
+ * Reader thread. Reads blocks until the stream has stopped and every
+ * block left in the ring is read.
+ */
+static void *benchReader(void *arg)
+{
+	BenchReader *bench = arg;
+	const AD5592_StreamBlock *block;
+	int ok;
+	int good;
+
+	for(;;)
+	{
+		block = streamPeek(&stream, &bench->reader);
+		if(!block)
+		{
+			if(atomic_load(&done) && !streamPeek(&stream, &bench->reader))
+			{
+				break;
+			}
+			usleep(50);
+			continue;
+		}
+		ok = block->ok;
+		good = !ok || benchCheck(block);
+		if(blockNs)
+		{
+			benchSleep(blockNs);
+		}
+		/* What was read only counts if the block was not overwritten */
+		if(!streamRelease(&stream, &bench->reader))
+		{
+			bench->torn++;
+			continue;
+		}
+		bench->blocks++;
+		bench->failed += !ok;
+		bench->bad += !good;
+	}
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	int readerCount = 2;
+	long ms = 1000;
+	uint64_t published;
+	uint64_t failed;
+	uint64_t start;
+	double seconds;
+	int bad = 0;
+	int option;
+	int i;
+
+	while((option = getopt(argc, argv, "r:m:f:e:s:")) != -1)
+	{
+		switch(option)
+		{
+			case 'r':
+				readerCount = atoi(optarg);
+				break;
+			case 'm':
+				ms = atol(optarg);
+				break;
+			case 'f':
+				frameNs = atol(optarg) * 1000;
+				break;
+			case 'e':
+				failEvery = atoi(optarg);
+				break;
+			case 's':
+				blockNs = atol(optarg) * 1000;
+				break;
+			default:
+				readerCount = 0;
+				break;
+		}
+	}
+	if(readerCount < 1 || readerCount > BENCH_READERS || ms < 1 || frameNs < 0 ||
+		blockNs < 0 || failEvery == 1)
+	{
+		printf("Usage: %s [-r readers, 1 to %d] [-m ms] [-f us per frame]"
+			" [-e fail every nth transfer, 2 or more] [-s us per block]\n",
+			argv[0], BENCH_READERS);
+		return 1;
+	}
+
+	simInit(&sim, 0);
+	for(i = 0; i < 8; i++)
+	{
+		simSetInput(&sim, 0, i, benchMilivolts(i));
+	}
+	simTransportInit(&simBus, &sim);
+	memset(&slowBus, 0, sizeof(slowBus));
+	slowBus.transfer = slowTransfer;
+	slowBus.context = &simBus;
+	deviceInit(&dev, &slowBus, 0);
+	deviceSetPinMode(&dev, BENCH_PINS, AD5592_MODE_ADC);
+
+	/* The stream has nothing left to set up, so only its own transfers fail */
+	armed = 1;
+	atomic_init(&done, 0);
+	start = clockNowNs();
+	if(!streamStart(&stream, &dev, BENCH_PINS))
+	{
+		printf("Could not start the stream\n");
+		return 1;
+	}
+	for(i = 0; i < readerCount; i++)
+	{
+		streamReaderInit(&stream, &readers[i].reader);
+		if(pthread_create(&readers[i].thread, NULL, benchReader, &readers[i]) != 0)
+		{
+			printf("Could not start reader %d\n", i);
+			return 1;
+		}
+	}
+	benchSleep(ms * 1000000);
+	streamStop(&stream);
+	seconds = (clockNowNs() - start) / 1e9;
+	atomic_store(&done, 1);
+	for(i = 0; i < readerCount; i++)
+	{
+		pthread_join(readers[i].thread, NULL);
+	}
+
+	published = atomic_load(&stream.published);
+	failed = atomic_load(&stream.failed);
+	printf("blocks failed injected seconds blocks_per_sec samples_per_sec\n");
+	printf("%llu %llu %u %.3f %.0f %.0f\n", (unsigned long long)published,
+		(unsigned long long)failed, injected, seconds, published / seconds,
+		(published - failed) * AD5592_STREAM_BLOCK_FRAMES / seconds);
+	printf("reader blocks failed lost torn bad\n");
+	for(i = 0; i < readerCount; i++)
+	{
+		printf("%d %llu %llu %llu %llu %llu\n", i, (unsigned long long)readers[i].blocks,
+			(unsigned long long)readers[i].failed, (unsigned long long)readers[i].reader.lost,
+			(unsigned long long)readers[i].torn, (unsigned long long)readers[i].bad);
+		bad += readers[i].bad != 0;
+	}
+	return bad || (!failEvery && failed) ? 1 : 0;
+}
@@ -0,0 +1,103 @@
+/***********************************************************************
+ * File: AD5592Timing.c
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Microsecond waits and settling detection for the AD5592
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Batch.h v1.1.0
+ * 		-AD5592Timing.h
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- timingNowNs() is replaced by clockNowNs() from AD5592Clock.h.
+ **********************************************************************/
+
+#include <time.h>
+#include "AD5592Batch.h"
+#include "AD5592Timing.h"
+
+/**
+ * Wait for a number of microseconds.
+ * Parameters:
+ * 	us = microseconds
+ */
+void timingWaitUs(uint32_t us)
+{
+	uint64_t deadline = clockNowNs() + (uint64_t)us * 1000;
+	struct timespec wait;
+
+	if(us > AD5592_TIMING_SPIN_US)
+	{
+		us -= AD5592_TIMING_SPIN_US;
+		wait.tv_sec = us / 1000000;
+		wait.tv_nsec = (us % 1000000) * 1000L;
+		nanosleep(&wait, NULL);
+	}
+	while(clockNowNs() < deadline)
+	{
+	}
+}
+
+/**
+ * Scan ADC pins until every pin is stable.
+ * Parameters:
+ * 	dev = board to read, the pins must be ADC inputs
+ * 	pins = pins as bit mask
+ * 	counts[] = 8 entry array for the last scan indexed by pin number
+ * 	window = largest change in counts between two scans of a stable pin
+ * 	timeoutUs = give up after this long
+ * 	stats = record to update, may be NULL
+ * Returns:
+ * 	1 if the pins settled, 0 on timeout
+ */
+int timingSettleAdc(AD5592_Device *dev, uint8_t pins, uint16_t counts[],
+	uint16_t window, uint32_t timeoutUs, AD5592_SettleStats *stats)
+{
+	uint64_t start = clockNowNs();
+	uint64_t elapsed;
+	uint16_t last[8];
+	uint32_t scans = 1;
+	int stable = 0;
+	int pin;
+
+	batchScanAdc(dev, pins, counts);
+	do
+	{
+		for(pin = 0; pin < 8; pin++)
+		{
+			last[pin] = counts[pin];
+		}
+		batchScanAdc(dev, pins, counts);
+		scans++;
+
+		stable = 1;
+		for(pin = 0; pin < 8; pin++)
+		{
+			if(((pins >> pin) & 0x1) &&
+				(counts[pin] > last[pin] + window || last[pin] > counts[pin] + window))
+			{
+				stable = 0;
+				break;
+			}
+		}
+		elapsed = (clockNowNs() - start) / 1000;
+	}while(!stable && elapsed < timeoutUs);
+
+	if(stats)
+	{
+		stats->count++;
+		stats->timeouts += !stable;
+		stats->scans += scans;
+		stats->lastUs = elapsed;
+		stats->totalUs += elapsed;
+		if(elapsed > stats->maxUs)
+		{
+			stats->maxUs = elapsed;
+		}
+	}
+	return stable;
+}
@@ -0,0 +1,77 @@
+/*********************************************************************
+ * File: AD5592Timing.h
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Microsecond waits and settling detection for the AD5592
+ * Dependancies:
+ * 		-AD5592RPI.h v1.1.0
+ * 		-AD5592Batch.h v1.1.0
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- timingNowNs() is replaced by clockNowNs() from AD5592Clock.h.
+ *
+ * timingWaitUs() sleeps for all but the last AD5592_TIMING_SPIN_US of
+ * a wait and spins on CLOCK_MONOTONIC for the rest, so short waits are
+ * not rounded up to the scheduler tick.
+ *
+ * timingSettleAdc() is for signals that take an unknown time to settle,
+ * for example through an RC filter. It scans the ADC pins until two
+ * scans in a row agree within a window on every pin and records how
+ * long that took.
+ **********************************************************************/
+
+#ifndef SOURCES_AD5592TIMING_H_
+#define SOURCES_AD5592TIMING_H_
+
+#include "AD5592RPI.h"
+#include "AD5592Clock.h"
+
+/**
+ * Datasheet minimums, in microseconds.
+ */
+#define AD5592_SETTLE_DAC_US		8		/* DAC output, 6us typical to 1/2 LSB */
+#define AD5592_SETTLE_MODE_US		10		/* Pin mode change */
+#define AD5592_SETTLE_RESET_US		250		/* Software reset */
+
+#define AD5592_TIMING_SPIN_US		100		/* Spin for the last part of a wait */
+
+/**
+ * Settling record kept by timingSettleAdc().
+ */
+typedef struct
+{
+	uint32_t count;			/* Settling waits */
+	uint32_t timeouts;		/* Waits that ran out of time */
+	uint32_t scans;			/* ADC scans in all waits */
+	uint32_t lastUs;		/* Length of the last wait */
+	uint32_t maxUs;			/* Longest wait */
+	uint64_t totalUs;		/* All waits */
+} AD5592_SettleStats;
+
+/**
+ * Wait for a number of microseconds.
+ * Parameters:
+ * 	us = microseconds
+ */
+void timingWaitUs(uint32_t us);
+
+/**
+ * Scan ADC pins until every pin is stable.
+ * Parameters:
+ * 	dev = board to read, the pins must be ADC inputs
+ * 	pins = pins as bit mask
+ * 	counts[] = 8 entry array for the last scan indexed by pin number
+ * 	window = largest change in counts between two scans of a stable pin
+ * 	timeoutUs = give up after this long
+ * 	stats = record to update, may be NULL
+ * Returns:
+ * 	1 if the pins settled, 0 on timeout
+ */
+int timingSettleAdc(AD5592_Device *dev, uint8_t pins, uint16_t counts[],
+	uint16_t window, uint32_t timeoutUs, AD5592_SettleStats *stats);
+
+#endif /* SOURCES_AD5592TIMING_H_ */
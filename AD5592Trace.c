@@ -0,0 +1,330 @@
+/***********************************************************************
+ * File: AD5592Trace.c
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Records SPI traffic to a trace file and plays it back
+ * Dependancies:
+ * 		-AD5592Transport.h v1.0.0
+ * 		-AD5592Trace.h
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ **********************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "AD5592Trace.h"
+#include "AD5592Clock.h"
+
+#define TRACE_BUFFER	65536		/* stdio buffer for the trace file */
+
+static const uint8_t tracePadding[AD5592_TRACE_ALIGN];	/* Zeros to pad records with */
+
+/**
+ * Create a trace, replacing any file of the same name.
+ * Parameters:
+ * 	trace = trace to set up
+ * 	path = file name
+ * 	title = title stored in the header
+ * Returns:
+ * 	1 on success, 0 if the file could not be written
+ */
+int traceOpen(AD5592_Trace *trace, const char *path, const char *title)
+{
+	AD5592_TraceHeader header;
+
+	memset(trace, 0, sizeof(*trace));
+	trace->file = fopen(path, "wb");
+	if(trace->file == NULL)
+	{
+		return 0;
+	}
+	setvbuf(trace->file, NULL, _IOFBF, TRACE_BUFFER);
+	trace->startNs = clockNowNs();
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, AD5592_TRACE_MAGIC, sizeof(header.magic));
+	header.version = AD5592_TRACE_VERSION;
+	header.byteOrder = AD5592_TRACE_BYTE_ORDER;
+	header.startNs = trace->startNs;
+	header.startSec = time(NULL);
+	strncpy(header.title, title, AD5592_TRACE_TITLE - 1);
+	return fwrite(&header, sizeof(header), 1, trace->file) == 1;
+}
+
+/**
+ * Write out and close a trace.
+ * Parameters:
+ * 	trace = trace
+ * Returns:
+ * 	1 on success, 0 if any transfer could not be recorded
+ */
+int traceClose(AD5592_Trace *trace)
+{
+	int ok = !ferror(trace->file) && trace->lost == 0;
+
+	ok = fclose(trace->file) == 0 && ok;
+	trace->file = NULL;
+	free(trace->txCopy);
+	trace->txCopy = NULL;
+	trace->txCopySize = 0;
+	return ok;
+}
+
+/**
+ * Write one record, its frames and its padding.
+ */
+static void traceRecord(AD5592_Trace *trace, const AD5592_TraceRecord *record,
+	const char txBuf[], const char rxBuf[])
+{
+	size_t bytes = 2 * record->frames;
+	size_t pad = (AD5592_TRACE_ALIGN - (2 * bytes) % AD5592_TRACE_ALIGN) % AD5592_TRACE_ALIGN;
+
+	fwrite(record, sizeof(*record), 1, trace->file);
+	fwrite(txBuf, 1, bytes, trace->file);
+	fwrite(rxBuf, 1, bytes, trace->file);
+	fwrite(tracePadding, 1, pad, trace->file);
+	trace->records++;
+	trace->frames += record->frames;
+}
+
+/**
+ * Recording transfer. The frames sent are copied first because the
+ * transport may receive into the same buffer.
+ */
+static int traceTransfer(AD5592_Transport *bus, uint8_t cs, const char txBuf[],
+	char rxBuf[], int frames)
+{
+	AD5592_Trace *trace = bus->context;
+	AD5592_TraceRecord record;
+	size_t bytes = 2 * frames;
+	uint64_t start;
+	uint64_t end;
+	char *copy;
+	int ok;
+	int done;
+	int count;
+
+	if(bytes > trace->txCopySize)
+	{
+		copy = realloc(trace->txCopy, bytes);
+		if(copy == NULL)
+		{
+			trace->lost++;
+			return transportTransfer(trace->inner, cs, txBuf, rxBuf, frames);
+		}
+		trace->txCopy = copy;
+		trace->txCopySize = bytes;
+	}
+	memcpy(trace->txCopy, txBuf, bytes);
+
+	start = clockNowNs();
+	ok = transportTransfer(trace->inner, cs, txBuf, rxBuf, frames);
+	end = clockNowNs();
+
+	record.timeNs = start - trace->startNs;
+	record.spanNs = end - start;
+	record.cs = cs;
+	record.ok = ok != 0;
+	for(done = 0; done < frames; done += count)
+	{
+		count = frames - done;
+		if(count > AD5592_TRACE_MAX_FRAMES)
+		{
+			count = AD5592_TRACE_MAX_FRAMES;
+		}
+		record.frames = count;
+		traceRecord(trace, &record, &trace->txCopy[2 * done], &rxBuf[2 * done]);
+	}
+	return ok;
+}
+
+/**
+ * Set up a transport that records every transfer to a trace and passes
+ * it on.
+ * Parameters:
+ * 	bus = transport to set up
+ * 	trace = open trace
+ * 	inner = transport that moves the frames
+ */
+void traceTransportInit(AD5592_Transport *bus, AD5592_Trace *trace, AD5592_Transport *inner)
+{
+	memset(bus, 0, sizeof(*bus));
+	bus->transfer = traceTransfer;
+	bus->context = trace;
+	trace->inner = inner;
+}
+
+/**
+ * Map a trace for reading.
+ * Parameters:
+ * 	view = view to set up
+ * 	path = file name
+ * Returns:
+ * 	1 on success, 0 if the file is not a trace this host can read
+ */
+int traceMap(AD5592_TraceView *view, const char *path)
+{
+	struct stat info;
+	void *base;
+	int fd = open(path, O_RDONLY);
+
+	view->base = NULL;
+	if(fd < 0)
+	{
+		return 0;
+	}
+	if(fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(AD5592_TraceHeader))
+	{
+		close(fd);
+		return 0;
+	}
+	base = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(base == MAP_FAILED)
+	{
+		return 0;
+	}
+	view->base = base;
+	view->size = info.st_size;
+	view->pos = sizeof(AD5592_TraceHeader);
+	view->header = base;
+
+	if(memcmp(view->header->magic, AD5592_TRACE_MAGIC, sizeof(view->header->magic)) != 0 ||
+		view->header->version != AD5592_TRACE_VERSION ||
+		view->header->byteOrder != AD5592_TRACE_BYTE_ORDER)
+	{
+		traceUnmap(view);
+		return 0;
+	}
+	return 1;
+}
+
+/**
+ * Get the next record of a mapped trace.
+ * Parameters:
+ * 	view = view
+ * Returns:
+ * 	Record, or NULL at the end or at a record cut short
+ */
+const AD5592_TraceRecord *traceNext(AD5592_TraceView *view)
+{
+	const AD5592_TraceRecord *record = (const AD5592_TraceRecord *)(view->base + view->pos);
+	size_t length;
+
+	if(view->pos + sizeof(*record) > view->size)
+	{
+		return NULL;
+	}
+	length = sizeof(*record) + 4 * (size_t)record->frames;
+	if(view->pos + length > view->size)
+	{
+		return NULL;
+	}
+	view->pos += (length + AD5592_TRACE_ALIGN - 1) & ~(size_t)(AD5592_TRACE_ALIGN - 1);
+	return record;
+}
+
+/**
+ * Get the frames a record sent.
+ * Parameters:
+ * 	record = record
+ * Returns:
+ * 	Frames, most significant byte first
+ */
+const uint8_t *traceTx(const AD5592_TraceRecord *record)
+{
+	return (const uint8_t *)(record + 1);
+}
+
+/**
+ * Get the frames a record received.
+ * Parameters:
+ * 	record = record
+ * Returns:
+ * 	Frames, most significant byte first
+ */
+const uint8_t *traceRx(const AD5592_TraceRecord *record)
+{
+	return (const uint8_t *)(record + 1) + 2 * record->frames;
+}
+
+/**
+ * Unmap a trace.
+ * Parameters:
+ * 	view = view
+ */
+void traceUnmap(AD5592_TraceView *view)
+{
+	if(view->base)
+	{
+		munmap((void *)view->base, view->size);
+		view->base = NULL;
+	}
+}
+
+/**
+ * Playback transfer. Frames are matched one by one so the driver may
+ * split or join transfers differently from the run that was recorded.
+ * After the end of the trace the transfer fails and receives zeros.
+ */
+static int playbackTransfer(AD5592_Transport *bus, uint8_t cs, const char txBuf[],
+	char rxBuf[], int frames)
+{
+	AD5592_TracePlayback *playback = bus->context;
+	const uint8_t *tx;
+	const uint8_t *rx;
+	int i;
+
+	for(i = 0; i < frames; i++)
+	{
+		while(playback->record == NULL || playback->frame >= playback->record->frames)
+		{
+			playback->record = traceNext(&playback->view);
+			playback->frame = 0;
+			if(playback->record == NULL)
+			{
+				memset(&rxBuf[2 * i], 0, 2 * (frames - i));
+				playback->overruns += frames - i;
+				return 0;
+			}
+		}
+		tx = traceTx(playback->record) + 2 * playback->frame;
+		rx = traceRx(playback->record) + 2 * playback->frame;
+		if(playback->record->cs != cs || tx[0] != (uint8_t)txBuf[2 * i] ||
+			tx[1] != (uint8_t)txBuf[2 * i + 1])
+		{
+			playback->mismatches++;
+		}
+		rxBuf[2 * i] = rx[0];
+		rxBuf[2 * i + 1] = rx[1];
+		playback->frame++;
+		playback->frames++;
+	}
+	return 1;
+}
+
+/**
+ * Set up a transport that answers with the frames of a trace.
+ * Parameters:
+ * 	bus = transport to set up
+ * 	playback = playback state, its view mapped with traceMap()
+ */
+void tracePlaybackInit(AD5592_Transport *bus, AD5592_TracePlayback *playback)
+{
+	memset(bus, 0, sizeof(*bus));
+	bus->transfer = playbackTransfer;
+	bus->context = playback;
+	playback->record = NULL;
+	playback->frame = 0;
+	playback->frames = 0;
+	playback->mismatches = 0;
+	playback->overruns = 0;
+}
@@ -0,0 +1,198 @@
+/*********************************************************************
+ * File: AD5592Trace.h
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: Records SPI traffic to a trace file and plays it back
+ * Dependancies:
+ * 		-AD5592Transport.h v1.0.0
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release.
+ *
+ * A trace is an AD5592_TraceHeader followed by one record per transfer,
+ * each an AD5592_TraceRecord, the frames sent and the frames received,
+ * padded to 8 bytes. Frames are stored as they were on the wire, most
+ * significant byte first. Other numbers are in the byte order of the
+ * host that wrote the trace; byteOrder tells a reader which it is.
+ * Transfers of more than AD5592_TRACE_MAX_FRAMES frames are recorded as
+ * several records.
+ *
+ * The recording transport wraps another transport and writes every
+ * transfer that goes through it. The playback transport answers the
+ * driver with the frames a trace received and counts the frames the
+ * driver sends that differ from the trace, so a recorded run can be
+ * repeated without the boards.
+ *
+ * AD5592Replay sends a trace through a transport, checks the answers
+ * and works out what other batching would have saved.
+ **********************************************************************/
+
+#ifndef SOURCES_AD5592TRACE_H_
+#define SOURCES_AD5592TRACE_H_
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "AD5592Transport.h"
+
+#define AD5592_TRACE_MAGIC			"AD5592T"	/* 8 bytes with the terminator */
+#define AD5592_TRACE_VERSION		1
+#define AD5592_TRACE_BYTE_ORDER		0x0102
+#define AD5592_TRACE_ALIGN			8			/* Record alignment */
+#define AD5592_TRACE_MAX_FRAMES		0xFFFF		/* Frames in one record */
+#define AD5592_TRACE_TITLE			32			/* Longest trace title */
+
+/**
+ * Start of a trace.
+ */
+typedef struct
+{
+	char magic[8];						/* AD5592_TRACE_MAGIC */
+	uint16_t version;					/* AD5592_TRACE_VERSION */
+	uint16_t byteOrder;					/* AD5592_TRACE_BYTE_ORDER as written */
+	uint32_t reserved;
+	uint64_t startNs;					/* CLOCK_MONOTONIC at traceOpen(), record times count from here */
+	int64_t startSec;					/* Wall clock at traceOpen(), seconds since 1970 */
+	char title[AD5592_TRACE_TITLE];		/* Terminated title */
+} AD5592_TraceHeader;
+
+/**
+ * Start of a record. The frames sent and then the frames received
+ * follow it.
+ */
+typedef struct
+{
+	uint64_t timeNs;		/* Start of the transfer, nanoseconds after startNs */
+	uint32_t spanNs;		/* Length of the transfer */
+	uint16_t frames;		/* 16 bit frames each way */
+	uint8_t cs;				/* Chip select */
+	uint8_t ok;				/* 1 if the transport reported success */
+} AD5592_TraceRecord;
+
+_Static_assert(sizeof(AD5592_TraceHeader) == 64, "trace header layout");
+_Static_assert(sizeof(AD5592_TraceRecord) == 16, "trace record layout");
+
+/**
+ * A trace being recorded.
+ */
+typedef struct
+{
+	FILE *file;						/* Trace file */
+	AD5592_Transport *inner;		/* Transport being recorded */
+	uint64_t startNs;				/* CLOCK_MONOTONIC at traceOpen() */
+	uint32_t records;				/* Records written */
+	uint64_t frames;				/* Frames recorded */
+	uint32_t lost;					/* Transfers that could not be recorded */
+	char *txCopy;					/* Frames sent, kept in case the transport overwrites them */
+	size_t txCopySize;				/* Bytes in txCopy */
+} AD5592_Trace;
+
+/**
+ * A trace mapped for reading.
+ */
+typedef struct
+{
+	const uint8_t *base;				/* Mapped file */
+	size_t size;						/* File size */
+	size_t pos;							/* Offset of the next record */
+	const AD5592_TraceHeader *header;	/* Header */
+} AD5592_TraceView;
+
+/**
+ * A trace being played back.
+ */
+typedef struct
+{
+	AD5592_TraceView view;			/* Trace, mapped with traceMap() */
+	const AD5592_TraceRecord *record;	/* Record being played */
+	int frame;						/* Next frame of that record */
+	uint32_t frames;				/* Frames played */
+	uint32_t mismatches;			/* Frames sent that differ from the trace */
+	uint32_t overruns;				/* Frames asked for after the end of the trace */
+} AD5592_TracePlayback;
+
+/**
+ * Create a trace, replacing any file of the same name.
+ * Parameters:
+ * 	trace = trace to set up
+ * 	path = file name
+ * 	title = title stored in the header
+ * Returns:
+ * 	1 on success, 0 if the file could not be written
+ */
+int traceOpen(AD5592_Trace *trace, const char *path, const char *title);
+
+/**
+ * Write out and close a trace.
+ * Parameters:
+ * 	trace = trace
+ * Returns:
+ * 	1 on success, 0 if any transfer could not be recorded
+ */
+int traceClose(AD5592_Trace *trace);
+
+/**
+ * Set up a transport that records every transfer to a trace and passes
+ * it on.
+ * Parameters:
+ * 	bus = transport to set up
+ * 	trace = open trace
+ * 	inner = transport that moves the frames
+ */
+void traceTransportInit(AD5592_Transport *bus, AD5592_Trace *trace, AD5592_Transport *inner);
+
+/**
+ * Map a trace for reading.
+ * Parameters:
+ * 	view = view to set up
+ * 	path = file name
+ * Returns:
+ * 	1 on success, 0 if the file is not a trace this host can read
+ */
+int traceMap(AD5592_TraceView *view, const char *path);
+
+/**
+ * Get the next record of a mapped trace.
+ * Parameters:
+ * 	view = view
+ * Returns:
+ * 	Record, or NULL at the end or at a record cut short
+ */
+const AD5592_TraceRecord *traceNext(AD5592_TraceView *view);
+
+/**
+ * Get the frames a record sent.
+ * Parameters:
+ * 	record = record
+ * Returns:
+ * 	Frames, most significant byte first
+ */
+const uint8_t *traceTx(const AD5592_TraceRecord *record);
+
+/**
+ * Get the frames a record received.
+ * Parameters:
+ * 	record = record
+ * Returns:
+ * 	Frames, most significant byte first
+ */
+const uint8_t *traceRx(const AD5592_TraceRecord *record);
+
+/**
+ * Unmap a trace.
+ * Parameters:
+ * 	view = view
+ */
+void traceUnmap(AD5592_TraceView *view);
+
+/**
+ * Set up a transport that answers with the frames of a trace.
+ * Parameters:
+ * 	bus = transport to set up
+ * 	playback = playback state, its view mapped with traceMap()
+ */
+void tracePlaybackInit(AD5592_Transport *bus, AD5592_TracePlayback *playback);
+
+#endif /* SOURCES_AD5592TRACE_H_ */
@@ -0,0 +1,288 @@
+/***********************************************************************
+ * File: AD5592Transport.c
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: SPI transports for the AD5592 device driver
+ * Dependancies:
+ * 		-bcm2835.h v1.20 2015/03/31 04:55:41 (unless AD5592_NO_BCM2835
+ * 			is defined)
+ * 		-linux/spi/spidev.h
+ * 		-AD5592Transport.h
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release. The bcm2835 code is moved here from
+ * 			AD5592RPI.c version 1.1.0.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- Transfers take const frames to send, so frames built at
+ * 			compile time with AD5592Cmd.h can be sent from read only
+ * 			memory.
+ **********************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/spi/spidev.h>
+#ifndef AD5592_NO_BCM2835
+#include <bcm2835.h>
+#endif
+#include "AD5592Transport.h"
+
+/**
+ * Move frames through a transport and count them.
+ * Parameters:
+ * 	bus = transport
+ * 	cs = chip select of the board
+ * 	txBuf[] = frames to send
+ * 	rxBuf[] = frames received
+ * 	frames = number of 16 bit frames
+ * Returns:
+ * 	1 on success, 0 on failure
+ */
+int transportTransfer(AD5592_Transport *bus, uint8_t cs, const char txBuf[],
+	char rxBuf[], int frames)
+{
+	bus->transfers++;
+	bus->frames += frames;
+	return bus->transfer(bus, cs, txBuf, rxBuf, frames);
+}
+
+/**
+ * Release a transport.
+ * Parameters:
+ * 	bus = transport
+ */
+void transportClose(AD5592_Transport *bus)
+{
+	if(bus->close)
+	{
+		bus->close(bus);
+	}
+}
+
+#ifndef AD5592_NO_BCM2835
+static int bcm2835Cs = -1;		/* Chip select currently set in the SPI module */
+
+/**
+ * bcm2835 transfer. The SPI module holds chip select for a whole
+ * transfer so each frame is its own transfer.
+ */
+static int bcm2835Transfer(AD5592_Transport *bus, uint8_t cs, const char txBuf[],
+	char rxBuf[], int frames)
+{
+	int i;
+
+	if(cs != bcm2835Cs)
+	{
+		bcm2835_spi_chipSelect(cs);
+		bcm2835_spi_setChipSelectPolarity(cs, LOW);
+		bcm2835Cs = cs;
+	}
+	for(i = 0; i < frames; i++)
+	{
+		/* bcm2835_spi_transfernb() only reads tbuf but does not say so */
+		bcm2835_spi_transfernb((char *)&txBuf[2 * i], &rxBuf[2 * i], 2);
+	}
+	return 1;
+}
+
+/**
+ * bcm2835 close.
+ */
+static void bcm2835Close(AD5592_Transport *bus)
+{
+	bcm2835_spi_end();
+	bcm2835Cs = -1;
+}
+
+/**
+ * Set up the bcm2835 transport.
+ * Parameters:
+ * 	bus = transport to set up
+ * Returns:
+ * 	1 on success, 0 on failure
+ */
+int bcm2835TransportInit(AD5592_Transport *bus)
+{
+	memset(bus, 0, sizeof(*bus));
+	bus->transfer = bcm2835Transfer;
+	bus->close = bcm2835Close;
+
+	/* Initialize the bcm2835 library */
+	if(!bcm2835_init())
+	{
+		return 0;
+	}
+
+	/* Initialize the SPI module */
+	if(!bcm2835_spi_begin())
+	{
+		return 0;
+	}
+
+	/* Set SPI bit order */
+	bcm2835_spi_setBitOrder(BCM2835_SPI_BIT_ORDER_MSBFIRST);	  // The default
+
+	/* Set SPI polarity and phase */
+	bcm2835_spi_setDataMode(BCM2835_SPI_MODE1);				   // Mode 1
+
+	/* Set SPI clock */
+	bcm2835_spi_setClockDivider(BCM2835_SPI_CLOCK_DIVIDER_16); 	  // 16 = 64ns = 15.625MHz
+
+	bcm2835Cs = -1;
+	return 1;
+}
+#endif
+
+/**
+ * Open /dev/spidevX.Y for a chip select and set it up for the AD5592.
+ */
+static int spidevOpen(AD5592_Spidev *spidev, uint8_t cs)
+{
+	char path[32];
+	uint8_t mode = SPI_MODE_1;
+	uint8_t bits = 8;
+	int fd;
+
+	snprintf(path, sizeof(path), "/dev/spidev%d.%d", spidev->busNumber, cs);
+	fd = open(path, O_RDWR);
+	if(fd < 0)
+	{
+		return -1;
+	}
+	if(ioctl(fd, SPI_IOC_WR_MODE, &mode) < 0 ||
+		ioctl(fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0 ||
+		ioctl(fd, SPI_IOC_WR_MAX_SPEED_HZ, &spidev->speedHz) < 0)
+	{
+		close(fd);
+		return -1;
+	}
+	spidev->fd[cs] = fd;
+	return fd;
+}
+
+/**
+ * spidev transfer. Each frame is one spi_ioc_transfer with cs_change
+ * set so chip select is released before the next frame. cs_change on
+ * the last transfer would hold chip select after the message so it is
+ * left clear there.
+ */
+static int spidevTransfer(AD5592_Transport *bus, uint8_t cs, const char txBuf[],
+	char rxBuf[], int frames)
+{
+	AD5592_Spidev *spidev = bus->context;
+	struct spi_ioc_transfer xfer[AD5592_SPIDEV_MAX_XFERS];
+	int fd;
+	int done = 0;
+	int count;
+	int i;
+
+	if(cs >= AD5592_TRANSPORT_MAX_CS)
+	{
+		return 0;
+	}
+	fd = spidev->fd[cs];
+	if(fd < 0 && (fd = spidevOpen(spidev, cs)) < 0)
+	{
+		return 0;
+	}
+
+	while(done < frames)
+	{
+		count = frames - done;
+		if(count > AD5592_SPIDEV_MAX_XFERS)
+		{
+			count = AD5592_SPIDEV_MAX_XFERS;
+		}
+		memset(xfer, 0, count * sizeof(xfer[0]));
+		for(i = 0; i < count; i++)
+		{
+			xfer[i].tx_buf = (unsigned long)&txBuf[2 * (done + i)];
+			xfer[i].rx_buf = (unsigned long)&rxBuf[2 * (done + i)];
+			xfer[i].len = 2;
+			xfer[i].speed_hz = spidev->speedHz;
+			xfer[i].bits_per_word = 8;
+			xfer[i].cs_change = (i < count - 1);
+		}
+		if(ioctl(fd, SPI_IOC_MESSAGE(count), xfer) < 0)
+		{
+			return 0;
+		}
+		done += count;
+	}
+	return 1;
+}
+
+/**
+ * spidev close.
+ */
+static void spidevClose(AD5592_Transport *bus)
+{
+	AD5592_Spidev *spidev = bus->context;
+	int i;
+
+	for(i = 0; i < AD5592_TRANSPORT_MAX_CS; i++)
+	{
+		if(spidev->fd[i] >= 0)
+		{
+			close(spidev->fd[i]);
+			spidev->fd[i] = -1;
+		}
+	}
+}
+
+/**
+ * Set up a transport on /dev/spidevX.Y.
+ * Parameters:
+ * 	bus = transport to set up
+ * 	spidev = storage for the backend data
+ * 	busNumber = X in /dev/spidevX.Y
+ * 	speedHz = SPI clock
+ * Returns:
+ * 	1 on success, 0 on failure
+ */
+int spidevTransportInit(AD5592_Transport *bus, AD5592_Spidev *spidev,
+	int busNumber, uint32_t speedHz)
+{
+	int i;
+
+	memset(bus, 0, sizeof(*bus));
+	bus->transfer = spidevTransfer;
+	bus->close = spidevClose;
+	bus->context = spidev;
+
+	spidev->busNumber = busNumber;
+	spidev->speedHz = speedHz;
+	for(i = 0; i < AD5592_TRANSPORT_MAX_CS; i++)
+	{
+		spidev->fd[i] = -1;
+	}
+	/* Open CS0 now so a missing device shows up at start up */
+	return spidevOpen(spidev, 0) >= 0;
+}
+
+/**
+ * Loopback transfer.
+ */
+static int loopbackTransfer(AD5592_Transport *bus, uint8_t cs, const char txBuf[],
+	char rxBuf[], int frames)
+{
+	(void)bus;
+	(void)cs;
+	memmove(rxBuf, txBuf, 2 * frames);
+	return 1;
+}
+
+/**
+ * Set up a loopback transport.
+ * Parameters:
+ * 	bus = transport to set up
+ */
+void loopbackTransportInit(AD5592_Transport *bus)
+{
+	memset(bus, 0, sizeof(*bus));
+	bus->transfer = loopbackTransfer;
+}
@@ -0,0 +1,141 @@
+/*********************************************************************
+ * File: AD5592Transport.h
+ * Target: AD5592 on a Raspberry Pi or any Linux host
+ * Function: SPI transports for the AD5592 device driver
+ * Dependancies:
+ * 		-bcm2835.h v1.20 2015/03/31 04:55:41 (unless AD5592_NO_BCM2835
+ * 			is defined)
+ * 		-linux/spi/spidev.h
+ * Author: Tom Olenik
+ * Original Date: 16 October 2026
+ * Last Revised Date: 16 October 2026
+ * Release Notes:
+ * 	* Version 1.0.0: 16 October 2026
+ * 		- Initial release. bcm2835, spidev and loopback transports.
+ * 	* Version 1.0.1: 16 October 2026
+ * 		- Three chip selects, for SPI1 of the Raspberry Pi.
+ * 	* Version 1.0.2: 16 October 2026
+ * 		- transfer() and transportTransfer() take const frames to send.
+ **********************************************************************/
+
+#ifndef SOURCES_AD5592TRANSPORT_H_
+#define SOURCES_AD5592TRANSPORT_H_
+
+#include <stdint.h>
+
+/**
+ * Number of chip selects a transport can address.
+ */
+#define AD5592_TRANSPORT_MAX_CS		3
+
+/**
+ * Most frames the spidev transport puts in one SPI_IOC_MESSAGE. The
+ * kernel caps a message at 4096 bytes by default so larger transfers
+ * are split.
+ */
+#define AD5592_SPIDEV_MAX_XFERS		256
+
+/**
+ * Default SPI clock. 15.625MHz, the same as the bcm2835 divider of 16.
+ */
+#define AD5592_SPI_SPEED_HZ			15625000
+
+typedef struct AD5592_Transport AD5592_Transport;
+
+/**
+ * An SPI bus the driver talks through. Frames are 16 bits, most
+ * significant byte first, and chip select is released between frames.
+ */
+struct AD5592_Transport
+{
+	/**
+	 * Move frames on the bus.
+	 * Parameters:
+	 * 	bus = this transport
+	 * 	cs = chip select of the board
+	 * 	txBuf[] = frames to send
+	 * 	rxBuf[] = frames received
+	 * 	frames = number of 16 bit frames
+	 * Returns:
+	 * 	1 on success, 0 on failure
+	 */
+	int (*transfer)(AD5592_Transport *bus, uint8_t cs, const char txBuf[],
+		char rxBuf[], int frames);
+
+	/**
+	 * Release the bus. May be NULL.
+	 */
+	void (*close)(AD5592_Transport *bus);
+
+	void *context;			/* Backend data */
+	uint32_t transfers;		/* Calls to transfer */
+	uint32_t frames;		/* 16 bit frames moved */
+};
+
+/**
+ * Data for the spidev transport. One file per chip select, opened on
+ * first use.
+ */
+typedef struct
+{
+	int busNumber;							/* X in /dev/spidevX.Y */
+	uint32_t speedHz;						/* SPI clock */
+	int fd[AD5592_TRANSPORT_MAX_CS];		/* Open devices, -1 if closed */
+} AD5592_Spidev;
+
+/**
+ * Move frames through a transport and count them.
+ * Parameters:
+ * 	bus = transport
+ * 	cs = chip select of the board
+ * 	txBuf[] = frames to send
+ * 	rxBuf[] = frames received
+ * 	frames = number of 16 bit frames
+ * Returns:
+ * 	1 on success, 0 on failure
+ */
+int transportTransfer(AD5592_Transport *bus, uint8_t cs, const char txBuf[],
+	char rxBuf[], int frames);
+
+/**
+ * Release a transport.
+ * Parameters:
+ * 	bus = transport
+ */
+void transportClose(AD5592_Transport *bus);
+
+#ifndef AD5592_NO_BCM2835
+/**
+ * Set up the bcm2835 transport. Initializes the bcm2835 library and the
+ * SPI module. Needs root for /dev/mem.
+ * Parameters:
+ * 	bus = transport to set up
+ * Returns:
+ * 	1 on success, 0 on failure
+ */
+int bcm2835TransportInit(AD5592_Transport *bus);
+#endif
+
+/**
+ * Set up a transport on /dev/spidevX.Y. A batch of frames goes to the
+ * kernel as one SPI_IOC_MESSAGE with chip select toggled between frames.
+ * Parameters:
+ * 	bus = transport to set up
+ * 	spidev = storage for the backend data
+ * 	busNumber = X in /dev/spidevX.Y
+ * 	speedHz = SPI clock
+ * Returns:
+ * 	1 on success, 0 on failure
+ */
+int spidevTransportInit(AD5592_Transport *bus, AD5592_Spidev *spidev,
+	int busNumber, uint32_t speedHz);
+
+/**
+ * Set up a loopback transport. Every frame sent is received back as if
+ * MOSI were wired to MISO.
+ * Parameters:
+ * 	bus = transport to set up
+ */
+void loopbackTransportInit(AD5592_Transport *bus);
+
+#endif /* SOURCES_AD5592TRANSPORT_H_ */